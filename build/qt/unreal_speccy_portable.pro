@@ -37,6 +37,7 @@ SOURCES += ../../speccy.cpp \
 	../../3rdparty/minizip/unzip.c \
 	../../snapshot/snapshot.cpp \
 	../../snapshot/snapshot_szx.cpp \
+	../../snapshot/snapshot_pack.cpp \
 	../../snapshot/screenshot.cpp \
 	../../platform/touch_ui/tui_keyboard.cpp \
 	../../platform/touch_ui/tui_joystick.cpp \
@@ -69,7 +70,8 @@ SOURCES += ../../speccy.cpp \
 	../../speccy_handler.cpp \
 	../../file_type.cpp \
 	../../file_type_zip.cpp \
-	../../snapshot/rzx.cpp
+	../../snapshot/rzx.cpp \
+	../../snapshot/rzx_record.cpp
 
 HEADERS  += \
 	../../std_types.h \
@@ -130,7 +132,8 @@ HEADERS  += \
 	../../platform/qt/qt_control.h \
 	../../platform/qt/qt_view.h \
 	../../file_type.h \
-	../../snapshot/rzx.h
+	../../snapshot/rzx.h \
+	../../snapshot/rzx_record.h
 
 RESOURCES += unreal_speccy_portable.qrc
 
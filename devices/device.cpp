@@ -29,10 +29,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 eDevices::eDevices()
 {
 	memset(items, 0, sizeof(items));
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-	memset(items_io_read, 0, sizeof(items_io_read));
-	memset(items_io_write, 0, sizeof(items_io_write));
-#endif
 }
 #ifndef NO_USE_DESTRUCTORS
 //=============================================================================
@@ -42,64 +38,15 @@ eDevices::~eDevices()
 {
 	for(int i = 0; i < D_COUNT; ++i)
 	{
+#ifndef USE_MACHINE_ARENA
 		SAFE_DELETE(items[i]);
-	}
-}
+#else
+		if(items[i])
+			items[i]->~eDevice(); // storage belongs to the machine's arena
 #endif
-//=============================================================================
-//	eDevices::Init
-//-----------------------------------------------------------------------------
-void eDevices::Init()
-{
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-	int io_read_count = 0;
-	for(; items_io_read[io_read_count]; ++io_read_count);
-	int io_write_count = 0;
-	for(; items_io_write[io_write_count]; ++io_write_count);
-	assert(io_read_count <= 8 && io_write_count <= 8); //only 8 devs max supported
-
-	for(int port = 0; port < 0x10000; ++port)
-	{
-		byte devs = 0;
-		for(int d = 0; d < io_read_count; ++d)
-		{
-			if(items_io_read[d]->IoRead(port))
-				devs |= 1 << d;
-		}
-		io_read_map[port] = devs;
-		devs = 0;
-		for(int d = 0; d < io_write_count; ++d)
-		{
-			if(items_io_write[d]->IoWrite(port))
-				devs |= 1 << d;
-		}
-		io_write_map[port] = devs;
-	}
-
-	int size = 1 << io_read_count;
-	for(int i = 0; i < size; ++i)
-	{
-		eDevice** dl = io_read_cache[i];
-		for(int d = 0; d < io_read_count; ++d)
-		{
-			if((byte)i&(1 << d))
-				*dl++ = items_io_read[d];
-		}
-		*dl = NULL;
-	}
-	size = 1 << io_write_count;
-	for(int i = 0; i < size; ++i)
-	{
-		eDevice** dl = io_write_cache[i];
-		for(int d = 0; d < io_write_count; ++d)
-		{
-			if((byte)i&(1 << d))
-				*dl++ = items_io_write[d];
-		}
-		*dl = NULL;
 	}
-#endif
 }
+#endif
 //=============================================================================
 //	eDevices::Reset
 //-----------------------------------------------------------------------------
@@ -148,22 +95,6 @@ void eDevices::_Add(eDeviceId id, eDevice* d)
 	assert(d && !items[id]);
 	d->Init();
 	items[id] = d;
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-	if(d->IoNeed()&eDevice::ION_READ)
-	{
-		eDevice** dl = items_io_read;
-		while(*dl)
-			++dl;
-		*dl = d;
-	}
-	if(d->IoNeed()&eDevice::ION_WRITE)
-	{
-		eDevice** dl = items_io_write;
-		while(*dl)
-			++dl;
-		*dl = d;
-	}
-#endif
 }
 
 #ifdef USE_HACKED_DEVICE_ABSTRACTION
@@ -264,7 +195,8 @@ extern "C" byte static_device_io_read(int port, int tact) {
 		}
 	}
 #endif
-#if !defined(NO_USE_FDD) || !defined(NO_USE_REPLAY)
+// (rzx replay needs nothing here, eZ80::IoRead takes values from the recording before getting to the devices)
+#ifndef NO_USE_FDD
 #error todo
 #endif
 	return v;
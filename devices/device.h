@@ -39,10 +39,9 @@ public:
 	virtual void FrameEnd(dword tacts) {}
 
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	enum eIoNeed { ION_READ = 0x01, ION_WRITE = 0x02 };
-	virtual bool IoRead(word port) const { return false; }
-	virtual bool IoWrite(word port) const { return false; }
-	virtual dword IoNeed() const { return 0; }
+	// port decoding, see eDeviceList
+	bool IoRead(word port) const { return false; }
+	bool IoWrite(word port) const { return false; }
 #endif
 	virtual void IoRead(word port, byte* v, int tact) {}
 	virtual void IoWrite(word port, byte v, int tact) {}
@@ -90,34 +89,19 @@ public:
 	~eDevices();
 #endif
 
-	void Init();
 	void Reset();
 
 	template<class T> void Add(T* d) { _Add(T::Id(), d); }
 	template<class T> T* Get() const { return (T*)_Get(T::Id()); }
 
-	byte IoRead(word port, int tact)
-	{
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-		byte v = 0xff;
-		eDevice** dl = io_read_cache[io_read_map[port]];
-		while(*dl)
-			(*dl++)->IoRead(port, &v, tact);
-		return v;
+	// dispatched by the machine's eDeviceList
+	byte IoRead(word port, int tact);
+	void IoWrite(word port, byte v, int tact);
 #else
-		return static_device_io_read(port, tact);
+	byte IoRead(word port, int tact) { return static_device_io_read(port, tact); }
+	void IoWrite(word port, byte v, int tact) { static_device_io_write(v, port, tact); }
 #endif
-	}
-	void IoWrite(word port, byte v, int tact)
-	{
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-		eDevice** dl = io_write_cache[io_write_map[port]];
-		while(*dl)
-			(*dl++)->IoWrite(port, v, tact);
-#else
-		static_device_io_write(v, port, tact);
-#endif
-	}
 
 	void FrameStart(dword tacts);
 	void FrameUpdate();
@@ -127,14 +111,6 @@ protected:
 	void _Add(eDeviceId id, eDevice* d);
 	eDevice* _Get(eDeviceId id) const { return items[id]; }
 	eDevice* items[D_COUNT];
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-	eDevice* items_io_read[D_COUNT + 1];
-	eDevice* items_io_write[D_COUNT + 1];
-	byte io_read_map[0x10000];
-	byte io_write_map[0x10000];
-	eDevice* io_read_cache[0x100][9];
-	eDevice* io_write_cache[0x100][9];
-#endif
 };
 
 #endif//__DEVICE_H__
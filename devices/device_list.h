@@ -0,0 +1,72 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2010 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef	__DEVICE_LIST_H__
+#define	__DEVICE_LIST_H__
+
+#include "device.h"
+
+#pragma once
+
+#ifndef USE_HACKED_DEVICE_ABSTRACTION
+//*****************************************************************************
+//	eDeviceList
+//-----------------------------------------------------------------------------
+// the devices of a machine model in the order they see an IN/OUT. predicates and handlers are called qualified so
+// nothing goes through the vtable, and the predicates (inline in the device headers) fold into the dispatch.
+// devices that don't decode a direction inherit eDevice's false predicate and drop out entirely
+template<class... D> struct eDeviceList;
+
+template<> struct eDeviceList<>
+{
+	static bool Present(const eDevices& devices) { return true; }
+	static constexpr size_t Size(size_t align) { return 0; }
+	static void IoRead(const eDevices& devices, word port, byte* v, int tact) {}
+	static void IoWrite(const eDevices& devices, word port, byte v, int tact) {}
+};
+
+template<class D, class... Rest> struct eDeviceList<D, Rest...>
+{
+	static bool Present(const eDevices& devices)
+	{
+		return devices.Get<D>() && eDeviceList<Rest...>::Present(devices);
+	}
+	// room for one of each, every one starting on an align boundary
+	static constexpr size_t Size(size_t align)
+	{
+		return ((sizeof(D) + align - 1) & ~(align - 1)) + eDeviceList<Rest...>::Size(align);
+	}
+	static inline void IoRead(const eDevices& devices, word port, byte* v, int tact)
+	{
+		D* d = devices.Get<D>();
+		if(d->D::IoRead(port))
+			d->D::IoRead(port, v, tact);
+		eDeviceList<Rest...>::IoRead(devices, port, v, tact);
+	}
+	static inline void IoWrite(const eDevices& devices, word port, byte v, int tact)
+	{
+		D* d = devices.Get<D>();
+		if(d->D::IoWrite(port))
+			d->D::IoWrite(port, v, tact);
+		eDeviceList<Rest...>::IoWrite(devices, port, v, tact);
+	}
+};
+#endif//USE_HACKED_DEVICE_ABSTRACTION
+
+#endif//__DEVICE_LIST_H__
@@ -36,6 +36,7 @@ void eUdi::eTrack::Write(int pos, byte v, bool marker)
 {
 	if(data)
 	{
+		dirty = true;
 		data[pos] = v;
 		if(marker)
 		{
@@ -104,9 +105,81 @@ bool eUdi::eTrack::WriteSector(int sec, const byte* data)
 	int len = s->Len();
 	memcpy(s->data, data, len);
 	s->UpdateCRC();
+	dirty = true;
 	return true;
 }
 //=============================================================================
+//	eUdi::eTrack::Alloc
+//-----------------------------------------------------------------------------
+void eUdi::eTrack::Alloc(int len)
+{
+	int id_len = len / 8 + ((len & 7) ? 1 : 0);
+	data_len = len;
+	data = new byte[len + id_len];
+	memset(data, 0, len + id_len);
+	id = data + len;
+	sectors_amount = 0;
+	dirty = false;
+}
+//=============================================================================
+//	eUdi::eTrack::Start
+//-----------------------------------------------------------------------------
+int eUdi::eTrack::Start()
+{
+	int pos = 0;
+	WriteBlock(pos, 0x4e, 80);		//gap4a
+	WriteBlock(pos, 0, 12);			//sync
+	WriteBlock(pos, 0xc2, 3, true);	//iam
+	Write(pos++, 0xfc);
+	return pos;
+}
+//=============================================================================
+//	eUdi::eTrack::AddSector
+//-----------------------------------------------------------------------------
+void eUdi::eTrack::AddSector(int& pos, const byte* _id, const byte* _data, bool bad_crc)
+{
+	assert(sectors_amount < MAX_SEC);
+	WriteBlock(pos, 0x4e, 40);		//gap1 50 fixme: recalculate gap1 only for non standard formats
+	WriteBlock(pos, 0, 12);			//sync
+	WriteBlock(pos, 0xa1, 3, true);	//id am
+	Write(pos++, 0xfe);
+	eSector& sec = sectors[sectors_amount++];
+	sec.id = data + pos;
+	for(int i = 0; i < 4; ++i)
+	{
+		Write(pos++, _id[i]);
+	}
+	word crc = eFdd::Crc(data + pos - 5, 5);
+	Write(pos++, crc >> 8);
+	Write(pos++, (byte)crc);
+	if(!_data)
+	{
+		sec.data = NULL;
+		return;
+	}
+	WriteBlock(pos, 0x4e, 22);		//gap2
+	WriteBlock(pos, 0, 12);			//sync
+	WriteBlock(pos, 0xa1, 3, true);	//data am
+	Write(pos++, 0xfb);
+	sec.data = data + pos;
+	int len = sec.Len();
+	memcpy(sec.data, _data, len);
+	crc = eFdd::Crc(data + pos - 1, len + 1);
+	if(bad_crc)
+		crc ^= 0xffff;
+	pos += len;
+	Write(pos++, crc >> 8);
+	Write(pos++, (byte)crc);
+}
+//=============================================================================
+//	eUdi::eTrack::Finish
+//-----------------------------------------------------------------------------
+void eUdi::eTrack::Finish(int pos)
+{
+	assert(pos <= data_len);
+	WriteBlock(pos, 0x4e, data_len - pos - 1); //gap3
+}
+//=============================================================================
 //	eUdi::eTrack::eSector::UpdateCRC
 //-----------------------------------------------------------------------------
 void eUdi::eTrack::eSector::UpdateCRC()
@@ -118,39 +191,67 @@ void eUdi::eTrack::eSector::UpdateCRC()
 //=============================================================================
 //	eUdi::eUdi
 //-----------------------------------------------------------------------------
-eUdi::eUdi(int _cyls, int _sides) : raw(NULL), changed(false)
+eUdi::eUdi(int _cyls, int _sides, eLoader* _loader) : loader(_loader), changed(false)
 {
 	cyls = _cyls; sides = _sides;
-	const int max_track_len = 6400;
-	int data_len = max_track_len;
-	int udi_track_len = data_len + data_len / 8 + ((data_len & 7) ? 1 : 0);
-	int size = cyls * sides * udi_track_len;
-	raw = new byte[size];
-	memset(raw, 0, size);
-	for(int i = 0; i < cyls; ++i)
+}
+//=============================================================================
+//	eUdi::~eUdi
+//-----------------------------------------------------------------------------
+eUdi::~eUdi()
+{
+	for(int i = 0; i < MAX_CYL; ++i)
 	{
-		for(int j = 0; j < sides; ++j)
+		for(int j = 0; j < MAX_SIDE; ++j)
 		{
-			eTrack& t = tracks[i][j];
-			t.data_len = data_len;
-			t.data = raw + udi_track_len * (i * sides + j);
-			t.id = t.data + data_len;
+			SAFE_DELETE_ARRAY(tracks[i][j].data);
 		}
 	}
+	SAFE_DELETE(loader);
+}
+//=============================================================================
+//	eUdi::Load
+//-----------------------------------------------------------------------------
+void eUdi::Load(eTrack& t, int cyl, int side)
+{
+	if(cyl >= cyls || side >= sides) // no track there
+		return;
+	if(loader)
+		loader->Load(t, cyl, side);
+	if(!t.data)
+		t.Alloc(t.data_len);
+	t.dirty = false; // the loader lays the track out with Write(), that isn't a change to write back
 }
 
 //=============================================================================
 //	eFdd::eFdd
 //-----------------------------------------------------------------------------
 eFdd::eFdd() : motor(0), cyl(0), side(0), ts_byte(0), write_protect(false), disk(NULL)
+	, back_file(NULL), back_name(NULL)
+{
+}
+//=============================================================================
+//	eFdd::Close
+//-----------------------------------------------------------------------------
+void eFdd::Close()
 {
+	Flush(); // ejected disk keeps what was written to it
+	if(back_file)
+		fclose(back_file);
+	back_file = NULL;
+	free(back_name);
+	back_name = NULL;
+	SAFE_DELETE(disk);
 }
 //=============================================================================
 //	eFdd::Open
 //-----------------------------------------------------------------------------
 bool eFdd::Open(const char* type, const void* data, size_t data_size)
 {
-	Motor(0);
+	// the image is parsed aside, a bad one leaves the inserted disk where it is (scl seeks while it fills the disk)
+	eUdi* inserted = disk;
+	int head_cyl = cyl, head_side = side, head_ts_byte = ts_byte;
+	disk = NULL;
 	bool ok = false;
 	if(!strcmp(type, "trd"))
 		ok = ReadTrd(data, data_size);
@@ -162,8 +263,29 @@ bool eFdd::Open(const char* type, const void* data, size_t data_size)
 		ok = ReadUdi(data, data_size);
 	else if(!strcmp(type, "td0"))
 		ok = ReadTd0(data, data_size);
-	SAFE_CALL(disk)->Changed(false);
-	return ok;
+	eUdi* opened = disk;
+	disk = inserted;
+	if(!ok)
+	{
+		SAFE_DELETE(opened);
+		cyl = head_cyl; side = head_side; ts_byte = head_ts_byte;
+		return false;
+	}
+	Motor(0);
+	Close();
+	disk = opened;
+	if(disk)
+	{
+		disk->Changed(false);
+		for(int i = 0; i < disk->Cyls(); ++i)
+		{
+			for(int j = 0; j < disk->Sides(); ++j)
+			{
+				disk->Clean(i, j);
+			}
+		}
+	}
+	return true;
 }
 //=============================================================================
 //	eFdd::Store
@@ -188,6 +310,52 @@ bool eFdd::Store(const char* type, FILE* file) const
 	return ok;
 }
 //=============================================================================
+//	eFdd::WriteBack
+//-----------------------------------------------------------------------------
+bool eFdd::WriteBack(const char* type, const char* name)
+{
+	if(!DiskPresent() || strcmp(type, "trd"))
+		return false;
+	Flush();
+	if(back_file)
+		fclose(back_file);
+	free(back_name);
+	back_name = NULL;
+	back_file = fopen(name, "r+b");
+	if(!back_file)
+		return false;
+	back_name = strdup(name);
+	return true;
+}
+//=============================================================================
+//	eFdd::Flush
+//-----------------------------------------------------------------------------
+bool eFdd::Flush()
+{
+	if(!back_file || !disk)
+		return true;
+	bool ok = true;
+	for(int i = 0; i < disk->Cyls(); ++i)
+	{
+		for(int j = 0; j < disk->Sides(); ++j)
+		{
+			if(!disk->Dirty(i, j))
+				continue;
+			const int trd_track_size = 256 * 16;
+			if(fseek(back_file, (i * disk->Sides() + j) * trd_track_size, SEEK_SET) || !WriteTrdTrack(back_file, i, j))
+			{
+				ok = false;
+				continue;
+			}
+			disk->Clean(i, j);
+		}
+	}
+	ok = !fflush(back_file) && ok;
+	if(ok)
+		disk->Changed(false);
+	return ok;
+}
+//=============================================================================
 //	eFdd::Bootable
 //-----------------------------------------------------------------------------
 static const char* boot_sign = "boot    B";
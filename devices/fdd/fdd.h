@@ -26,11 +26,13 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 //*****************************************************************************
 //	eUdi
 //-----------------------------------------------------------------------------
+// tracks get their raw data from the loader of the disk image the first time they are asked for
 class eUdi
 {
 public:
-	eUdi(int cyls, int sides);
-	~eUdi() { SAFE_DELETE_ARRAY(raw); }
+	class eLoader;
+	eUdi(int cyls, int sides, eLoader* loader = NULL);
+	~eUdi();
 	int Cyls() const	{ return cyls; }
 	int Sides() const	{ return sides; }
 	bool Changed() const { return changed; }
@@ -39,11 +41,24 @@ public:
 	enum { MAX_CYL = 86, MAX_SIDE = 2, MAX_SEC = 32 };
 	struct eTrack
 	{
-		eTrack() : data_len(6400), data(NULL), id(NULL), sectors_amount(0) {}
+		eTrack() : data_len(6400), data(NULL), id(NULL), sectors_amount(0), dirty(false) {}
 		bool Marker(int pos) const;
 		void Write(int pos, byte v, bool marker = false);
 		void Update(); //on raw changed
 
+		void Alloc(int len); // blank data_len bytes and their marker bits
+		// standard layout for the loaders: Start(), AddSector() for each sector, Finish()
+		int Start();
+		void AddSector(int& pos, const byte* id, const byte* data, bool bad_crc = false); // no data field if data is NULL
+		void Finish(int pos);
+		void WriteBlock(int& pos, byte v, int amount, bool marker = false)
+		{
+			for(int i = 0; i < amount; ++i)
+			{
+				Write(pos++, v, marker);
+			}
+		}
+
 		int		data_len;
 		byte*	data;
 		byte*	id;
@@ -76,14 +91,33 @@ public:
 		bool	WriteSector(int sec, const byte* data); // write to logical sector
 		eSector	sectors[MAX_SEC];
 		int		sectors_amount;
+		bool	dirty; // written since the last write back
+	};
+	class eLoader
+	{
+	public:
+		virtual ~eLoader() {}
+		virtual void Load(eTrack& t, int cyl, int side) = 0; // leaves t.data NULL for an unformatted track
 	};
-	eTrack& Track(int cyl, int side) { return tracks[cyl][side]; }
+	// only tracks already loaded can be dirty, asking doesn't load them
+	bool Dirty(int cyl, int side) const { return tracks[cyl][side].dirty; }
+	void Clean(int cyl, int side) { tracks[cyl][side].dirty = false; }
+	eTrack& Track(int cyl, int side)
+	{
+		eTrack& t = tracks[cyl][side];
+		if(!t.data)
+			Load(t, cyl, side);
+		return t;
+	}
+
+protected:
+	void Load(eTrack& t, int cyl, int side);
 
 protected:
 	int		cyls;
 	int		sides;
 	eTrack	tracks[MAX_CYL][MAX_SIDE];
-	byte*	raw;
+	eLoader* loader;
 	bool	changed;
 };
 
@@ -94,7 +128,7 @@ class eFdd
 {
 public:
 	eFdd();
-	~eFdd() { SAFE_DELETE(disk); }
+	~eFdd() { Close(); }
 	qword Motor() const { return motor; }
 	void Motor(qword v) { motor = v; }
 	void Seek(int _cyl, int _side);
@@ -108,20 +142,19 @@ public:
 	bool WriteProtect() const	{ return write_protect; }
 	bool Open(const char* type, const void* data, size_t data_size);
 	bool Store(const char* type, FILE* file) const;
+	// the tracks written go back into the image file in place instead of the whole image being stored again.
+	// only flat images (trd) can be patched, the file stays open until the next Open
+	bool WriteBack(const char* type, const char* name);
+	bool WritesBackTo(const char* name) const { return back_name && !strcmp(back_name, name); }
+	bool Flush(); // writes back the dirty tracks
 	bool Bootable() const;
 	bool DiskChanged() const;
 
 	static word Crc(byte* src, int size);
 	
 protected:
-	void WriteBlock(int& pos, byte v, int amount, bool marker = false)
-	{
-		for(int i = 0; i < amount; ++i)
-		{
-			Track().Write(pos++, v, marker);
-		}
-	}
-	void CreateTrd(int max_cyl);
+	void Close();
+	void CreateTrd(int max_cyl, const void* data = NULL, size_t data_size = 0);
 	bool AddFile(const byte* hdr, const byte* data);
 	bool ReadScl(const void* data, size_t data_size);
 	bool ReadTrd(const void* data, size_t data_size);
@@ -131,6 +164,7 @@ protected:
 
 	bool WriteScl(FILE* file) const;
 	bool WriteTrd(FILE* file) const;
+	bool WriteTrdTrack(FILE* file, int cyl, int side) const;
 	bool WriteFdi(FILE* file) const;
 	bool WriteUdi(FILE* file) const;
 	bool WriteTd0(FILE* file) const;
@@ -142,6 +176,8 @@ protected:
 	int		ts_byte; // cpu.t per byte
 	bool	write_protect;
 	eUdi*	disk;
+	FILE*	back_file;
+	char*	back_name;
 };
 
 #endif//__FDD_H__
@@ -20,84 +20,85 @@
 
 #include "fdd.h"
 
-//=============================================================================
-//	eFdd::ReadFdi
+//*****************************************************************************
+//	eFdiLoader
 //-----------------------------------------------------------------------------
-bool eFdd::ReadFdi(const void* _data, size_t data_size)
+// keeps the image and where each track header is in it, sectors are laid out on first access
+class eFdiLoader : public eUdi::eLoader
 {
-	const byte* buf = (const byte*)_data;
-	SAFE_DELETE(disk);
-	disk = new eUdi(buf[4], buf[6]);
-	
-	const byte* trk = buf + 0x0E + Word(buf + 0x0C);
-	const byte* dat = buf + Word(buf + 0x0A);
-	
-	for(int i = 0; i < disk->Cyls(); ++i)
+public:
+	eFdiLoader(const byte* _data, size_t _data_size) : data(new byte[_data_size]), data_size(_data_size)
 	{
-		for(int j = 0; j < disk->Sides(); ++j)
+		memcpy(data, _data, data_size);
+		memset(tracks, 0, sizeof(tracks));
+	}
+	virtual ~eFdiLoader() { SAFE_DELETE_ARRAY(data); }
+	bool Index()
+	{
+		int cyls = data[4], sides = data[6];
+		if(cyls > eUdi::MAX_CYL || sides > eUdi::MAX_SIDE)
+			return false;
+		size_t trk = 0x0E + Word(data + 0x0C);
+		for(int i = 0; i < cyls; ++i)
 		{
-			Seek(i, j);
-			
-			int id_len = Track().data_len / 8 + ((Track().data_len & 7) ? 1 : 0);
-			memset(Track().data, 0, Track().data_len + id_len);
-			
-			int pos = 0;
-			WriteBlock(pos, 0x4e, 80);		//gap4a
-			WriteBlock(pos, 0, 12);			//sync
-			WriteBlock(pos, 0xc2, 3, true);	//iam
-			Write(pos++, 0xfc);
-			
-			const byte* t0 = dat + Dword(trk);
-			int ns = trk[6];
-			Track().sectors_amount = ns;
-			trk += 7;
-			for(int i = 0; i < ns; ++i)
+			for(int j = 0; j < sides; ++j)
 			{
-				WriteBlock(pos, 0x4e, 40);		//gap1 50 fixme: recalculate gap1 only for non standard formats
-				WriteBlock(pos, 0, 12);			//sync
-				WriteBlock(pos, 0xa1, 3, true);	//id am
-				Write(pos++, 0xfe);
-				eUdi::eTrack::eSector& sec = Track().sectors[i];
-				sec.id = Track().data + pos;
-				Write(pos++, trk[0]);
-				Write(pos++, trk[1]);
-				Write(pos++, trk[2]);
-				Write(pos++, trk[3]);
-				word crc = Crc(Track().data + pos - 5, 5);
-				Write(pos++, crc >> 8);
-				Write(pos++, (byte)crc);
-				
-				if(trk[4] & 0x40)
-				{
-					sec.data = NULL;
-				}
-				else
-				{
-					const byte* data = t0 + Word(trk+5);
-					if(data + 128 > buf + data_size)
-						return false;
-					WriteBlock(pos, 0x4e, 22);		//gap2
-					WriteBlock(pos, 0, 12);			//sync
-					WriteBlock(pos, 0xa1, 3, true);	//data am
-					Write(pos++, 0xfb);
-					sec.data = Track().data + pos;
-					int len = sec.Len();
-					memcpy(sec.data, data, len);
-					crc = Crc(Track().data + pos - 1, len + 1);
-					if(!(trk[4] & (1<<(trk[3] & 3))))
-						crc ^= 0xffff;
-					pos += len;
-					Write(pos++, crc >> 8);
-					Write(pos++, (byte)crc);
-				}
-				trk += 7;
+				if(trk + 7 > data_size)
+					return false;
+				tracks[i][j] = trk;
+				int ns = data[trk + 6];
+				if(ns > eUdi::MAX_SEC)
+					return false;
+				trk += 7 + 7 * ns;
 			}
-			assert(pos <= Track().data_len);
-			WriteBlock(pos, 0x4e, Track().data_len - pos - 1); //gap3
 		}
+		return trk <= data_size;
 	}
+	virtual void Load(eUdi::eTrack& t, int cyl, int side)
+	{
+		const byte* trk = data + tracks[cyl][side];
+		const byte* t0 = data + Word(data + 0x0A) + Dword(trk);
+		int ns = trk[6];
+		trk += 7;
+		t.Alloc(t.data_len);
+		int pos = t.Start();
+		for(int i = 0; i < ns; ++i, trk += 7)
+		{
+			const byte* sec_data = NULL;
+			if(!(trk[4] & 0x40))
+			{
+				sec_data = t0 + Word(trk + 5);
+				if(sec_data < data || sec_data + (128 << (trk[3] & 3)) > data + data_size)
+					break;
+			}
+			t.AddSector(pos, trk, sec_data, sec_data && !(trk[4] & (1 << (trk[3] & 3))));
+		}
+		t.Finish(pos);
+	}
+protected:
+	byte*	data;
+	size_t	data_size;
+	size_t	tracks[eUdi::MAX_CYL][eUdi::MAX_SIDE];
+};
+
+//=============================================================================
+//	eFdd::ReadFdi
+//-----------------------------------------------------------------------------
+bool eFdd::ReadFdi(const void* _data, size_t data_size)
+{
+	if(data_size < 0x0E)
+		return false;
+	const byte* buf = (const byte*)_data;
+	eFdiLoader* loader = new eFdiLoader(buf, data_size);
+	if(!loader->Index())
+	{
+		SAFE_DELETE(loader);
+		return false;
+	}
+	SAFE_DELETE(disk);
+	disk = new eUdi(buf[4], buf[6], loader);
 	return true;
-}
+}
 //=============================================================================
 //	eFdd::WriteFdi
 //-----------------------------------------------------------------------------
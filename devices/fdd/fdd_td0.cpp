@@ -44,176 +44,230 @@ struct TTd0Sec
 };
 #pragma pack(pop)
 
-unsigned int unpack_lzh(const unsigned char* in, size_t size, unsigned char* out);
-
-//=============================================================================
-//	eFdd::ReadTd0
+void unpack_lzh_start(const unsigned char* in, size_t size);
+unsigned int unpack_lzh_read(unsigned char* out, unsigned int size);
+
+//*****************************************************************************
+//	eTd0Loader
 //-----------------------------------------------------------------------------
-bool eFdd::ReadTd0(const void* _data, size_t data_size)
-{
-	const byte* buf = (const byte*)_data;
-	if(buf[0] == 't' && buf[1] == 'd')
+// keeps the (unpacked) image and where each track record is in it, sectors are decoded on first access
+class eTd0Loader : public eUdi::eLoader
+{
+public:
+	eTd0Loader(byte* _data, size_t _data_size) : data(_data), data_size(_data_size), cyls(0), sides(0)
 	{
-		// unpack lzh
-		const byte* packed_buf = buf + 12;
-		size_t packed_size = data_size - 12;
-		size_t unpacked_size = 12 + unpack_lzh(packed_buf, packed_size, NULL);
-		byte* unpacked_data = new byte[unpacked_size];
-		memcpy(unpacked_data, buf, 12);
-		unpack_lzh(packed_buf, packed_size, unpacked_data + 12);
-		unpacked_data[0] = 'T';
-		unpacked_data[1] = 'D';
-		bool ok = ReadTd0(unpacked_data, unpacked_size);
-		SAFE_DELETE_ARRAY(unpacked_data);
-		return ok;
+		memset(tracks, 0, sizeof(tracks));
 	}
-
-	const byte* start = buf + 12;
+	virtual ~eTd0Loader() { SAFE_DELETE_ARRAY(data); }
+	bool Index();
+	virtual void Load(eUdi::eTrack& t, int cyl, int side);
+	int Cyls() const { return cyls; }
+	int Sides() const { return sides; }
+protected:
+	bool Unpack(const byte* src, const byte* end, byte* dst, int len) const;
+
+	byte*	data;
+	size_t	data_size;
+	int		cyls;
+	int		sides;
+	size_t	tracks[eUdi::MAX_CYL][eUdi::MAX_SIDE]; // 0 for a track not in the image
+};
+//=============================================================================
+//	eTd0Loader::Index
+//-----------------------------------------------------------------------------
+bool eTd0Loader::Index()
+{
+	if(data_size < 12)
+		return false;
+	const byte* buf = data;
+	const byte* end = buf + data_size;
+	const byte* src = buf + 12;
 	if(buf[7] & 0x80) // coment record
 	{
-		start += 10;
-		start += Word(buf + 14);
+		if(data_size < 16)
+			return false;
+		src += 10;
+		src += Word(buf + 14);
 	}
-	const byte* src = start;
-	
-	byte sides = (buf[9] == 1 ? 1 : 2);
-	byte cyls = 0;
-	
+	sides = (buf[9] == 1 ? 1 : 2);
 	for(;;)
 	{
+		if(src + 4 > end) // sizeof(track_rec)
+			return false;
 		int ns = src[0];
 		if(ns == 0xFF)
 			break;
 		byte cyl = src[1];
+		byte side = src[2];
+		if(cyl >= eUdi::MAX_CYL || side >= sides || ns > eUdi::MAX_SEC)
+			return false;
 		if(cyl >= cyls)
 			cyls = cyl + 1; // PhysTrack
-		src += 4; // sizeof(track_rec)
+		tracks[cyl][side] = src - buf;
+		src += 4;
 		for(; ns; --ns)
 		{
 			src += sizeof(TTd0Sec); // sizeof(sec_rec)
-			assert(src <= buf + data_size);
-			if(src > buf + data_size)
+			if(src + 2 > end)
 				return false;
 			src += Word(src) + 2; // data_len
+			if(src > end)
+				return false;
 		}
 	}
-	if(cyls > eUdi::MAX_CYL)
+	return true;
+}
+//=============================================================================
+//	eTd0Loader::Unpack
+//-----------------------------------------------------------------------------
+bool eTd0Loader::Unpack(const byte* src, const byte* end, byte* dst, int len) const
+{
+	byte* dst_end = dst + len;
+	if(src >= end)
 		return false;
-	
-	SAFE_DELETE(disk);
-	disk = new eUdi(cyls, sides);
-	
-	src = start;
-	for(;;)
+	switch(*src++) // Method
 	{
-		const byte* trkh = src;
-		src += 4; // sizeof(track_rec)
-		
-		if(trkh[0] == 0xFF)
-			break;
-
-		Seek(trkh[1], trkh[2]);
-		int id_len = Track().data_len / 8 + ((Track().data_len & 7) ? 1 : 0);
-		memset(Track().data, 0, Track().data_len + id_len);
-		
-		int pos = 0;
-		WriteBlock(pos, 0x4e, 80);		//gap4a
-		WriteBlock(pos, 0, 12);			//sync
-		WriteBlock(pos, 0xc2, 3, true);	//iam
-		Write(pos++, 0xfc);
-
-		int ns = trkh[0];
-		Track().sectors_amount = ns;
-
-		for(int s = 0; s < ns; ++s)
+	case 0:  // raw sector
+		if(end - src > len)
+			return false;
+		memcpy(dst, src, end - src);
+		break;
+	case 1:  // repeated 2-byte pattern
 		{
-			TTd0Sec* SecHdr = (TTd0Sec*)src;
-			src += sizeof(TTd0Sec); // sizeof(sec_rec)
-			byte flags = SecHdr->flags;
-			if(flags & (TD0_SEC_NO_ID | TD0_SEC_NO_DATA | TD0_SEC_NO_DATA2)) // skip sectors with no data & sectors without headers
+			if(src + 4 > end)
+				return false;
+			word n = Word(src);
+			src += 2;
+			if(n * 2 > len)
+				return false;
+			for(word i = 0; i < n; ++i)
 			{
-				size_t src_size = Word(src);
-				src += 2; // data_len
-				src += src_size;
-				continue;
+				*dst++ = src[0];
+				*dst++ = src[1];
 			}
-			WriteBlock(pos, 0x4e, 40);		//gap1 50 fixme: recalculate gap1 only for non standard formats
-			WriteBlock(pos, 0, 12);			//sync
-			WriteBlock(pos, 0xa1, 3, true);	//id am
-			Write(pos++, 0xfe);
-
-			eUdi::eTrack::eSector& sec = Track().sectors[s];
-			sec.id = Track().data + pos;
-			Write(pos++, SecHdr->c);
-			Write(pos++, SecHdr->h);
-			Write(pos++, SecHdr->s);
-			Write(pos++, SecHdr->n);
-			word crc = Crc(Track().data + pos - 5, 5);
-			Write(pos++, crc >> 8);
-			Write(pos++, (byte)crc);
-			
-			WriteBlock(pos, 0x4e, 22);		//gap2
-			WriteBlock(pos, 0, 12);			//sync
-			WriteBlock(pos, 0xa1, 3, true);	//data am
-			Write(pos++, 0xfb);
-			sec.data = Track().data + pos;
-			byte* dst = sec.data;
-
-			word src_size = Word(src);
-			src += 2; // data_len
-			const byte* end_packed_data = src + src_size;
-			switch(*src++) // Method
+		}
+		break;
+	case 2: // RLE block
+		while(src + 2 <= end)
+		{
+			byte s = src[1];
+			switch(src[0])
 			{
-			case 0:  // raw sector
-				memcpy(dst, src, src_size - 1);
+			case 0: // Zero count means a literal data block
+				src += 2;
+				if(src + s > end || dst + s > dst_end)
+					return false;
+				memcpy(dst, src, s);
+				dst += s;
+				src += s;
 				break;
-			case 1:  // repeated 2-byte pattern
+			case 1:    // repeated fragment
+				src += 2;
+				if(src + 2 > end || dst + s * 2 > dst_end)
+					return false;
+				for(; s; --s)
 				{
-					word n = Word(src);
-					src += 2;
-					for(word i = 0; i < n; ++i)
-					{
-						*dst++ = src[0];
-						*dst++ = src[1];
-					}
+					*dst++ = src[0];
+					*dst++ = src[1];
 				}
+				src += 2;
 				break;
-			case 2: // RLE block
-				do
-				{
-					switch(*src++)
-					{
-					case 0: // Zero count means a literal data block
-						for(byte s = *src++; s; --s)
-							*dst++ = *src++;
-						break;
-					case 1:    // repeated fragment
-						for(byte s = *src++; s; --s)
-						{
-							*dst++ = src[0];
-							*dst++ = src[1];
-						}
-						src += 2;
-						break;
-					default:
-						src = end_packed_data;
-						break;
-					}
-				} while(src < end_packed_data);
+			default:
+				src = end;
 				break;
-			default: // error!
-				return false;
 			}
-			src = end_packed_data;
-			int len = sec.Len();
-			crc = Crc(Track().data + pos - 1, len + 1);
-			pos += len;
-			Write(pos++, crc >> 8);
-			Write(pos++, (byte)crc);
 		}
-		WriteBlock(pos, 0x4e, Track().data_len - pos - 1); //gap3
+		break;
+	default: // error!
+		return false;
 	}
 	return true;
+}
+//=============================================================================
+//	eTd0Loader::Load
+//-----------------------------------------------------------------------------
+void eTd0Loader::Load(eUdi::eTrack& t, int cyl, int side)
+{
+	if(!tracks[cyl][side])
+		return;
+	const byte* trkh = data + tracks[cyl][side];
+	const byte* src = trkh + 4; // sizeof(track_rec)
+	t.Alloc(t.data_len);
+	int pos = t.Start();
+	int ns = trkh[0];
+	for(int s = 0; s < ns; ++s)
+	{
+		const TTd0Sec* SecHdr = (const TTd0Sec*)src;
+		src += sizeof(TTd0Sec); // sizeof(sec_rec)
+		word src_size = Word(src);
+		src += 2; // data_len
+		const byte* end_packed_data = src + src_size;
+		if(!(SecHdr->flags & (TD0_SEC_NO_ID | TD0_SEC_NO_DATA | TD0_SEC_NO_DATA2))) // skip sectors with no data & sectors without headers
+		{
+			byte sec_data[128 << 3];
+			memset(sec_data, 0, sizeof(sec_data));
+			int len = 128 << (SecHdr->n & 3);
+			if(!Unpack(src, end_packed_data, sec_data, len))
+				break;
+			byte id[4] = { SecHdr->c, SecHdr->h, SecHdr->s, SecHdr->n };
+			t.AddSector(pos, id, sec_data);
+		}
+		src = end_packed_data;
+	}
+	t.Finish(pos);
+}
+
+//=============================================================================
+//	eFdd::ReadTd0
+//-----------------------------------------------------------------------------
+bool eFdd::ReadTd0(const void* _data, size_t data_size)
+{
+	if(data_size < 12)
+		return false;
+	const byte* buf = (const byte*)_data;
+	byte* image = NULL;
+	size_t image_size = 0;
+	if(buf[0] == 't' && buf[1] == 'd')
+	{
+		// unpack lzh in one pass into a buffer growing as needed
+		size_t size = data_size * 2 + 12;
+		image = new byte[size];
+		memcpy(image, buf, 12);
+		image_size = 12;
+		unpack_lzh_start(buf + 12, data_size - 12);
+		for(;;)
+		{
+			if(image_size == size)
+			{
+				byte* b = new byte[size * 2];
+				memcpy(b, image, image_size);
+				SAFE_DELETE_ARRAY(image);
+				image = b;
+				size *= 2;
+			}
+			unsigned int n = unpack_lzh_read(image + image_size, size - image_size);
+			if(!n)
+				break;
+			image_size += n;
+		}
+		image[0] = 'T';
+		image[1] = 'D';
+	}
+	else
+	{
+		image = new byte[data_size];
+		memcpy(image, buf, data_size);
+		image_size = data_size;
+	}
+	eTd0Loader* loader = new eTd0Loader(image, image_size);
+	if(!loader->Index())
+	{
+		SAFE_DELETE(loader);
+		return false;
+	}
+	SAFE_DELETE(disk);
+	disk = new eUdi(loader->Cyls(), loader->Sides(), loader);
+	return true;
 }
 
 static const word crcTab[256] =
@@ -281,46 +281,52 @@ int DecodePosition(void)
 	return c | (i & 0x3f);
 }
 
-unsigned int unpack_lzh(const unsigned char* in, size_t size, unsigned char* out)
+/* copy still to be output when the last read stopped inside it */
+unsigned int copy_pos, copy_len, text_r;
+
+void unpack_lzh_start(const unsigned char* in, size_t size)
 {
 	packed_ptr = in;
 	packed_end = in + size;
 
-	unsigned int i, j, k, c, r;
-	unsigned int count = 0;
-
 	StartHuff();
-	for(i = 0; i < N - F; i++)
-		text_buf[i] = ' ';
-	r = N - F;
+	for(int i = 0; i < N - F; i++)
+		text_buf[i] = ' ';
+	text_r = N - F;
+	copy_pos = copy_len = 0;
+}
 
-	//  while (count < textsize)  // textsize - sizeof unpacked data
-	while(packed_ptr < packed_end)
+/* decodes up to size bytes in one pass, returns how many. 0 once the input is over */
+unsigned int unpack_lzh_read(unsigned char* out, unsigned int size)
+{
+	unsigned int c, r = text_r;
+	unsigned int count = 0;
+
+	while(count < size)
 	{
-		c = DecodeChar();
-		if(c < 256)
+		if(copy_len)
 		{
-			if(out)
-				*out++ = c;
-			text_buf[r++] = c;
-			r &= (N - 1);
-			count++;
+			c = text_buf[copy_pos++ & (N - 1)];
+			--copy_len;
 		}
 		else
 		{
-			i = (r - DecodePosition() - 1) & (N - 1);
-			j = c - 255 + THRESHOLD;
-			for(k = 0; k < j; k++)
+			//  while (count < textsize)  // textsize - sizeof unpacked data
+			if(packed_ptr >= packed_end)
+				break;
+			c = DecodeChar();
+			if(c >= 256)
 			{
-				c = text_buf[(i + k) & (N - 1)];
-				if(out)
-					*out++ = c;
-				text_buf[r++] = c;
-				r &= (N - 1);
-				count++;
+				copy_pos = (r - DecodePosition() - 1) & (N - 1);
+				copy_len = c - 255 + THRESHOLD;
+				continue;
 			}
 		}
+		*out++ = c;
+		text_buf[r++] = c;
+		r &= (N - 1);
+		count++;
 	}
+	text_r = r;
 	return count;
 }
-
@@ -20,69 +20,59 @@
 
 #include "fdd.h"
 
-//=============================================================================
-//	eFdd::CreateTrd
+//*****************************************************************************
+//	eTrdLoader
 //-----------------------------------------------------------------------------
-void eFdd::CreateTrd(int max_cyl)
+// formats a track of the standard 16 sector layout from the image sectors behind it
+class eTrdLoader : public eUdi::eLoader
 {
-	SAFE_DELETE(disk);
-	disk = new eUdi(max_cyl, eUdi::MAX_SIDE);
-	for(int i = 0; i < disk->Cyls(); ++i)
+public:
+	eTrdLoader(const void* _data, size_t _data_size) : data(NULL), data_size(_data_size)
 	{
-		for(int j = 0; j < disk->Sides(); ++j)
+		if(data_size)
 		{
-			Seek(i, j);
-			
-			int id_len = Track().data_len / 8 + ((Track().data_len & 7) ? 1 : 0);
-			memset(Track().data, 0, Track().data_len + id_len);
-			
-			int pos = 0;
-			WriteBlock(pos, 0x4e, 80);		//gap4a
-			WriteBlock(pos, 0, 12);			//sync
-			WriteBlock(pos, 0xc2, 3, true);	//iam
-			Write(pos++, 0xfc);
-			
-			const int max_trd_sectors = 16;
-			static const byte lv[3][max_trd_sectors] =
-			{
-				{ 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 },
-				{ 1,9,2,10,3,11,4,12,5,13,6,14,7,15,8,16 },
-				{ 1,12,7,2,13,8,3,14,9,4,15,10,5,16,11,6 }
-			};
-			Track().sectors_amount = max_trd_sectors;
-			for(int i = 0; i < max_trd_sectors; ++i)
-			{
-				WriteBlock(pos, 0x4e, 40);		//gap1 50 fixme: recalculate gap1 only for non standard formats
-				WriteBlock(pos, 0, 12);			//sync
-				WriteBlock(pos, 0xa1, 3, true);	//id am
-				Write(pos++, 0xfe);
-				eUdi::eTrack::eSector& sec = Track().sectors[i];
-				sec.id = Track().data + pos;
-				Write(pos++, cyl);
-				Write(pos++, side);
-				const int trdos_interleave = 1;
-				Write(pos++, lv[trdos_interleave][i]);
-				Write(pos++, 1); //256byte
-				word crc = Crc(Track().data + pos - 5, 5);
-				Write(pos++, crc >> 8);
-				Write(pos++, (byte)crc);
-				
-				WriteBlock(pos, 0x4e, 22);		//gap2
-				WriteBlock(pos, 0, 12);			//sync
-				WriteBlock(pos, 0xa1, 3, true);	//data am
-				Write(pos++, 0xfb);
-				sec.data = Track().data + pos;
-				int len = sec.Len();
-				crc = Crc(Track().data + pos - 1, len + 1);
-				pos += len;
-				Write(pos++, crc >> 8);
-				Write(pos++, (byte)crc);
-			}
-			assert(pos <= Track().data_len);
-			WriteBlock(pos, 0x4e, Track().data_len - pos - 1); //gap3
+			data = new byte[data_size];
+			memcpy(data, _data, data_size);
+		}
+	}
+	virtual ~eTrdLoader() { SAFE_DELETE_ARRAY(data); }
+	virtual void Load(eUdi::eTrack& t, int cyl, int side)
+	{
+		const int max_trd_sectors = 16;
+		static const byte lv[3][max_trd_sectors] =
+		{
+			{ 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16 },
+			{ 1,9,2,10,3,11,4,12,5,13,6,14,7,15,8,16 },
+			{ 1,12,7,2,13,8,3,14,9,4,15,10,5,16,11,6 }
+		};
+		const int trdos_interleave = 1;
+		static const byte zero_sec[256] = { 0 };
+		t.Alloc(t.data_len);
+		int pos = t.Start();
+		for(int i = 0; i < max_trd_sectors; ++i)
+		{
+			byte sec = lv[trdos_interleave][i];
+			byte id[4] = { (byte)cyl, (byte)side, sec, 1 }; //256byte
+			size_t offset = ((cyl * 2 + side) * max_trd_sectors + sec - 1) * 256;
+			t.AddSector(pos, id, offset + 256 <= data_size ? data + offset : zero_sec);
 		}
+		t.Finish(pos);
 	}
+protected:
+	byte*	data;
+	size_t	data_size;
+};
+
+//=============================================================================
+//	eFdd::CreateTrd
+//-----------------------------------------------------------------------------
+void eFdd::CreateTrd(int max_cyl, const void* data, size_t data_size)
+{
+	SAFE_DELETE(disk);
+	disk = new eUdi(max_cyl, eUdi::MAX_SIDE, new eTrdLoader(data, data_size));
 	Seek(0, 0);
+	if(data_size)
+		return;
 	eUdi::eTrack::eSector* s = Track().GetSector(9);
 	if(!s)
 		return;
@@ -102,17 +92,10 @@ bool eFdd::ReadTrd(const void* data, size_t data_size)
 		max_cyl = eUdi::MAX_CYL;
 	if(max_cyl < 80)
 		max_cyl = 80;
-	CreateTrd(max_cyl);
 	size_t max_data_size = max_cyl*256*16*2;
 	if(data_size > max_data_size)
 		data_size = max_data_size;
-	for(size_t i = 0; i < data_size; i += 0x100)
-	{
-		int cyl = i >> 13;
-		int side = (i >> 12) & 1;
-		Seek(cyl, side);
-		Track().WriteSector(((i >> 8) & 0x0f) + 1, (const byte*)data + i);
-	}
+	CreateTrd(max_cyl, data, data_size);
 	return true;
 }
 //=============================================================================
@@ -120,29 +103,38 @@ bool eFdd::ReadTrd(const void* data, size_t data_size)
 //-----------------------------------------------------------------------------
 bool eFdd::WriteTrd(FILE* file) const
 {
-	byte zerosec[256];
-	memset(zerosec, 0, 256);
 	for(int i = 0; i < disk->Cyls(); ++i)
 	{
 		for(int j = 0; j < disk->Sides(); ++j)
 		{
-			const eUdi::eTrack& t = disk->Track(i, j);
-			for(int se = 0; se < 16; ++se)
+			if(!WriteTrdTrack(file, i, j))
+				return false;
+		}
+	}
+	return true;
+}
+//=============================================================================
+//	eFdd::WriteTrdTrack
+//-----------------------------------------------------------------------------
+bool eFdd::WriteTrdTrack(FILE* file, int cyl, int side) const
+{
+	byte zerosec[256];
+	memset(zerosec, 0, 256);
+	const eUdi::eTrack& t = disk->Track(cyl, side);
+	for(int se = 0; se < 16; ++se)
+	{
+		const byte* data = zerosec;
+		for(int k = 0; k < 16; ++k)
+		{
+			const eUdi::eTrack::eSector& s = t.sectors[k];
+			if(s.id && (s.Sec() == se + 1) && s.Len() == 256)
 			{
-				const byte* data = zerosec;
-				for(int k = 0; k < 16; ++k)
-				{
-					const eUdi::eTrack::eSector& s = t.sectors[k];
-					if(s.id && (s.Sec() == se + 1) && s.Len() == 256)
-					{
-						data = s.data;
-						break;
-					}
-				}
-				if(fwrite(data, 1, 256, file) != 256)
-					return false;
+				data = s.data;
+				break;
 			}
 		}
+		if(fwrite(data, 1, 256, file) != 256)
+			return false;
 	}
 	return true;
 }
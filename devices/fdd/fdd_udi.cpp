@@ -20,32 +20,68 @@
 
 #include "fdd.h"
 
+//*****************************************************************************
+//	eUdiLoader
+//-----------------------------------------------------------------------------
+// udi tracks are raw already, they are only copied out of the image when needed
+class eUdiLoader : public eUdi::eLoader
+{
+public:
+	eUdiLoader(const byte* _data, size_t _data_size) : data(new byte[_data_size]), data_size(_data_size)
+	{
+		memcpy(data, _data, data_size);
+		memset(tracks, 0, sizeof(tracks));
+	}
+	virtual ~eUdiLoader() { SAFE_DELETE_ARRAY(data); }
+	bool Index()
+	{
+		int cyls = data[9] + 1, sides = data[10] + 1;
+		if(cyls > eUdi::MAX_CYL || sides > eUdi::MAX_SIDE)
+			return false;
+		size_t ptr = 0x10;
+		for(int i = 0; i < cyls; ++i)
+		{
+			for(int j = 0; j < sides; ++j)
+			{
+				if(ptr + 3 > data_size)
+					return false;
+				tracks[i][j] = ptr;
+				word data_len = Word(data + ptr + 1);
+				ptr += 3 + data_len + data_len / 8 + ((data_len & 7) ? 1 : 0);
+			}
+		}
+		return ptr <= data_size;
+	}
+	virtual void Load(eUdi::eTrack& t, int cyl, int side)
+	{
+		const byte* ptr = data + tracks[cyl][side];
+		word data_len = Word(ptr + 1);
+		t.Alloc(data_len);
+		memcpy(t.data, ptr + 3, data_len + data_len / 8 + ((data_len & 7) ? 1 : 0));
+		t.Update();
+	}
+protected:
+	byte*	data;
+	size_t	data_size;
+	size_t	tracks[eUdi::MAX_CYL][eUdi::MAX_SIDE];
+};
+
 //=============================================================================
 //	eFdd::ReadUdi
 //-----------------------------------------------------------------------------
 bool eFdd::ReadUdi(const void* data, size_t data_size)
 {
+	if(data_size < 0x10)
+		return false;
 	const byte* buf = (const byte*)data;
-	SAFE_DELETE(disk);
-	disk = new eUdi(buf[9] + 1, buf[10] + 1);
-
-	const byte* ptr = buf + 0x10;
-	for(int i = 0; i < disk->Cyls(); ++i)
+	eUdiLoader* loader = new eUdiLoader(buf, data_size);
+	if(!loader->Index())
 	{
-		for(int j = 0; j < disk->Sides(); ++j)
-		{
-			Seek(i, j);
-			eUdi::eTrack& t = Track();
-			byte* dst = t.data;
-			word data_len = Word(ptr + 1);
-			t.data_len = data_len;
-			t.id = t.data + data_len;
-			data_len += data_len / 8 + ((data_len & 7) ? 1 : 0);
-			memcpy(dst, ptr + 3, data_len);
-			ptr += 3 + data_len;
-			t.Update();
-		}
-	}
+		SAFE_DELETE(loader);
+		return false;
+	}
+	SAFE_DELETE(disk);
+	disk = new eUdi(buf[9] + 1, buf[10] + 1, loader);
 	return true;
 }
 
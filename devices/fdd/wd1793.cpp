@@ -25,15 +25,14 @@ const int Z80FQ = 3500000;		// todo: #define as (conf.frame*conf.intfq)
 const int FDD_RPS = 5;			// rotation speed
 const int MAX_PHYS_CYL = 86;	// don't seek over it
 
-const bool wd93_nodelay = false;
-
 //=============================================================================
 //	eWD1793::eWD1793
 //-----------------------------------------------------------------------------
-eWD1793::eWD1793(eSpeccy* _speccy, eRom* _rom) : speccy(_speccy), rom(_rom)
+eWD1793::eWD1793(eSpeccy* _speccy, eRom* _rom) : speccy(_speccy), rom(_rom), nodelay(false)
 	, next(0), tshift(0), state(S_IDLE), state_next(S_IDLE), cmd(0), data(0)
 	, track(0), side(0), sector(0), direction(0), rqs(R_NONE), status(0)
 	, system(0), end_waiting_am(0), found_sec(NULL), rwptr(0), rwlen(0), crc(0), start_crc(-1)
+	, idle_frames(0)
 {
 }
 //=============================================================================
@@ -49,6 +48,8 @@ void eWD1793::Init()
 bool eWD1793::Open(const char* type, int drive, const void* data, size_t data_size)
 {
 	assert(drive >= 0 && drive < FDD_COUNT);
+	if(!fdds[drive].Open(type, data, data_size))
+		return false; // still the disk it had
 	int current_fdd;
 	for(current_fdd = FDD_COUNT; --current_fdd >= 0;)
 	{
@@ -62,7 +63,7 @@ bool eWD1793::Open(const char* type, int drive, const void* data, size_t data_si
 		rqs = R_INTRQ;
 		state = S_IDLE;
 	}
-	return fdds[drive].Open(type, data, data_size);
+	return true;
 }
 //=============================================================================
 //	eWD1793::Store
@@ -73,6 +74,50 @@ bool eWD1793::Store(const char* type, int drive, FILE* file) const
 	return fdds[drive].Store(type, file);
 }
 //=============================================================================
+//	eWD1793::WriteBack
+//-----------------------------------------------------------------------------
+bool eWD1793::WriteBack(const char* type, int drive, const char* name)
+{
+	assert(drive >= 0 && drive < FDD_COUNT);
+	return fdds[drive].WriteBack(type, name);
+}
+//=============================================================================
+//	eWD1793::WritesBackTo
+//-----------------------------------------------------------------------------
+bool eWD1793::WritesBackTo(int drive, const char* name) const
+{
+	assert(drive >= 0 && drive < FDD_COUNT);
+	return fdds[drive].WritesBackTo(name);
+}
+//=============================================================================
+//	eWD1793::Flush
+//-----------------------------------------------------------------------------
+bool eWD1793::Flush(int drive)
+{
+	assert(drive >= 0 && drive < FDD_COUNT);
+	return fdds[drive].Flush();
+}
+//=============================================================================
+//	eWD1793::FrameEnd
+//-----------------------------------------------------------------------------
+void eWD1793::FrameEnd(dword tacts)
+{
+	// a save is a burst of sector writes, wait for it to end rather than patching the file mid way
+	const int flush_idle_frames = 50;
+	if(state != S_IDLE)
+	{
+		idle_frames = 0;
+		return;
+	}
+	if(++idle_frames != flush_idle_frames) // once per idle stretch
+		return;
+	for(int i = 0; i < FDD_COUNT; ++i)
+	{
+		if(fdds[i].DiskChanged())
+			fdds[i].Flush();
+	}
+}
+//=============================================================================
 //	eWD1793::Bootable
 //-----------------------------------------------------------------------------
 bool eWD1793::Bootable(int drive) const
@@ -89,6 +134,67 @@ bool eWD1793::DiskChanged(int drive) const
 	return fdds[drive].DiskChanged();
 }
 //=============================================================================
+//	eWD1793::DiskPresent
+//-----------------------------------------------------------------------------
+bool eWD1793::DiskPresent() const
+{
+	for(int i = 0; i < FDD_COUNT; ++i)
+	{
+		if(fdds[i].DiskPresent())
+			return true;
+	}
+	return false;
+}
+//=============================================================================
+//	eWD1793::FastRead
+//-----------------------------------------------------------------------------
+int eWD1793::FastRead(word addr)
+{
+	if(state != S_READ && !(state == S_WAIT && state_next == S_READ))
+		return -1;
+	eMemory* memory = speccy->Memory();
+	int n = 0;
+	if(rqs & R_DRQ) // byte already waiting in the data register
+	{
+		memory->Write(addr + n++, data);
+		rqs &= ~R_DRQ;
+		status &= ~ST_DRQ;
+	}
+	Load();
+	while(rwlen)
+	{
+		data = fdd->Track().data[rwptr++];
+		crc = Crc(data, crc);
+		memory->Write(addr + n++, data);
+		rwlen--;
+	}
+	// S_READ sees the sector done next time around: checks crc and goes on to the next one or finishes the command
+	return n;
+}
+//=============================================================================
+//	eWD1793::FastWrite
+//-----------------------------------------------------------------------------
+int eWD1793::FastWrite(word addr)
+{
+	if(!(rqs & R_DRQ) || rwlen <= 1 || (state != S_WRITE && !(state == S_WAIT && state_next == S_WRITE)))
+		return -1;
+	eMemory* memory = speccy->Memory();
+	int n = 0;
+	// last byte is left to the port, S_WRITE closes the sector with the crc after it
+	while(rwlen > 1)
+	{
+		data = memory->Read(addr + n++);
+		fdd->Write(rwptr++, data);
+		crc = Crc(data, crc);
+		rwlen--;
+		if(rwptr == fdd->Track().data_len)
+		{
+			rwptr = 0;
+		}
+	}
+	return n;
+}
+//=============================================================================
 //	eWD1793::Crc
 //-----------------------------------------------------------------------------
 const word crc_initial = 0xcdb4;
@@ -159,7 +265,7 @@ void eWD1793::Process(int tact)
 			state = state_next;
 			break;
 		case S_DELAY_BEFORE_CMD:
-			if(!wd93_nodelay && (cmd & CB_DELAY))
+			if(!nodelay && (cmd & CB_DELAY))
 			{
 				next += (Z80FQ*15/1000); // 15ms delay
 			}
@@ -286,7 +392,7 @@ void eWD1793::Process(int tact)
 				rwlen--;
 				rqs = R_DRQ;
 				status |= ST_DRQ;
-				if(!wd93_nodelay)
+				if(!nodelay)
 				{
 					next += fdd->TSByte();
 				}
@@ -357,7 +463,7 @@ void eWD1793::Process(int tact)
 			}
 			if(rwlen)
 			{
-				if(!wd93_nodelay)
+				if(!nodelay)
 				{
 					next += fdd->TSByte();
 				}
@@ -435,7 +541,7 @@ void eWD1793::Process(int tact)
 				rwlen--;
 				if(rwlen > 0)
 				{
-					if(!wd93_nodelay)
+					if(!nodelay)
 					{
 						next += fdd->TSByte();
 					}
@@ -463,7 +569,7 @@ void eWD1793::Process(int tact)
 				if(cmd & 0x40) direction = (cmd & CB_SEEK_DIR) ? -1 : 1;
 				state_next = S_STEP;
 			}
-			if(!wd93_nodelay)
+			if(!nodelay)
 			{
 				next += 1 * Z80FQ / 1000;
 			}
@@ -492,7 +598,7 @@ void eWD1793::Process(int tact)
 				}
 				fdd->Cyl(cyl);
 				static const dword steps[] = { 6, 12, 20, 30 };
-				if(!wd93_nodelay)
+				if(!nodelay)
 				{
 					next += steps[cmd & CB_SEEK_RATE] * Z80FQ / 1000;
 				}
@@ -559,7 +665,7 @@ void eWD1793::ReadFirstByte()
 //-----------------------------------------------------------------------------
 void eWD1793::FindMarker()
 {
-	if(wd93_nodelay && fdd->Cyl() != track)
+	if(nodelay && fdd->Cyl() != track)
 	{
 		fdd->Cyl(track);
 	}
@@ -582,7 +688,7 @@ void eWD1793::FindMarker()
 			}
 		}
 		wait = found_sec ? wait * fdd->TSByte() : 10 * Z80FQ/FDD_RPS;
-		if(wd93_nodelay && found_sec)
+		if(nodelay && found_sec)
 		{
 			// adjust tshift, that id appares right under head
 			dword pos = found_sec->id - fdd->Track().data + 2;
@@ -605,12 +711,12 @@ void eWD1793::FindMarker()
 bool eWD1793::Ready()
 {
 	// fdc is too fast in no-delay mode, wait until cpu handles DRQ, but not more 'end_waiting_am'
-	if(!wd93_nodelay || !(rqs & R_DRQ))
+	if(!nodelay || !(rqs & R_DRQ))
 		return true;
 	if(next > end_waiting_am)
 		return true;
-	state = S_WAIT;
 	state_next = state;
+	state = S_WAIT;
 	next += fdd->TSByte();
 	return false;
 }
@@ -621,7 +727,7 @@ void eWD1793::GetIndex()
 {
 	dword trlen = fdd->Track().data_len * fdd->TSByte();
 	dword ticks = (dword)((next + tshift) % trlen);
-	if(!wd93_nodelay)
+	if(!nodelay)
 	{
 		next += (trlen - ticks);
 	}
@@ -639,26 +745,6 @@ void eWD1793::Load()
 //=============================================================================
 //	eWD1793::IoRead
 //-----------------------------------------------------------------------------
-bool eWD1793::IoRead(word port) const
-{
-	if((port&0x1f) != 0x1f)
-		return false;
-	byte p = (byte)port;
-	return p == 0x1f || p == 0x3f || p == 0x5f || p == 0x7f || p & 0x80;
-}
-//=============================================================================
-//	eWD1793::IoWrite
-//-----------------------------------------------------------------------------
-bool eWD1793::IoWrite(word port) const
-{
-	if((port&0x1f) != 0x1f)
-		return false;
-	byte p = (byte)port;
-	return p == 0x1f || p == 0x3f || p == 0x5f || p == 0x7f || p & 0x80;
-}
-//=============================================================================
-//	eWD1793::IoRead
-//-----------------------------------------------------------------------------
 void eWD1793::IoRead(word port, byte* v, int tact)
 {
 	if(!rom->DosSelected())
@@ -702,6 +788,7 @@ void eWD1793::IoWrite(word port, byte v, int tact)
 		if(status & ST_BUSY)
 			return;
 		cmd = v;
+		idle_frames = 0;
 		next = speccy->T() + tact;
 		status |= ST_BUSY;
 		rqs = R_NONE;
@@ -713,7 +800,7 @@ void eWD1793::IoWrite(word port, byte v, int tact)
 				rqs = R_INTRQ;
 				return;
 			}
-			if(fdd->Motor() || wd93_nodelay) //continue disk spinning
+			if(fdd->Motor() || nodelay) //continue disk spinning
 			{
 				fdd->Motor(next + 2*Z80FQ);
 			}
@@ -744,3 +831,59 @@ void eWD1793::IoWrite(word port, byte v, int tact)
 		}
 	}
 }
+
+#ifndef NO_USE_FAST_TAPE
+namespace xZ80
+{
+
+//*****************************************************************************
+//	eZ80_FastDisk
+//-----------------------------------------------------------------------------
+	class eZ80_FastDisk : public xZ80::eZ80
+	{
+	public:
+		void Step()
+		{
+			const word pc = get_caller_pc();
+			if(pc < 0x3e01 || !rom->DosSelected())
+				return;
+			eWD1793* wd = devices->Get<eWD1793>();
+			if(pc == 0x3e01 && memory->Read(pc) == 0x0d)
+			{ // dec c of the tr-dos delay loop
+				if(wd->NoDelay())
+				{
+					set_caller_a(1);
+					set_caller_bc((get_caller_b() << 8) | 1);
+				}
+				return;
+			}
+			int n = -1;
+			if(pc == 0x3fec && memory->Read(pc) == 0xed && memory->Read(pc + 1) == 0xa2)
+			{ // ini of the sector read loop
+				n = wd->FastRead(get_caller_hl());
+			}
+			else if(pc == 0x3fd1 && memory->Read(pc) == 0xed && memory->Read(pc + 1) == 0xa3)
+			{ // outi of the sector write loop
+				n = wd->FastWrite(get_caller_hl());
+			}
+			if(n < 0)
+				return;
+			set_caller_hl(get_caller_hl() + n);
+			set_caller_b(get_caller_b() - n);
+			set_caller_pc(pc + 2);
+		}
+	};
+
+}
+//namespace xZ80
+
+static class eFastDiskEmul : public xZ80::eZ80::eHandlerStep
+{
+	virtual void Z80_Step(xZ80::eZ80* z80)
+	{
+		((xZ80::eZ80_FastDisk*)z80)->Step();
+	}
+} fde;
+
+xZ80::eZ80::eHandlerStep* fast_disk_emul = &fde;
+#endif
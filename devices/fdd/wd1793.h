@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #define	__WD1793_H__
 
 #include "../device.h"
+#include "../../z80/z80.h"
 #include "fdd.h"
 
 #pragma once
@@ -35,18 +36,38 @@ class eWD1793 : public eDevice
 public:
 	eWD1793(eSpeccy* _speccy, eRom* _rom);
 	virtual void Init();
-	virtual bool IoRead(word port) const;
-	virtual bool IoWrite(word port) const;
+	bool IoRead(word port) const { return IoPort(port); }
+	bool IoWrite(word port) const { return IoPort(port); }
 	virtual void IoRead(word port, byte* v, int tact);
 	virtual void IoWrite(word port, byte v, int tact);
+	virtual void FrameEnd(dword tacts);
 	bool Open(const char* type, int drive, const void* data, size_t data_size);
 	bool Store(const char* type, int drive, FILE* file) const;
+	// written sectors go back to the image file once the controller has been idle for a while, see eFdd::WriteBack
+	bool WriteBack(const char* type, int drive, const char* name);
+	bool WritesBackTo(int drive, const char* name) const;
+	bool Flush(int drive);
 	bool Bootable(int drive) const;
 	bool DiskChanged(int drive) const;
+	bool DiskPresent() const; // in any drive
+
+	// commands complete without rotation, seek and head load delays
+	void NoDelay(bool on) { nodelay = on; }
+	bool NoDelay() const { return nodelay; }
+	// whole sector transfers for the tr-dos data loops: moves what is left of the sector being read/written between
+	// the track and memory at addr, returns the byte count or -1 with no transfer in progress
+	int FastRead(word addr);
+	int FastWrite(word addr);
 
 	static eDeviceId Id() { return D_WD1793; }
-	virtual dword IoNeed() const { return ION_WRITE|ION_READ; }
 protected:
+	static bool IoPort(word port)
+	{
+		if((port&0x1f) != 0x1f)
+			return false;
+		byte p = (byte)port;
+		return p == 0x1f || p == 0x3f || p == 0x5f || p == 0x7f || p & 0x80;
+	}
 	void	Process(int tact);
 	void	ReadFirstByte();
 	void	FindMarker();
@@ -97,6 +118,7 @@ protected:
 protected:
 	eSpeccy* speccy;
 	eRom*	rom;
+	bool	nodelay;
 
 	qword	next;
 	int		tshift;
@@ -122,9 +144,15 @@ protected:
 	word	crc;
 	int		start_crc;
 
+	int		idle_frames;		// since the last command, for the write back
+
 	enum { FDD_COUNT = 4 };
 	eFdd*	fdd;
 	eFdd	fdds[FDD_COUNT];
 };
 
+#ifndef NO_USE_FAST_TAPE
+extern xZ80::eZ80::eHandlerStep* fast_disk_emul;
+#endif
+
 #endif//__WD1793_H__
@@ -24,21 +24,6 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 void eKempstonJoy::Init() { Reset(); }
 void eKempstonJoy::Reset() { state = 0; }
 
-#ifndef USE_MU
-//=============================================================================
-//	eKempstonJoy::IoRead
-//-----------------------------------------------------------------------------
-bool eKempstonJoy::IoRead(word port) const
-{
-	if(port&0x20)
-		return false;
-	// skip kempston mouse ports
-	port |= 0xfa00; // A13,A15 not used in decoding
-	if((port == 0xfadf || port == 0xfbdf || port == 0xffdf))
-		return false;
-	return true;
-}
-#endif
 //=============================================================================
 //	eKempstonJoy::IoRead
 //-----------------------------------------------------------------------------
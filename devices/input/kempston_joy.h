@@ -35,23 +35,24 @@ class eKempstonJoy : public eDevice
 public:
 	virtual void Init();
 	virtual void Reset();
-#ifndef USE_MU
-	virtual bool IoRead(word port) const;
-#endif
+	bool IoRead(word port) const
+	{
+		if(port&0x20)
+			return false;
+		// skip kempston mouse ports
+		port |= 0xfa00; // A13,A15 not used in decoding
+		return port != 0xfadf && port != 0xfbdf && port != 0xffdf;
+	}
 	virtual void IoRead(word port, byte* v, int tact);
 
 #ifndef USE_MU
 	void OnKey(char key, bool down);
-#else
+#endif
 	inline void setState(byte _state) {
 	    state = _state;
 	}
-#endif
 	static eDeviceId Id() { return D_KEMPSTON_JOY; }
 
-#ifndef USE_MU
-	virtual dword IoNeed() const { return ION_READ; }
-#endif
 protected:
 #ifndef USE_MU
 	void KeyState(char key, bool down);
@@ -32,18 +32,6 @@ void eKempstonMouse::Reset()
 //=============================================================================
 //	eKempstonMouse::IoRead
 //-----------------------------------------------------------------------------
-bool eKempstonMouse::IoRead(word port) const
-{
-	if(port&0x20)
-		return false;
-	port |= 0xfa00; // A13,A15 not used in decoding
-	if(port != 0xfadf && port != 0xfbdf && port != 0xffdf)
-		return false;
-	return true;
-}
-//=============================================================================
-//	eKempstonMouse::IoRead
-//-----------------------------------------------------------------------------
 void eKempstonMouse::IoRead(word port, byte* v, int tact)
 {
     port |= 0xfa00; // A13,A15 not used in decoding
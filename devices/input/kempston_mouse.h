@@ -28,13 +28,18 @@ class eKempstonMouse : public eDevice
 public:
 	virtual void Init();
 	virtual void Reset();
-	virtual bool IoRead(word port) const;
+	bool IoRead(word port) const
+	{
+		if(port&0x20)
+			return false;
+		port |= 0xfa00; // A13,A15 not used in decoding
+		return port == 0xfadf || port == 0xfbdf || port == 0xffdf;
+	}
 	virtual void IoRead(word port, byte* v, int tact);
 	void OnMouseMove(byte dx, byte dy);
 	void OnMouseButton(byte index, bool state);
 
 	static eDeviceId Id() { return D_KEMPSTON_MOUSE; }
-	virtual dword IoNeed() const { return ION_READ; }
 protected:
 	byte x, y, buttons;
 };
@@ -34,15 +34,6 @@ void eKeyboard::Reset()
 {
 	memset(kbd, 0xff, sizeof(kbd));
 }
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-//=============================================================================
-//	eKeyboard::IoRead
-//-----------------------------------------------------------------------------
-bool eKeyboard::IoRead(word port) const
-{
-	return !(port&1);
-}
-#endif
 //=============================================================================
 //	eKeyboard::IoRead
 //-----------------------------------------------------------------------------
@@ -31,11 +31,12 @@ public:
 	virtual void Reset();
 	virtual void IoRead(word port, byte* v, int tact) final;
 	void OnKey(char key, bool down, bool shift, bool ctrl, bool alt);
+	// the whole matrix at once, a bit set for each key held, half rows and bits in port order
+	void Matrix(const byte rows[8]) { for(int i = 0; i < 8; ++i) kbd[i] = ~rows[i]; }
 
 	static eDeviceId Id() { return D_KEYBOARD; }
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-    virtual bool IoRead(word port) const final;
-	virtual dword IoNeed() const { return ION_READ; }
+	bool IoRead(word port) const { return !(port&1); }
 #endif
 protected:
 	void KeyState(char key, bool down);
@@ -91,15 +91,6 @@ bool eTape::Inserted() const
 #endif
 	return tape_instance != NULL;
 }
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-//=============================================================================
-//	eTape::IoRead
-//-----------------------------------------------------------------------------
-bool eTape::IoRead(word port) const
-{
-	return !(port&1);
-}
-#endif
 //=============================================================================
 //	eTape::IoRead
 //-----------------------------------------------------------------------------
@@ -172,7 +163,8 @@ void eTape::StopTape()
 	tape.playing = false;
 	tape.tape_bit =  0xff;
 #ifndef NO_USE_FAST_TAPE
-	speccy->CPU()->HandlerStep(NULL);
+	if(speccy->CPU()->HandlerStep() == fast_tape_emul) // the fast disk trap is the handler's to put back
+		speccy->CPU()->HandlerStep(NULL);
 #endif
 }
 //=============================================================================
@@ -187,8 +179,12 @@ void eTape::ResetTape()
 #endif
 	tape.tape_bit = 0xff;
 	tape.edge_change = 0x7FFFFFFFFFFFFFFFLL;
+#ifndef NO_USE_TAPE_INDEX
+	tape.position = 0;
+#endif
 #ifndef NO_USE_FAST_TAPE
-	speccy->CPU()->HandlerStep(NULL);
+	if(speccy->CPU()->HandlerStep() == fast_tape_emul) // the fast disk trap is the handler's to put back
+		speccy->CPU()->HandlerStep(NULL);
 #endif
 	if (tape_instance) {
 		pulse_iterator = tape_instance->reset();
@@ -238,6 +234,10 @@ void eTape::CloseTape()
 	pulse_iterator = NULL;
 	delete tape_instance;
 	tape_instance = NULL;
+#ifndef NO_USE_TAPE_INDEX
+	index.Clear();
+	tape.position = 0;
+#endif
 }
 
 #ifdef USE_LEGACY_TAPE_COMPARISON
@@ -329,17 +329,167 @@ void eTape::AllocInfocell()
 #ifdef USE_STREAM
 bool eTape::Open(const char* type, struct stream *stream)
 {
+	bool ok = false;
 	if(!strcmp(type, "tap"))
-		return OpenTAP(stream);
+		ok = OpenTAP(stream);
 #ifndef NO_USE_CSW
 	else if(!strcmp(type, "csw"))
-		return ParseCSW(stream);
+		ok = ParseCSW(stream);
 #endif
 #ifndef NO_USE_TZX
 	else if(!strcmp(type, "tzx"))
-		return ParseTZX(stream);
+		ok = ParseTZX(stream);
+#endif
+#ifndef NO_USE_TAPE_INDEX
+	if(ok && !tape_instance->build_index(&index))
+	{
+		CloseTape();
+		ok = false;
+	}
 #endif
-	return false;
+	return ok;
+}
+#endif
+#ifndef NO_USE_TAPE_INDEX
+//=============================================================================
+//	eTape::SeekBlock
+//-----------------------------------------------------------------------------
+bool eTape::SeekBlock(int b)
+{
+	const eTapeBlockInfo* info = index.Block(b);
+	if(!info || !tape_instance)
+		return false;
+	bool playing = tape.playing;
+	pulse_iterator = tape_instance->seek(info);
+	tape.position = info->t_start;
+	tape.tape_bit = 0xff;
+	tape.edge_change = 0x7FFFFFFFFFFFFFFFLL;
+	tape.playing = false;
+	if(playing)
+		StartTape();
+	return true;
+}
+//=============================================================================
+//	eTape::SeekT
+//-----------------------------------------------------------------------------
+bool eTape::SeekT(qword t)
+{
+	if(!SeekBlock(index.FindBlock(t)))
+		return false;
+	// only the pulses of a single block are skipped here
+	dword skipped = 0;
+	while(tape.position < t)
+	{
+		int32_t pulse = pulse_iterator->next_pulse_length();
+		if(pulse == -1)
+			break;
+		tape.position += pulse;
+		++skipped;
+	}
+	if(skipped & 1)
+		tape.tape_bit ^= 0xff;
+	return true;
+}
+//=============================================================================
+//	eTapeIndex::Clear
+//-----------------------------------------------------------------------------
+void eTapeIndex::Clear()
+{
+	free(blocks);
+	blocks = NULL;
+	count = capacity = 0;
+}
+//=============================================================================
+//	eTapeIndex::Add
+//-----------------------------------------------------------------------------
+eTapeBlockInfo* eTapeIndex::Add(dword offset)
+{
+	if(count == capacity)
+	{
+		capacity = capacity ? capacity * 2 : 16;
+		blocks = (eTapeBlockInfo*)realloc(blocks, capacity * sizeof(eTapeBlockInfo));
+	}
+	eTapeBlockInfo* b = &blocks[count];
+	memset(b, 0, sizeof(*b));
+	b->offset = offset;
+	b->t_start = TSize();
+	++count;
+	return b;
+}
+//=============================================================================
+//	eTapeIndex::FindBlock
+//-----------------------------------------------------------------------------
+int eTapeIndex::FindBlock(qword t) const
+{
+	// last block starting at or before t
+	int lo = 0, hi = count - 1, found = count ? 0 : -1;
+	while(lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		if(blocks[mid].t_start <= t)
+		{
+			found = mid;
+			lo = mid + 1;
+		}
+		else
+			hi = mid - 1;
+	}
+	return found;
+}
+//=============================================================================
+//	eTapeInstanceTAP::build_index
+//-----------------------------------------------------------------------------
+bool eTapeInstanceTAP::build_index(eTapeIndex *index)
+{
+	index->Clear();
+	stream_reset(stream);
+	dword offset = 0;
+	bool ok = true;
+	for(;;)
+	{
+		const uint8_t *size_ptr = stream_peek(stream, 2);
+		if(!size_ptr)
+			break;
+		dword size = Word(size_ptr);
+		if(!size)
+			break;
+		stream_skip(stream, 2);
+		eTapeBlockInfo* b = index->Add(offset);
+		byte data[eTapeBlockPulseIterator::CACHE_SIZE];
+		dword ones = 0;
+		for(dword pos = 0; pos < size;)
+		{
+			dword len = MIN(size - pos, sizeof(data));
+			if(stream_read(stream, data, len, false) != (int32_t)len)
+			{
+				ok = false;
+				break;
+			}
+			if(!pos)
+			{
+				b->type = data[0];
+				if(!data[0] && size == 19)
+				{
+					memcpy(b->name, data + 2, 10);
+					for(int i = 9; i >= 0 && b->name[i] == ' '; --i)
+						b->name[i] = 0;
+				}
+			}
+			for(dword i = 0; i < len; ++i)
+				ones += __builtin_popcount(data[i]);
+			pos += len;
+		}
+		if(!ok)
+			break;
+		dword pilot_len = (b->type < 4) ? PILOT_LEN_HEADER : PILOT_LEN_DATA;
+		dword zeros = size * 8 - ones;
+		b->pulses = pilot_len + 2 + size * 16 + 1;
+		b->t_size = (qword)pilot_len * PILOT_T + S1_T + S2_T + (qword)ones * 2 * ONE_T
+				+ (qword)zeros * 2 * ZERO_T + (qword)PAUSE * 3500;
+		offset += 2 + size;
+	}
+	stream_reset(stream);
+	return ok;
 }
 #endif
 //=============================================================================
@@ -765,12 +915,24 @@ dword eTape::NextPulseOrStop()
 	{
 		StopTape();
 	}
+#ifndef NO_USE_TAPE_INDEX
+	else
+	{
+		tape.position += pulse;
+	}
+#endif
 	return pulse;
 }
 
 void eTape::SkipPulse() {
 	assert(pulse_iterator);
-	pulse_iterator->next_pulse_length();
+	int32_t pulse = pulse_iterator->next_pulse_length();
+#ifndef NO_USE_TAPE_INDEX
+	if (pulse != -1)
+		tape.position += pulse;
+#else
+	(void)pulse;
+#endif
 #ifdef USE_LEGACY_TAPE_COMPARISON
 	tape.play_pointer++;
 #endif
@@ -1085,4 +1247,4 @@ static class eFastTapeEmul : public xZ80::eZ80::eHandlerStep
 
 xZ80::eZ80::eHandlerStep* fast_tape_emul = &fte;
 #endif
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
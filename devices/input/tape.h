@@ -32,6 +32,42 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 class eSpeccy;
 namespace xZ80 { class eZ80_FastTape; }
 
+#ifndef NO_USE_TAPE_INDEX
+//*****************************************************************************
+//	eTapeBlockInfo
+//-----------------------------------------------------------------------------
+struct eTapeBlockInfo
+{
+	dword offset;	// stream offset of the start of the block
+	dword pulses;	// number of pulses (including pilot, sync & pause)
+	qword t_start;	// t-states from start of tape to start of block
+	qword t_size;	// t-states for the whole block
+	byte type;		// flag byte (0x00 header, 0xff data)
+	char name[11];	// program/bytes name for header blocks, otherwise empty
+};
+
+//*****************************************************************************
+//	eTapeIndex
+//-----------------------------------------------------------------------------
+class eTapeIndex
+{
+public:
+	eTapeIndex() : blocks(NULL), count(0), capacity(0) {}
+	~eTapeIndex() { Clear(); }
+
+	void Clear();
+	eTapeBlockInfo* Add(dword offset);
+	int Count() const { return count; }
+	const eTapeBlockInfo* Block(int i) const { return (i >= 0 && i < count) ? &blocks[i] : NULL; }
+	qword TSize() const { return count ? blocks[count - 1].t_start + blocks[count - 1].t_size : 0; }
+	int FindBlock(qword t) const;
+protected:
+	eTapeBlockInfo* blocks;
+	int count;
+	int capacity;
+};
+#endif
+
 class eTapePulseIterator {
 public:
 	// return -1 for none
@@ -179,6 +215,12 @@ public:
 
 	// start at beginning of tape (note the instance owns the iterator)
 	virtual eTapePulseIterator *reset() = 0;
+#ifndef NO_USE_TAPE_INDEX
+	// walk the whole tape once recording block offsets/timings (leaves the stream reset)
+	virtual bool build_index(eTapeIndex *index) = 0;
+	// position at the start of an indexed block (note the instance owns the iterator)
+	virtual eTapePulseIterator *seek(const eTapeBlockInfo *block) = 0;
+#endif
 	virtual ~eTapeInstance() {
 		stream_close(stream);
 	}
@@ -195,7 +237,21 @@ public:
 		block_pulse_iterator.set_needs_reset();
 		return this;
 	}
+#ifndef NO_USE_TAPE_INDEX
+	bool build_index(eTapeIndex *index) override;
+	eTapePulseIterator *seek(const eTapeBlockInfo *block) override {
+		stream_reset(stream);
+		stream_skip(stream, block->offset);
+		done = false;
+		block_pulse_iterator.set_needs_reset();
+		return this;
+	}
+#endif
 protected:
+	// standard ROM loader timings
+	enum { PILOT_T = 2168, S1_T = 667, S2_T = 735, ZERO_T = 855, ONE_T = 1710,
+		PILOT_LEN_HEADER = 8064, PILOT_LEN_DATA = 3220, PAUSE = 1000 };
+
 	eTapeBlockPulseIterator block_pulse_iterator;
 	bool done;
 
@@ -222,8 +278,8 @@ protected:
 				stream_skip(stream, 2);
 				const uint8_t *ptr = stream_peek(stream, 1);
 				// this should read the full contents of the block
-				block_pulse_iterator.reset(stream, size, 2168, 667, 735, 855, 1710, (*ptr < 4) ? 8064 : 3220,
-										   1000);
+				block_pulse_iterator.reset(stream, size, PILOT_T, S1_T, S2_T, ZERO_T, ONE_T,
+										   (*ptr < 4) ? PILOT_LEN_HEADER : PILOT_LEN_DATA, PAUSE);
 			} else {
 				done = true;
 			}
@@ -246,8 +302,7 @@ public:
 	virtual void Reset();
 
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoRead(word port) const final;
-	virtual dword IoNeed() const { return ION_READ; }
+	bool IoRead(word port) const { return !(port&1); }
 #endif
 	virtual void IoRead(word port, byte* v, int tact) final;
 
@@ -264,6 +319,15 @@ public:
 	void Rewind() { ResetTape(); }
 	bool Started() const;
 	bool Inserted() const;
+#ifndef NO_USE_TAPE_INDEX
+	const eTapeIndex& Index() const { return index; }
+	// t-states of tape played since the start of the tape
+	qword Position() const { return tape.position; }
+	int Block() const { return index.FindBlock(tape.position); }
+	bool SeekBlock(int block);
+	// seek to the start of the pulse in progress at t-state offset t from the start of the tape
+	bool SeekT(qword t);
+#endif
 
 	static eDeviceId Id() { return D_TAPE; }
 
@@ -304,6 +368,9 @@ protected:
 
 	eTapeInstance *tape_instance;
 	eTapePulseIterator *pulse_iterator;
+#ifndef NO_USE_TAPE_INDEX
+	eTapeIndex index;
+#endif
 
 	struct eTapeState
 	{
@@ -312,6 +379,9 @@ protected:
 		byte* play_pointer; // or NULL if tape stopped
 		byte* end_of_tape;  // where to stop tape
 		dword index;    // current tape block
+#endif
+#ifndef NO_USE_TAPE_INDEX
+		qword position;
 #endif
 		byte tape_bit;
 		bool playing;
@@ -19,8 +19,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "../std.h"
 #include "../platform/io.h"
+#include "../tools/profiler.h"
 #include "memory.h"
 
+PROFILER_DECLARE(boot_rom);
+
 #ifdef USE_EMBEDDED_RESOURCES
 #ifndef NO_USE_128K
 #include "res/rom/sos128_0.h"
@@ -63,10 +66,16 @@ extern byte dos513f[];
 //=============================================================================
 //	eMemory::eMemory
 //-----------------------------------------------------------------------------
+#ifndef USE_MACHINE_ARENA
 eMemory::eMemory() : memory(NULL)
+#else
+eMemory::eMemory(byte* pages) : memory(pages)
+#endif
 {
 #ifndef USE_SINGLE_64K_MEMORY
+#ifndef USE_MACHINE_ARENA
 	memory = new byte[SIZE];
+#endif
 	memset(memory, 0, SIZE);
 #else
 #ifdef USE_COMPRESSED_ROM
@@ -84,7 +93,7 @@ eMemory::eMemory() : memory(NULL)
 #ifndef NO_USE_DESTRUCTORS
 eMemory::~eMemory()
 {
-#ifndef USE_SINGLE_64K_MEMORY
+#if !defined(USE_SINGLE_64K_MEMORY) && !defined(USE_MACHINE_ARENA)
 	SAFE_DELETE_ARRAY(memory);
 #endif
 }
@@ -112,7 +121,7 @@ void eMemory::SetPage(int idx, int page)
 int	eMemory::Page(int idx)
 {
 #ifdef USE_BANKED_MEMORY_ACCESS
-	byte* addr = bank_read[idx];
+	byte* addr = bank_read[idx] + 0x4000 * idx; // see SetPage
 	for(int p = 0; p < P_AMOUNT; ++p)
 	{
 		if(Get(p) == addr)
@@ -135,11 +144,26 @@ void eRom::LoadRom(int page, const char* rom)
 	panic("Warning should not be loading ROM for 64K\n");
 #endif
 #if !defined(USE_COMPRESSED_ROM) && !defined(USE_EMBEDDED_RESOURCES) && !defined(USE_EXTERN_RESOURCES) && !defined(USE_EMBEDDED_FILES)
-	FILE* f = fopen(rom, "rb");
-	assert(f);
-	size_t s = fread(memory->Get(page), 1, eMemory::PAGE_SIZE, f);
-	assert(s == eMemory::PAGE_SIZE);
-	fclose(f);
+	// rom files are read once per process, every later machine copies them (boot is otherwise a few fopens)
+	struct eCached
+	{
+		char name[xIo::MAX_PATH_LEN];
+		byte data[eMemory::PAGE_SIZE];
+	};
+	static eCached* cache[eMemory::P_AMOUNT] = { NULL };
+	eCached*& c = cache[page];
+	if(!c || strcmp(c->name, rom))
+	{
+		if(!c)
+			c = new eCached;
+		FILE* f = fopen(rom, "rb");
+		assert(f);
+		size_t s = fread(c->data, 1, eMemory::PAGE_SIZE, f);
+		assert(s == eMemory::PAGE_SIZE);
+		fclose(f);
+		strcpy(c->name, rom);
+	}
+	memcpy(memory->Get(page), c->data, eMemory::PAGE_SIZE);
 #else
 	assert(false);
 #endif
@@ -152,6 +176,7 @@ static void decompress_rom_to_memory(uint8_t *dest, const char *name)
 		if (!strcmp(name, embedded_roms[i].name)) {
 			struct stream *memory_stream = xip_stream_open(embedded_roms[i].data_z, embedded_roms[i].data_z_size, 1024, 10);
 			struct stream *compressed_stream = compressed_stream_open(memory_stream, embedded_roms[i].data_size);
+			assert(compressed_stream);
 			stream_read(compressed_stream, dest, embedded_roms[i].data_size, true);
 			stream_close(compressed_stream); // closes memory stream too.
 			return;
@@ -165,6 +190,7 @@ static void decompress_rom_to_memory(uint8_t *dest, const char *name)
 //-----------------------------------------------------------------------------
 void eRom::Init()
 {
+	PROFILER_SECTION(boot_rom);
 #ifdef USE_COMPRESSED_ROM
 #ifndef USE_OVERLAPPED_ROMS
 	// todo fix the inherited ugly overloading of enums
@@ -250,22 +276,6 @@ void eRom::init_rom_contents(eMemory::ePage memory_page, ePage rom_page) {
 }
 #endif
 #ifndef NO_USE_128K
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-//=============================================================================
-//	eRom::IoWrite
-//-----------------------------------------------------------------------------
-bool eRom::IoWrite(word port) const
-{
-	return !mode_48k && !(port & 2) && !(port & 0x8000); // zx128 port
-}
-//=============================================================================
-//	eRam::IoWrite
-//-----------------------------------------------------------------------------
-bool eRam::IoWrite(word port) const
-{
-	return !mode_48k && !(port & 2) && !(port & 0x8000); // zx128 port
-}
-#endif
 //=============================================================================
 //	eRom::IoWrite
 //-----------------------------------------------------------------------------
@@ -275,15 +285,20 @@ void eRom::IoWrite(word port, byte v, int tact)
 }
 #endif
 
-#ifdef USE_BANKED_MEMORY_ACCESS
+#if defined(USE_BANKED_MEMORY_ACCESS) || !defined(NO_USE_128K)
 //=============================================================================
 //	eRam::Reset
 //-----------------------------------------------------------------------------
 void eRam::Reset()
 {
+#ifdef USE_BANKED_MEMORY_ACCESS
 	memory->SetPage(1, eMemory::P_RAM5);
 	memory->SetPage(2, eMemory::P_RAM2);
 	memory->SetPage(3, eMemory::P_RAM0);
+#endif
+#ifndef NO_USE_128K
+	locked = false;
+#endif
 }
 #endif
 #ifndef NO_USE_128K
@@ -294,5 +309,6 @@ void eRam::IoWrite(word port, byte v, int tact)
 {
 	int page = eMemory::P_RAM0 + (v & 7);
 	memory->SetPage(3, page);
+	locked = (v & 0x20) != 0;
 }
 #endif
@@ -41,7 +41,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 class eMemory
 {
 public:
+#ifndef USE_MACHINE_ARENA
 	eMemory();
+#else
+	eMemory(byte* pages); // SIZE bytes owned by the machine
+#endif
 #ifndef NO_USE_DESTRUCTORS
 	virtual ~eMemory();
 #endif
@@ -124,8 +128,7 @@ public:
 #endif
 #ifndef NO_USE_128K
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoWrite(word port) const;
-	virtual dword IoNeed() const { return ION_WRITE; }
+	bool IoWrite(word port) const { return !mode_48k && !(port & 2) && !(port & 0x8000); } // zx128 port
 #endif
 	virtual void IoWrite(word port, byte v, int tact);
 #endif
@@ -167,6 +170,7 @@ public:
 		}
 #endif
 	}
+	ePage PageSelected() const { return page_selected; }
 	bool DosSelected() const {
 #ifndef NO_USE_DOS
 		return page_selected == ROM_DOS;
@@ -233,16 +237,21 @@ protected:
 class eRam : public eDevice
 {
 public:
-	eRam(eMemory* m) : memory(m), mode_48k(false) {}
-#ifdef USE_BANKED_MEMORY_ACCESS
+	eRam(eMemory* m) : memory(m), mode_48k(false)
+#ifndef NO_USE_128K
+		, locked(false)
+#endif
+	{}
+#if defined(USE_BANKED_MEMORY_ACCESS) || !defined(NO_USE_128K)
 	virtual void Reset();
 #endif
 #ifndef NO_USE_128K
 	void Mode48k(bool on) { mode_48k = on; }
 	virtual void IoWrite(word port, byte v, int tact);
+	// 7FFD bit 5; paging isn't actually locked, but snapshots need to carry it
+	bool Locked() const { return locked; }
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoWrite(word port) const;
-	virtual dword IoNeed() const { return ION_WRITE; }
+	bool IoWrite(word port) const { return !mode_48k && !(port & 2) && !(port & 0x8000); } // zx128 port
 #endif
 #endif
 	bool Mode48k() const { return mode_48k; }
@@ -251,6 +260,9 @@ public:
 protected:
 	eMemory* memory;
 	bool mode_48k;
+#ifndef NO_USE_128K
+	bool locked;
+#endif
 };
 
 #endif//__MEMORY_H__
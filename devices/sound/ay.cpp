@@ -90,26 +90,6 @@ eAY::eAY() : t(0)
 //=============================================================================
 //	eAY::IoRead
 //-----------------------------------------------------------------------------
-bool eAY::IoRead(word port) const
-{
-	return (port&0xC0FF) == 0xC0FD;
-}
-//=============================================================================
-//	eAY::IoWrite
-//-----------------------------------------------------------------------------
-bool eAY::IoWrite(word port) const
-{
-	if(port&2)
-		return false;
-	if((port & 0xC0FF) == 0xC0FD)
-		return true;
-	if((port & 0xC000) == 0x8000)
-		return true;
-	return false;
-}
-//=============================================================================
-//	eAY::IoRead
-//-----------------------------------------------------------------------------
 void eAY::IoRead(word port, byte* v, int tact)
 {
 	*v = Read();
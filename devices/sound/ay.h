@@ -84,8 +84,8 @@ public:
 #endif
 
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoRead(word port) const;
-	virtual bool IoWrite(word port) const;
+	bool IoRead(word port) const { return (port&0xC0FF) == 0xC0FD; }
+	bool IoWrite(word port) const { return !(port&2) && ((port & 0xC0FF) == 0xC0FD || (port & 0xC000) == 0x8000); }
 	virtual void IoRead(word port, byte* v, int tact);
 	virtual void IoWrite(word port, byte v, int tact);
 #endif
@@ -98,15 +98,14 @@ public:
 	void SetVolumes(dword global_vol, const SNDCHIP_VOLTAB *voltab, const SNDCHIP_PANTAB *stereo);
 	void SetRegs(const byte _reg[16]) { memcpy(reg, _reg, sizeof(reg)); ApplyRegs(0); }
 	void Select(byte nreg);
+	const byte* GetRegs() const { return reg; }
+	byte Selected() const { return activereg; }
 
 	virtual void Reset() { _Reset(); }
 	virtual void FrameStart(dword tacts);
 	virtual void FrameEnd(dword tacts);
 
 	static eDeviceId Id() { return D_AY; }
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual dword IoNeed() const { return ION_WRITE|ION_READ; }
-#endif
 
 	void Write(dword timestamp, byte val);
 	byte Read();
@@ -29,15 +29,6 @@ eBeeper::eBeeper() {
 //=============================================================================
 //	eBeeper::IoWrite
 //-----------------------------------------------------------------------------
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-bool eBeeper::IoWrite(word port) const
-{
-	return !(port&1);
-}
-#endif
-//=============================================================================
-//	eBeeper::IoWrite
-//-----------------------------------------------------------------------------
 void eBeeper::IoWrite(word port, byte v, int tact)
 {
 //	const short spk_vol = 8192;
@@ -35,8 +35,7 @@ public:
 	static eDeviceId Id() { return D_BEEPER; }
 	void Reset() override;
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoWrite(word port) const;
-	virtual dword IoNeed() const { return ION_WRITE; }
+	bool IoWrite(word port) const { return !(port&1); }
 #endif
 	void FrameStart(dword tacts) override;
 	void FrameEnd(dword tacts) override;
@@ -95,22 +95,6 @@ void eUla::SwitchScreen(bool first, int tact)
 	base = memory->Get(page);
 }
 #endif
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
-//=============================================================================
-//	eUla::IoRead
-//-----------------------------------------------------------------------------
-bool eUla::IoRead(word port) const
-{
-	return (port&0xff) == 0xff;
-}
-//=============================================================================
-//	eUla::IoWrite
-//-----------------------------------------------------------------------------
-bool eUla::IoWrite(word port) const
-{
-	return !(port&1) || (!mode_48k && !(port & 2) && !(port & 0x8000));
-}
-#endif
 //=============================================================================
 //	eUla::IoRead
 //-----------------------------------------------------------------------------
@@ -41,9 +41,8 @@ public:
 	virtual void FrameUpdate();
 
 #ifndef USE_HACKED_DEVICE_ABSTRACTION
-	virtual bool IoRead(word port) const final;
-	virtual bool IoWrite(word port) const final;
-	virtual dword IoNeed() const { return ION_WRITE|ION_READ; }
+	bool IoRead(word port) const { return (port&0xff) == 0xff; }
+	bool IoWrite(word port) const { return !(port&1) || (!mode_48k && !(port & 2) && !(port & 0x8000)); }
 #endif
 	virtual void IoRead(word port, byte* v, int tact) final;
 	virtual void IoWrite(word port, byte v, int tact) final;
@@ -53,6 +52,7 @@ public:
 
 	byte	BorderColor() const { return border_color; }
 	bool	FirstScreen() const { return first_screen; }
+	const byte* ScreenMemory() const { return base; } // displayed screen page, pixels then attributes
 #ifndef NO_USE_128K
 	void	Mode48k(bool on)	{ mode_48k = on; }
 #endif
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2023 Graham Sanderson
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "fast_compress.h"
+
+using std::vector;
+
+// must match stream.c (COMPRESSED_STREAM_FAST_MAGIC and TINFL_LZ_DICT_SIZE, which is reduced to 4K in our miniz)
+static const char fast_magic[] = "ZXF1";
+static const uint block_size = 4096;
+static const uint max_offset = 4096;
+static const uint min_match = 4;
+// we only run at build time, so search hard
+static const uint max_chain = 1024;
+static const uint hash_bits = 16;
+
+static inline uint hash4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return (v * 2654435761u) >> (32 - hash_bits);
+}
+
+static void put_length(vector<uint8_t>& out, size_t len) {
+    while (len >= 255) {
+        out.push_back(255);
+        len -= 255;
+    }
+    out.push_back((uint8_t)len);
+}
+
+static void put_sequence(vector<uint8_t>& out, const uint8_t *literals, size_t literal_len, uint offset, size_t match_len) {
+    size_t match_code = match_len ? match_len - min_match : 0;
+    out.push_back((uint8_t)((std::min(literal_len, (size_t)15) << 4) | std::min(match_code, (size_t)15)));
+    if (literal_len >= 15) put_length(out, literal_len - 15);
+    out.insert(out.end(), literals, literals + literal_len);
+    if (match_len) {
+        out.push_back((uint8_t)offset);
+        out.push_back((uint8_t)(offset >> 8));
+        if (match_code >= 15) put_length(out, match_code - 15);
+    }
+}
+
+vector<uint8_t> fast_compress(const vector<uint8_t>& raw) {
+    vector<uint8_t> out(fast_magic, fast_magic + sizeof(fast_magic) - 1);
+    const uint8_t *data = raw.data();
+    size_t size = raw.size();
+    vector<int> head(1u << hash_bits, -1);
+    vector<int> prev(size, -1);
+    auto insert = [&](size_t pos) {
+        if (pos + min_match > size) return;
+        uint h = hash4(data + pos);
+        prev[pos] = head[h];
+        head[h] = (int)pos;
+    };
+    for (size_t block_start = 0; block_start < size; block_start += block_size) {
+        size_t block_end = std::min(size, block_start + block_size);
+        size_t pos = block_start;
+        size_t literal_start = pos;
+        while (pos + min_match <= block_end) {
+            // matches may reach back into the previous block, but must end within this one
+            size_t best_len = 0;
+            uint best_offset = 0;
+            size_t limit = block_end - pos;
+            uint chain = max_chain;
+            for (int cand = head[hash4(data + pos)]; cand >= 0 && pos - cand <= max_offset && chain--; cand = prev[cand]) {
+                if (data[cand + best_len] != data[pos + best_len]) continue;
+                size_t len = 0;
+                while (len < limit && data[cand + len] == data[pos + len]) len++;
+                if (len > best_len) {
+                    best_len = len;
+                    best_offset = (uint)(pos - cand);
+                    if (len == limit) break;
+                }
+            }
+            if (best_len >= min_match) {
+                put_sequence(out, data + literal_start, pos - literal_start, best_offset, best_len);
+                for (size_t i = 0; i < best_len; i++) insert(pos + i);
+                pos += best_len;
+                literal_start = pos;
+            } else {
+                insert(pos++);
+            }
+        }
+        // each block ends with a literal only sequence (possibly empty)
+        for (; pos < block_end; pos++) insert(pos);
+        put_sequence(out, data + literal_start, block_end - literal_start, 0, 0);
+    }
+    return out;
+}
@@ -0,0 +1,20 @@
+/*
+ * Copyright (c) 2023 Graham Sanderson
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef FAST_COMPRESS_H
+#define FAST_COMPRESS_H
+
+#include <cstdint>
+#include <vector>
+
+// bump whenever the compressed output changes, so that cached blobs from an older compressor are not reused
+#define FAST_COMPRESS_VERSION 1
+
+// compress into the FAST format decoded by compressed_stream in stream/stream.c (LZ4 style sequences with
+// a 4K window, blocks of 4K output); much quicker to decode than zlib at the cost of some size
+std::vector<uint8_t> fast_compress(const std::vector<uint8_t>& raw);
+
+#endif
@@ -13,6 +13,12 @@
 #include <filesystem>
 #include <cstring>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <map>
+#include <memory>
+#include <iomanip>
 
 #define MINIZ_NO_STDIO
 #define MINIZ_NO_ARCHIVE_APIS
@@ -21,6 +27,7 @@
 #define MINIZ_NO_MALLOC
 #include "miniz.h"
 #include "khan/games/games.h"
+#include "fast_compress.h"
 
 #define ERROR_ARGS -1
 #define ERROR_UNKNOWN -2
@@ -32,9 +39,13 @@ using std::vector;
 using std::filesystem::path;
 
 string root_dir;
+string cache_dir;
 bool is_game;
 bool is_rom;
+int compression_level = 1500;
 
+// bump whenever compress() changes its output (the miniz version is part of the cache key too)
+#define ZLIB_COMPRESS_VERSION 1
 vector<uint8_t> compress(const vector<uint8_t>& raw);
 
 static string hex_string(int value, int width = 8, bool prefix = true) {
@@ -59,7 +70,7 @@ private:
 };
 
 static int usage() {
-    fprintf(stderr, "Usage: embed_tool [-d | -r] -p <root_path> <description file> <output c file>\n");
+    fprintf(stderr, "Usage: embed_tool [-g | -r] [-p <root_path>] [-c <cache_dir>] [-j <threads>] <description file> <output c file>\n");
     return ERROR_ARGS;
 }
 
@@ -81,25 +92,123 @@ string trim(const string &str) {
     return trim_left(trim_right(str));
 }
 
+struct entry {
+    string name;
+    string ext;
+    string file;
+    uint flags;
+    uint payload; // index into payloads
+};
+
+struct payload {
+    vector<uint8_t> contents;
+    uint64_t hash;
+    bool fast;
+    vector<uint8_t> compressed;
+};
+
+// FNV-1a; only used to key the cache and find duplicates (contents are compared too)
+static uint64_t content_hash(const vector<uint8_t>& data) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (uint8_t b : data) {
+        h ^= b;
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+static vector<uint8_t> read_file(const string& file) {
+    std::ifstream in(file, std::ios::binary);
+    if (!in.good()) {
+        std::stringstream ss;
+        ss << "Can't open " << file;
+        throw failure(ERROR_FILE, ss.str());
+    }
+    return vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static path cache_path(const payload& p) {
+    path fs_path = cache_dir;
+    // the cache outlives clean builds, so the key includes the compressor version as well as its input
+    string format = p.fast ? "_f" + std::to_string(FAST_COMPRESS_VERSION) :
+                    "_z" + std::to_string(compression_level) + "_" + std::to_string(ZLIB_COMPRESS_VERSION) + "_" + MZ_VERSION;
+    fs_path /= hex_string((int)(p.hash >> 32), 8, false) + hex_string((int)p.hash, 8, false) + "_" +
+               std::to_string(p.contents.size()) + format;
+    return fs_path;
+}
+
+static void compress_payload(payload& p) {
+    if (!cache_dir.empty()) {
+        path cached = cache_path(p);
+        std::error_code ec;
+        if (std::filesystem::exists(cached, ec)) {
+            p.compressed = read_file(cached);
+            return;
+        }
+    }
+    p.compressed = p.fast ? fast_compress(p.contents) : compress(p.contents);
+    if (!cache_dir.empty()) {
+        // write then rename, so concurrent runs never see a partial file
+        path cached = cache_path(p);
+        path tmp = cached;
+        tmp += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+        std::ofstream out(tmp, std::ios::binary);
+        out.write((const char *)p.compressed.data(), p.compressed.size());
+        out.close();
+        std::error_code ec;
+        if (out.good()) std::filesystem::rename(tmp, cached, ec);
+        if (!out.good() || ec) std::filesystem::remove(tmp, ec);
+    }
+}
+
+int thread_count = 0;
+
+static void compress_payloads(vector<payload>& payloads) {
+    uint threads = thread_count > 0 ? thread_count : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min(threads, (uint)payloads.size());
+    std::atomic<uint> next(0);
+    std::exception_ptr error;
+    std::mutex error_mutex;
+    auto worker = [&]() {
+        for (uint i; (i = next++) < payloads.size(); ) {
+            try {
+                compress_payload(payloads[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    };
+    vector<std::thread> pool;
+    for (uint i = 1; i < threads; i++) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+    if (error) std::rethrow_exception(error);
+}
+
 void doit(std::ifstream &in, std::ofstream &out) {
     string entity = is_game ? "game" : "rom";
 
     string line;
-    auto dump = [&](vector<uint8_t> data) {
+    auto dump = [&](const vector<uint8_t>& data) {
+        // formatted by hand; going through a stringstream per byte dominates the run time for large assets
+        static const char digits[] = "0123456789abcdef";
+        string text;
+        text.reserve(data.size() * 6 + (data.size() / 32 + 1) * 4);
         for (uint i = 0; i < data.size(); i += 32) {
-            out << "   ";
+            text += "   ";
             for (uint j = i; j < std::min(i + 32, (uint) data.size()); j++) {
-                out << hex_string(data[j], 2) << ", ";
+                char hex[6] = { '0', 'x', digits[data[j] >> 4], digits[data[j] & 15], ',', ' ' };
+                text.append(hex, 6);
             }
-            out << "\n";
+            text += "\n";
         }
+        out << text;
     };
 
-    std::vector<std::tuple<string, string, uint, uint>> games;
-
-    out << "#include <stdio.h>\n";
-    out << "#include \"../std.h\"\n";
-    out << "#include \"" << entity << "s/" << entity << "s.h\"\n";
+    vector<entry> games;
+    vector<payload> payloads;
+    std::multimap<uint64_t, uint> payloads_by_hash;
 
     int default_index = -1;
     for (int lnum = 1; std::getline(in, line); lnum++) {
@@ -111,6 +220,7 @@ void doit(std::ifstream &in, std::ofstream &out) {
                 line = line.substr(1);
             }
             uint flags = 0;
+            bool fast = false;
             auto starts_with_and_skip = [](string& line, string to_match) {
                 if (line.find(to_match) == 0) {
                     line = line.substr(to_match.length());
@@ -128,6 +238,11 @@ void doit(std::ifstream &in, std::ofstream &out) {
                     flags |= GF_NO_WAIT_VBLANK;
                     continue;
                 }
+                // store in the FAST (LZ4 style) format rather than zlib; bigger but much quicker to decompress
+                if (starts_with_and_skip(line, "FAST")) {
+                    fast = true;
+                    continue;
+                }
                 break;
             }
             size_t split = line.find_first_of('=');
@@ -143,56 +258,59 @@ void doit(std::ifstream &in, std::ofstream &out) {
                 ss << "Expected to find name = value at line " << lnum;
                 throw failure(ERROR_SYNTAX, ss.str());
             }
-            int index = games.size();
             if (!root_dir.empty()) {
                 path fs_path = root_dir;
                 fs_path /= file;
                 file = fs_path;
             }
-            FILE *fp;
-            const char *fn = file.c_str();
-            const char *ext;
-            ext = strrchr(fn, '.');
+            const char *ext = strrchr(file.c_str(), '.');
             if (!ext) {
                 std::stringstream ss;
-                ss << "Expected file extension on " << fn;
+                ss << "Expected file extension on " << file;
                 throw failure(ERROR_ARGS, ss.str());
             }
-            if ((fp = fopen(fn, "rb"))) {
-                const struct sdf_geometry *geo;
-                vector<uint8_t> contents;
-                fseek(fp, 0, SEEK_END);
-                size_t size = ftell(fp);
-                fseek(fp, 0, SEEK_SET);
-                games.emplace_back(name, ext, size, flags);
-                contents.resize(size);
-                if (1 != fread(contents.data(), size, 1, fp)) {
-                    throw failure(ERROR_FILE, "Failed to read file\n");
+            payload p;
+            p.contents = read_file(file);
+            p.hash = content_hash(p.contents);
+            p.fast = fast;
+            // identical files share one compressed array
+            uint index = payloads.size();
+            auto range = payloads_by_hash.equal_range(p.hash);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (payloads[it->second].fast == p.fast && payloads[it->second].contents == p.contents) {
+                    index = it->second;
+                    break;
                 }
-                auto compressed = compress(contents);
-                fclose(fp);
-                out << "static unsigned char __game_data " << entity << "_" << index << "_data_z[" << compressed.size()
-                    << "] = {\n";
-                dump(compressed);
-                out << "};\n";
-            } else {
-                std::stringstream ss;
-                ss << "Can't open " << file;
-                throw failure(ERROR_FILE, ss.str());
             }
+            if (index == payloads.size()) {
+                payloads_by_hash.emplace(p.hash, index);
+                payloads.push_back(std::move(p));
+            }
+            games.push_back({name, ext, file, flags, index});
         }
+    }
+
+    compress_payloads(payloads);
 
+    out << "#include <stdio.h>\n";
+    out << "#include \"../std.h\"\n";
+    out << "#include \"" << entity << "s/" << entity << "s.h\"\n";
+
+    for (uint index = 0; index < payloads.size(); index++) {
+        const auto& compressed = payloads[index].compressed;
+        out << "static unsigned char __game_data " << entity << "_" << index << "_data_z[" << compressed.size()
+            << "] = {\n";
+        dump(compressed);
+        out << "};\n";
     }
 
     out << "embedded_" << entity << "_t embedded_" << entity << "s[" << games.size() << "] = {\n";
-    int i = 0;
     for (const auto &e : games) {
-        out << "   { \"" << std::get<0>(e) << "\",";
-        if (is_game) out << " \"" << std::get<1>(e) << "\",";
-        out << entity << "_" << i << "_data_z, sizeof(" << entity << "_" << i << "_data_z), " << std::get<2>(e) << "";
-        if (is_game) out << ", " << std::get<3>(e);
+        out << "   { \"" << e.name << "\",";
+        if (is_game) out << " \"" << e.ext << "\",";
+        out << entity << "_" << e.payload << "_data_z, sizeof(" << entity << "_" << e.payload << "_data_z), " << payloads[e.payload].contents.size() << "";
+        if (is_game) out << ", " << e.flags;
         out << " },\n";
-        i++;
     }
     out << "};\n";
     out << "int embedded_" << entity << "_count = " << games.size() << ";\n";
@@ -210,6 +328,16 @@ int main(int argc, char **argv) {
                         root_dir = argv[++i];
                     }
                     break;
+                case 'c':
+                    if (i != argc - 1) {
+                        cache_dir = argv[++i];
+                    }
+                    break;
+                case 'j':
+                    if (i != argc - 1) {
+                        thread_count = atoi(argv[++i]);
+                    }
+                    break;
                 case 'r':
                     is_rom = true;
                     break;
@@ -233,6 +361,9 @@ int main(int argc, char **argv) {
         usage();
     } else {
         try {
+            if (!cache_dir.empty()) {
+                std::filesystem::create_directories(cache_dir);
+            }
             std::ifstream ifile(in_filename);
             if (!ifile.good()) {
                 std::stringstream ss;
@@ -263,9 +394,11 @@ int main(int argc, char **argv) {
 
 vector<uint8_t> compress(const vector<uint8_t>& raw) {
     tdefl_status status;
-    static tdefl_compressor deflator;
+    // one per call as we are called from multiple threads (and it is too big for the stack)
+    std::unique_ptr<tdefl_compressor> deflator_holder(new tdefl_compressor);
+    tdefl_compressor& deflator = *deflator_holder;
 
-    mz_uint comp_flags = TDEFL_WRITE_ZLIB_HEADER | 1500;
+    mz_uint comp_flags = TDEFL_WRITE_ZLIB_HEADER | compression_level;
     // Initialize the low-level compressor.
     status = tdefl_init(&deflator, NULL, NULL, comp_flags);
     if (status != TDEFL_STATUS_OKAY) {
@@ -61,6 +61,11 @@ bool eFileType::Open(const char* name) const
 	}
 #endif
 #ifndef USE_EMBEDDED_FILES
+#if defined(USE_STREAM) && defined(ENABLE_MMAP_STREAM)
+	struct stream *mapped = mmap_stream_open(name);
+	if(mapped)
+		return Open(mapped);
+#endif
 	FILE* f = fopen(name, "rb");
 	if(f)
 	{
@@ -72,16 +77,17 @@ bool eFileType::Open(const char* name) const
 		fclose(f);
 		if(r != size)
 		{
-			SAFE_DELETE_ARRAY(buf);
+			free(buf);
 			return false;
 		}
 #ifndef USE_STREAM
 		bool ok = Open(buf, size);
+		free(buf);
 #else
+		// the stream owns buf now
 		struct stream *stream = memory_stream_open(buf, size, true);
 		bool ok = Open(stream);
 #endif
-		free(buf);
 		return ok;
 	}
 #else
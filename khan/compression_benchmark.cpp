@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2023 Graham Sanderson
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+// compares decompression of zlib and FAST format data through compressed_stream on real assets:
+//   khan_compression_benchmark <file>...
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+#include "miniz.h"
+#include "stream.h"
+#include "fast_compress.h"
+
+using std::vector;
+
+static vector<uint8_t> zlib_compress(const vector<uint8_t>& raw) {
+    // same settings as embed_tool
+    std::unique_ptr<tdefl_compressor> deflator(new tdefl_compressor);
+    tdefl_init(deflator.get(), NULL, NULL, TDEFL_WRITE_ZLIB_HEADER | 1500);
+    vector<uint8_t> compressed(raw.size() * 2 + 64);
+    size_t in_bytes = raw.size();
+    size_t out_bytes = compressed.size();
+    tdefl_compress(deflator.get(), raw.data(), &in_bytes, compressed.data(), &out_bytes, TDEFL_FINISH);
+    compressed.resize(out_bytes);
+    return compressed;
+}
+
+// returns MB/s of output, or 0 if the output didn't match
+static double decode_rate(const vector<uint8_t>& compressed, const vector<uint8_t>& raw) {
+    vector<uint8_t> out(raw.size());
+    struct stream *s = compressed_stream_open(memory_stream_open(compressed.data(), compressed.size(), false), raw.size());
+    if (!s) return 0;
+    int iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double elapsed;
+    do {
+        stream_reset(s);
+        stream_read(s, out.data(), out.size(), true);
+        iterations++;
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (elapsed < 0.25);
+    stream_close(s);
+    if (out != raw) return 0;
+    return raw.size() * (double)iterations / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: khan_compression_benchmark <file>...\n");
+        return -1;
+    }
+    printf("%-32s %8s %8s %8s %10s %10s %7s\n", "file", "size", "zlib", "fast", "zlib MB/s", "fast MB/s", "speedup");
+    size_t total_raw = 0, total_zlib = 0, total_fast = 0;
+    double total_zlib_time = 0, total_fast_time = 0;
+    int rc = 0;
+    for (int i = 1; i < argc; i++) {
+        std::ifstream in(argv[i], std::ios::binary);
+        if (!in.good()) {
+            fprintf(stderr, "Can't open %s\n", argv[i]);
+            rc = -1;
+            continue;
+        }
+        vector<uint8_t> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        if (raw.empty()) continue;
+        vector<uint8_t> zlib = zlib_compress(raw);
+        vector<uint8_t> fast = fast_compress(raw);
+        double zlib_rate = decode_rate(zlib, raw);
+        double fast_rate = decode_rate(fast, raw);
+        if (!zlib_rate || !fast_rate) {
+            fprintf(stderr, "%s: decompressed data mismatch\n", argv[i]);
+            rc = -1;
+            continue;
+        }
+        const char *name = strrchr(argv[i], '/');
+        name = name ? name + 1 : argv[i];
+        printf("%-32s %8zu %8zu %8zu %10.1f %10.1f %6.2fx\n", name, raw.size(), zlib.size(), fast.size(),
+               zlib_rate, fast_rate, fast_rate / zlib_rate);
+        total_raw += raw.size();
+        total_zlib += zlib.size();
+        total_fast += fast.size();
+        total_zlib_time += raw.size() / zlib_rate;
+        total_fast_time += raw.size() / fast_rate;
+    }
+    if (total_raw) {
+        printf("%-32s %8zu %8zu %8zu %10.1f %10.1f %6.2fx\n", "total", total_raw, total_zlib, total_fast,
+               total_raw / total_zlib_time, total_raw / total_fast_time, total_zlib_time / total_fast_time);
+    }
+    return rc;
+}
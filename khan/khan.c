@@ -297,6 +297,22 @@ int render_loop() {
 
 #ifndef USE_CONST_CMD_LOOKUP
 uint32_t cmd_lookup[256];
+
+static void init_cmd_lookup() {
+    for(int i=0;i<256;i++) {
+        uint32_t c = 0;
+        for(int j=0; j<8;j++) {
+            uint b;
+            if (i & (1<<(7-j))) {
+                b = j==7 ? video_khan_offset_ink_end_of_block : video_khan_offset_ink;
+            } else {
+                b = j==7 ? video_khan_offset_paper_end_of_block : video_khan_offset_paper;
+            }
+            c |= (b << (j*4));
+        }
+        cmd_lookup[i] = c;
+    }
+}
 #else
 const uint32_t cmd_lookup[256] = {
         0xb0000000, 0xf0000000, 0xb5000000, 0xf5000000, 0xb0500000, 0xf0500000, 0xb5500000, 0xf5500000,
@@ -365,19 +381,7 @@ int video_main(void) {
     scanvideo_setup(&the_video_mode);
 
 #ifndef USE_CONST_CMD_LOOKUP
-    for(int i=0;i<256;i++) {
-        uint32_t c = 0;
-        for(int j=0; j<8;j++) {
-            uint b;
-            if (i & (1<<(7-j))) {
-                b = j==7 ? video_khan_offset_ink_end_of_block : video_khan_offset_ink;
-            } else {
-                b = j==7 ? video_khan_offset_paper_end_of_block : video_khan_offset_paper;
-            }
-            c |= (b << (j*4));
-        }
-        cmd_lookup[i] = c;
-    }
+    init_cmd_lookup();
 #endif
 //    printf("static uint32_t cmd_lookup[256] = {\n");
 //    for(int i=0;i<0x100;i+=8) {
@@ -879,6 +883,370 @@ void simulate_video_pio_video_khan(const uint32_t *dma_data, uint32_t dma_data_s
 }
 #endif
 
+#ifdef KHAN_RENDER_BENCHMARK
+#if PICO_ON_DEVICE
+#error KHAN_RENDER_BENCHMARK is a host only build
+#endif
+// renders every scanline of real screens (embedded images plus any files given on the command line) in each
+// menu state through render_scanline_khan, checks the command stream by decoding it with the pio simulator above,
+// and reports host time / instruction counts per line. host numbers are only a relative measure; the device
+// budget is printed alongside for reference
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define BENCHMARK_REPEATS 8
+#define BENCHMARK_SNAPSHOTS 3
+#define BENCHMARK_DEFAULT_FRAMES 250
+// not expected from either plane (no alpha bit, and not a speccy color)
+#define BENCHMARK_SENTINEL 0x1234
+#define BENCHMARK_PIXELS 1024
+
+enum benchmark_state {
+    BS_PLAIN,
+    BS_FADING,
+    BS_MENU,
+    BS_SELECT,
+    BS_FLASH,
+    BS_ERROR,
+    BS_COUNT
+};
+
+static const char *benchmark_state_names[BS_COUNT] = {
+        "plain", "fading", "menu", "select", "flash", "error"
+};
+
+struct benchmark_stats {
+    uint64_t lines;
+    uint64_t total_ns;
+    uint64_t total_insns;
+    uint64_t max_ns;
+    uint64_t max_insns;
+    uint max_ns_line;
+    uint max_insns_line;
+    uint max_words;
+    uint max_words2;
+};
+
+static struct scanvideo_scanline_buffer benchmark_dest;
+static uint32_t benchmark_data[PICO_SCANVIDEO_MAX_SCANLINE_BUFFER_WORDS];
+static uint32_t benchmark_data2[PICO_SCANVIDEO_MAX_SCANLINE_BUFFER2_WORDS];
+static uint16_t benchmark_pixels[BENCHMARK_PIXELS];
+static uint16_t benchmark_pixels2[BENCHMARK_PIXELS];
+static int benchmark_perf_fd = -1;
+static uint64_t benchmark_perf_overhead;
+static int benchmark_failures;
+
+static struct benchmark_stats benchmark_worst;
+static const char *benchmark_worst_image;
+static int benchmark_worst_state;
+
+static uint64_t benchmark_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void benchmark_prepare_dest(uint l) {
+    benchmark_dest.scanline_id = l;
+    benchmark_dest.data = benchmark_data;
+    benchmark_dest.data_max = PICO_SCANVIDEO_MAX_SCANLINE_BUFFER_WORDS;
+    benchmark_dest.data_used = 0;
+    benchmark_dest.data2 = benchmark_data2;
+    benchmark_dest.data2_max = PICO_SCANVIDEO_MAX_SCANLINE_BUFFER2_WORDS;
+    benchmark_dest.data2_used = 0;
+}
+
+// user mode instructions retired by render_scanline_khan for line l (minus the cost of the enable/disable itself)
+static uint64_t benchmark_count_insns(uint l, bool render) {
+    uint64_t count = 0;
+#ifdef __linux__
+    benchmark_prepare_dest(l);
+    ioctl(benchmark_perf_fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(benchmark_perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    if (render) render_scanline_khan(&benchmark_dest, 0);
+    ioctl(benchmark_perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+    if (read(benchmark_perf_fd, &count, sizeof(count)) != sizeof(count)) count = 0;
+#endif
+    return count > benchmark_perf_overhead ? count - benchmark_perf_overhead : 0;
+}
+
+static void benchmark_perf_open() {
+#ifdef __linux__
+    struct perf_event_attr pe;
+    memset(&pe, 0, sizeof(pe));
+    pe.type = PERF_TYPE_HARDWARE;
+    pe.size = sizeof(pe);
+    pe.config = PERF_COUNT_HW_INSTRUCTIONS;
+    pe.disabled = 1;
+    pe.exclude_kernel = 1;
+    pe.exclude_hv = 1;
+    benchmark_perf_fd = (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+    if (benchmark_perf_fd >= 0) {
+        benchmark_perf_overhead = 0;
+        uint64_t overhead = UINT64_MAX;
+        for (int r = 0; r < BENCHMARK_REPEATS * 4; r++) {
+            uint64_t c = benchmark_count_insns(0, false);
+            if (c < overhead) overhead = c;
+        }
+        benchmark_perf_overhead = overhead;
+    }
+#endif
+    if (benchmark_perf_fd < 0) {
+        printf("note: hardware instruction counter unavailable, reporting time only\n");
+    }
+}
+
+static bool benchmark_fail(const char *image, int state, uint l, const char *what, int x) {
+    if (benchmark_failures++ < 20) {
+        printf("FAIL %s (%s) line %u: %s at x=%d\n", image, benchmark_state_names[state], l, what, x);
+    }
+    return false;
+}
+
+// decodes both planes of the last rendered line and compares them with what khan_get_scanline_info and the menu
+// state say should be on screen
+static bool benchmark_validate(const char *image, int state, uint l) {
+    const uint width = the_video_mode.width;
+    const uint8_t *attr = 0;
+    const uint8_t *pixels = 0;
+    uint16_t border = 0;
+    const uint32_t *attr_colors = 0;
+    const uint32_t *dark_attr_colors = 0;
+    int border_top = (the_video_mode.height - 192) / 2;
+    int border_width = (the_video_mode.width - 256) / 2;
+    khan_get_scanline_info(l - border_top, &border, &attr, &pixels, &attr_colors, &dark_attr_colors);
+
+    for (int i = 0; i < BENCHMARK_PIXELS; i++) {
+        benchmark_pixels[i] = benchmark_pixels2[i] = BENCHMARK_SENTINEL;
+    }
+    simulate_video_pio_video_khan(benchmark_data, benchmark_dest.data_used, benchmark_pixels, BENCHMARK_PIXELS, width, false);
+    if (benchmark_pixels[width] != BENCHMARK_SENTINEL) return benchmark_fail(image, state, l, "line too long", width);
+
+    int ml = (int)l - border_top - MENU_AREA_OFFSET_Y;
+    bool dark_area = dark_attr_colors && ml >= 0 && ml <= MENU_LINE_HEIGHT * MENU_MAX_LINES + MENU_AREA_BORDER_HEIGHT * 2;
+    for (int x = 0; x < (int)width; x++) {
+        uint16_t expected = border;
+        int px = x - border_width;
+        if (attr && px >= 0 && px < 256) {
+            int col = px >> 3;
+            const uint32_t *colors = (dark_area && col >= 4 && col < 28) ? dark_attr_colors : attr_colors;
+            uint32_t c = colors[attr[col]];
+            expected = (pixels[col] & (0x80 >> (px & 7))) ? (uint16_t)(c >> 16) : (uint16_t)c;
+        }
+        if (benchmark_pixels[x] != expected) return benchmark_fail(image, state, l, "wrong pixel", x);
+    }
+
+#if PICO_SCANVIDEO_PLANE_COUNT > 1
+    int ml2 = ml - MENU_AREA_BORDER_HEIGHT;
+    if (!(attr && kms.opacity > MENU_OPACITY_THRESHOLD && ml2 > 0 && ml2 < MENU_LINE_HEIGHT * MENU_MAX_LINES)) {
+        if (benchmark_dest.data2_used != 2) return benchmark_fail(image, state, l, "unexpected menu plane data", 0);
+        return true;
+    }
+    simulate_video_pio_video_khan(benchmark_data2, benchmark_dest.data2_used, benchmark_pixels2, BENCHMARK_PIXELS, width, false);
+    int x0 = border_width + (256 - MENU_AREA_WIDTH) / 2 + MENU_LINE_BORDER_WIDTH;
+    int x1 = x0 + MENU_AREA_WIDTH - MENU_LINE_BORDER_WIDTH * 2;
+    for (int x = 0; x < x0; x++) {
+        if (benchmark_pixels2[x]) return benchmark_fail(image, state, l, "menu plane not transparent", x);
+    }
+    for (int x = x0; x < x1; x++) {
+        if (benchmark_pixels2[x] == BENCHMARK_SENTINEL) return benchmark_fail(image, state, l, "menu line too short", x);
+    }
+    if (benchmark_pixels2[x1] != BENCHMARK_SENTINEL) return benchmark_fail(image, state, l, "menu line too long", x1);
+    uint16_t bg = benchmark_pixels2[x0];
+    int menu_line = ml2 / MENU_LINE_HEIGHT;
+    int menu_line_offset = ml2 - menu_line * MENU_LINE_HEIGHT;
+    if (menu_line_offset >= MENU_GLYPH_Y_OFFSET && menu_line_offset < MENU_GLYPH_Y_OFFSET + MENU_GLYPH_HEIGHT) {
+        const uint8_t *bits = &menu_bitmap[MENU_WIDTH_IN_BLOCKS * (menu_line * MENU_GLYPH_HEIGHT + menu_line_offset - MENU_GLYPH_Y_OFFSET)];
+        int gap = MENU_AREA_WIDTH - (MENU_LINE_BORDER_WIDTH + MENU_LINE_TEXT_INDENT) * 2 - MENU_WIDTH;
+        for (int k = 0; k < MENU_WIDTH_IN_BLOCKS; k++) {
+            int x = x0 + MENU_LINE_TEXT_INDENT + k * 8 + (k >= MENU_LEFT_WIDTH_IN_BLOCKS ? gap : 0);
+            for (int b = 0; b < 8; b++) {
+                bool ink = bits[k] & (0x80 >> b);
+                if ((benchmark_pixels2[x + b] != bg) != ink) return benchmark_fail(image, state, l, "wrong menu glyph pixel", x + b);
+            }
+        }
+    } else {
+        for (int x = x0; x < x1; x++) {
+            if (benchmark_pixels2[x] != bg) return benchmark_fail(image, state, l, "wrong menu background", x);
+        }
+    }
+#endif
+    return true;
+}
+
+static void benchmark_screen(const char *image, int state, struct benchmark_stats *stats) {
+    for (uint l = 0; l < the_video_mode.height; l++) {
+        uint64_t best_ns = UINT64_MAX;
+        uint64_t best_insns = UINT64_MAX;
+        for (int r = 0; r < BENCHMARK_REPEATS; r++) {
+            benchmark_prepare_dest(l);
+            uint64_t t0 = benchmark_now_ns();
+            render_scanline_khan(&benchmark_dest, 0);
+            uint64_t t = benchmark_now_ns() - t0;
+            if (t < best_ns) best_ns = t;
+            if (benchmark_perf_fd >= 0) {
+                uint64_t c = benchmark_count_insns(l, true);
+                if (c < best_insns) best_insns = c;
+            }
+        }
+        if (benchmark_perf_fd < 0) best_insns = 0;
+        benchmark_validate(image, state, l);
+        stats->lines++;
+        stats->total_ns += best_ns;
+        stats->total_insns += best_insns;
+        if (best_ns > stats->max_ns) {
+            stats->max_ns = best_ns;
+            stats->max_ns_line = l;
+        }
+        if (best_insns > stats->max_insns) {
+            stats->max_insns = best_insns;
+            stats->max_insns_line = l;
+        }
+        stats->max_words = MAX(stats->max_words, benchmark_dest.data_used);
+        stats->max_words2 = MAX(stats->max_words2, benchmark_dest.data2_used);
+    }
+}
+
+// what the render thread does at the start of each frame
+static void benchmark_display_frames(int count) {
+    while (count--) {
+        khan_update_menu_visuals();
+        khan_idle_blanking();
+    }
+}
+
+// let the highlight bar come to rest on the selected line
+static void benchmark_settle_selection() {
+    for (int f = 0; f < MENU_LINE_HEIGHT * MENU_MAX_LINES && kms.selection_top_pixel != kms.selected_line * MENU_LINE_HEIGHT; f++) {
+        benchmark_display_frames(1);
+    }
+}
+
+static void benchmark_enter_state(int state) {
+    switch (state) {
+        case BS_PLAIN:
+            khan_hide_menu();
+            while (kms.opacity || kms.disappearing) benchmark_display_frames(1);
+            break;
+        case BS_FADING:
+            khan_menu_key(MK_ESCAPE);
+            // dark background, but still too faint for the menu plane
+            benchmark_display_frames(3);
+            break;
+        case BS_MENU:
+            // fully opaque, with every menu line drawn into the bitmap
+            kms.selected_line = 0;
+            benchmark_display_frames(MENU_OPACITY_MAX + MENU_MAX_LINES);
+            benchmark_settle_selection();
+            break;
+        case BS_FLASH:
+            kms.flashing = true;
+            kms.flash_pos = MENU_FLASH_LENGTH / 4;
+            benchmark_display_frames(1);
+            break;
+        case BS_ERROR:
+            kms.flashing = false;
+            kms.error_level = MENU_ERROR_LEVEL_MAX;
+            benchmark_display_frames(1);
+            break;
+        default:
+            break;
+    }
+}
+
+static void benchmark_report(const char *image, int state, const struct benchmark_stats *stats) {
+    printf("%-24.24s %-6s %8llu %8llu (%3u) %8llu %8llu (%3u) %3u/%u %3u/%u\n", image, benchmark_state_names[state],
+           (unsigned long long)(stats->total_ns / stats->lines), (unsigned long long)stats->max_ns, stats->max_ns_line,
+           (unsigned long long)(stats->total_insns / stats->lines), (unsigned long long)stats->max_insns, stats->max_insns_line,
+           stats->max_words, PICO_SCANVIDEO_MAX_SCANLINE_BUFFER_WORDS, stats->max_words2, PICO_SCANVIDEO_MAX_SCANLINE_BUFFER2_WORDS);
+    bool worse = benchmark_perf_fd >= 0 ? stats->max_insns > benchmark_worst.max_insns : stats->max_ns > benchmark_worst.max_ns;
+    if (worse) {
+        benchmark_worst = *stats;
+        benchmark_worst_image = image;
+        benchmark_worst_state = state;
+    }
+}
+
+static void benchmark_image(const char *image, int frames) {
+    struct benchmark_stats stats[BS_COUNT];
+    memset(stats, 0, sizeof(stats));
+    for (int s = 0; s < BENCHMARK_SNAPSHOTS; s++) {
+        khan_benchmark_run_frames(frames);
+        for (int state = 0; state < BS_COUNT; state++) {
+            benchmark_enter_state(state);
+            if (state == BS_SELECT) {
+                // the highlight bar on each line in turn
+                for (int i = 0; i < kms.num_lines; i++) {
+                    kms.selected_line = i;
+                    benchmark_settle_selection();
+                    benchmark_screen(image, state, &stats[state]);
+                }
+            } else {
+                benchmark_screen(image, state, &stats[state]);
+            }
+        }
+    }
+    for (int state = 0; state < BS_COUNT; state++) {
+        benchmark_report(image, state, &stats[state]);
+    }
+}
+
+int khan_render_benchmark(int argc, char **argv) {
+    int frames = BENCHMARK_DEFAULT_FRAMES;
+    int first_file = 1;
+    if (argc > 2 && !strcmp(argv[1], "-f")) {
+        frames = atoi(argv[2]);
+        first_file = 3;
+    }
+#ifndef USE_CONST_CMD_LOOKUP
+    init_cmd_lookup();
+#endif
+    khan_init();
+    benchmark_perf_open();
+
+    const struct scanvideo_timing *timing = the_video_mode.default_timing;
+    uint budget = (uint)(((uint64_t)CLOCK_MHZ * timing->h_total * the_video_mode.yscale) / timing->clock_freq);
+    printf("rendering %d line screens every %d frames, best of %d; times in ns, instructions are host user mode\n",
+           the_video_mode.height, frames, BENCHMARK_REPEATS);
+    printf("%-24s %-6s %8s %14s %8s %14s %7s %6s\n", "image", "state", "avg ns", "max ns (line)", "avg insn",
+           "max insn (line)", "words", "words2");
+
+    int images = khan_benchmark_image_count();
+    for (int i = 0; i < images + argc - first_file; i++) {
+        const char *name;
+        if (i < images) {
+            name = khan_benchmark_select_image(i);
+        } else {
+            name = argv[first_file + i - images];
+            if (!khan_benchmark_open_file(name)) {
+                printf("FAIL unable to open %s\n", name);
+                benchmark_failures++;
+                continue;
+            }
+        }
+        benchmark_image(name, frames);
+    }
+
+    if (benchmark_worst_image) {
+        printf("\nworst line: %s (%s) line %u, %llu ns, %llu instructions\n", benchmark_worst_image,
+               benchmark_state_names[benchmark_worst_state],
+               benchmark_perf_fd >= 0 ? benchmark_worst.max_insns_line : benchmark_worst.max_ns_line,
+               (unsigned long long)benchmark_worst.max_ns, (unsigned long long)benchmark_worst.max_insns);
+    }
+    printf("device budget: %u cycles per rendered line at %d MHz (%u clocks per scanline, yscale %u)\n", budget,
+           CLOCK_MHZ / 1000000, timing->h_total, the_video_mode.yscale);
+    printf("%s: %d validation failures\n", benchmark_failures ? "FAILED" : "PASSED", benchmark_failures);
+    return benchmark_failures ? 1 : 0;
+}
+#endif
+
 #if PICO_ON_DEVICE
 void __cxa_pure_virtual() {
     __breakpoint();
@@ -893,6 +1261,11 @@ void _fini() {
 
 #include "miniz_tinfl.h"
 
+#ifdef KHAN_RENDER_BENCHMARK
+int main(int argc, char **argv) {
+    return khan_render_benchmark(argc, argv);
+}
+#elif !defined(KHAN_TOOL) // host tools built on the khan core (see add_khan_tool) have their own main
 int main(void) {
 #if PICO_SCANVIDEO_48MHZ
     int base_khz = 48000;
@@ -919,6 +1292,7 @@ int main(void) {
 
     return video_main();
 }
+#endif
 
 void khan_cb_begin_frame() {
     DEBUG_PINS_SET(khan_timing, 1);
@@ -358,6 +358,16 @@ static bool do_pulldown56;
 static bool option_next, option_complete;
 static xOptions::eOptionB* option_needed;
 
+static void __maybe_in_ram khan_run_frame() {
+    khan_cb_begin_frame();
+    xPlatform::Handler()->OnLoop();
+    if (++frame >= 15) {
+        frame = 0;
+        color_toggle ^= 256;
+    }
+    khan_cb_end_frame();
+}
+
 void __maybe_in_ram khan_loop()
 {
 #if defined(USE_BANKED_MEMORY_ACCESS) && PICO_ON_DEVICE
@@ -368,13 +378,7 @@ void __maybe_in_ram khan_loop()
             if (do_pulldown56 && ++frame2 >= 6) {
                 frame2 = 0;
             } else {
-                khan_cb_begin_frame();
-                xPlatform::Handler()->OnLoop();
-                if (++frame >= 15) {
-                    frame = 0;
-                    color_toggle ^= 256;
-                }
-                khan_cb_end_frame();
+                khan_run_frame();
             }
         }
         if (!no_wait_for_vblank) scanvideo_wait_for_vblank();
@@ -446,6 +450,27 @@ bool __maybe_in_ram khan_get_scanline_info(int l, uint16_t* border, const uint8_
     return true;
 }
 
+#ifdef KHAN_RENDER_BENCHMARK
+int khan_benchmark_image_count() {
+    return embedded_game_count;
+}
+
+const char *khan_benchmark_select_image(int image) {
+    op_image.SetNow(image);
+    return op_image.Value();
+}
+
+bool khan_benchmark_open_file(const char *name) {
+    return xPlatform::Handler()->OnOpenFile(name);
+}
+
+void khan_benchmark_run_frames(int count) {
+    while (count--) {
+        khan_run_frame();
+    }
+}
+#endif
+
 using xOptions::eOptionB;
 
 void __maybe_in_ram khan_fill_main_menu() {
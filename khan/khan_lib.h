@@ -52,6 +52,13 @@ extern void khan_cb_begin_frame();
 extern void khan_cb_end_frame();
 // returns true if the key was consumed
 extern bool khan_menu_selection_change(enum menu_key key);
+#ifdef KHAN_RENDER_BENCHMARK
+// host only hooks for the scanline render benchmark
+extern int khan_benchmark_image_count();
+extern const char *khan_benchmark_select_image(int image);
+extern bool khan_benchmark_open_file(const char *name);
+extern void khan_benchmark_run_frames(int count);
+#endif
 #ifdef USE_KHAN_GPIO
 extern uint8_t khan_gpio_read(uint reg);
 extern void khan_gpio_write(uint reg, uint8_t value);
@@ -9,5 +9,11 @@
 
 void spoono() {
     Z80t::eZ80t cpu;
+#ifdef GENERATE_Z80_CPP
+    cpu.generate_cpp();
+#elif defined(GENERATE_Z80_REPORT)
+    cpu.generate_arm(stderr);
+#else
     cpu.generate_arm();
+#endif
 }
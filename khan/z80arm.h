@@ -171,6 +171,10 @@ namespace xZ80
         inline void set_caller_de(word v) {
             get_caller_regs()->de = v;
         }
+        inline word get_caller_hl() const { return get_caller_regs()->hl; }
+        inline void set_caller_hl(word v) {
+            get_caller_regs()->hl = v;
+        }
         inline word get_caller_ix() const { return get_caller_regs()->ix; }
         inline void set_caller_ix(word v) {
             get_caller_regs()->ix = v;
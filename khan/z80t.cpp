@@ -54,6 +54,8 @@ namespace Z80t
     rs_var_init(scratch);
 
     const char *eZ80t::pending_call = NULL;
+    std::vector<std::string> *eZ80t::function_lines;
+    FILE *eZ80t::report;
 
 #define IMPL_REG16(REGNAME, reg, low, high)\
     struct eZ80t::Reg16<REGNAME> eZ80t::reg; \
@@ -145,7 +147,758 @@ namespace Z80t
         emit_call_func("write16");
     } // low then high
 
-    void eZ80t::generate_arm() {
+    // decode tables, the same for the arm and c++ output
+    const eZ80t::CALLFUNC eZ80t::opcodes[] =
+            {
+                    &eZ80t::Op00, &eZ80t::Op01, &eZ80t::Op02, &eZ80t::Op03, &eZ80t::Op04, &eZ80t::Op05,
+                    &eZ80t::Op06, &eZ80t::Op07,
+                    &eZ80t::Op08, &eZ80t::Op09, &eZ80t::Op0A, &eZ80t::Op0B, &eZ80t::Op0C, &eZ80t::Op0D,
+                    &eZ80t::Op0E, &eZ80t::Op0F,
+                    &eZ80t::Op10, &eZ80t::Op11, &eZ80t::Op12, &eZ80t::Op13, &eZ80t::Op14, &eZ80t::Op15,
+                    &eZ80t::Op16, &eZ80t::Op17,
+                    &eZ80t::Op18, &eZ80t::Op19, &eZ80t::Op1A, &eZ80t::Op1B, &eZ80t::Op1C, &eZ80t::Op1D,
+                    &eZ80t::Op1E, &eZ80t::Op1F,
+                    &eZ80t::Op20, &eZ80t::Op21, &eZ80t::Op22, &eZ80t::Op23, &eZ80t::Op24, &eZ80t::Op25,
+                    &eZ80t::Op26, &eZ80t::Op27,
+                    &eZ80t::Op28, &eZ80t::Op29, &eZ80t::Op2A, &eZ80t::Op2B, &eZ80t::Op2C, &eZ80t::Op2D,
+                    &eZ80t::Op2E, &eZ80t::Op2F,
+                    &eZ80t::Op30, &eZ80t::Op31, &eZ80t::Op32, &eZ80t::Op33, &eZ80t::Op34, &eZ80t::Op35,
+                    &eZ80t::Op36, &eZ80t::Op37,
+                    &eZ80t::Op38, &eZ80t::Op39, &eZ80t::Op3A, &eZ80t::Op3B, &eZ80t::Op3C, &eZ80t::Op3D,
+                    &eZ80t::Op3E, &eZ80t::Op3F,
+
+                    &eZ80t::Op40, &eZ80t::Op41, &eZ80t::Op42, &eZ80t::Op43, &eZ80t::Op44, &eZ80t::Op45,
+                    &eZ80t::Op46, &eZ80t::Op47,
+                    &eZ80t::Op48, &eZ80t::Op49, &eZ80t::Op4A, &eZ80t::Op4B, &eZ80t::Op4C, &eZ80t::Op4D,
+                    &eZ80t::Op4E, &eZ80t::Op4F,
+                    &eZ80t::Op50, &eZ80t::Op51, &eZ80t::Op52, &eZ80t::Op53, &eZ80t::Op54, &eZ80t::Op55,
+                    &eZ80t::Op56, &eZ80t::Op57,
+                    &eZ80t::Op58, &eZ80t::Op59, &eZ80t::Op5A, &eZ80t::Op5B, &eZ80t::Op5C, &eZ80t::Op5D,
+                    &eZ80t::Op5E, &eZ80t::Op5F,
+                    &eZ80t::Op60, &eZ80t::Op61, &eZ80t::Op62, &eZ80t::Op63, &eZ80t::Op64, &eZ80t::Op65,
+                    &eZ80t::Op66, &eZ80t::Op67,
+                    &eZ80t::Op68, &eZ80t::Op69, &eZ80t::Op6A, &eZ80t::Op6B, &eZ80t::Op6C, &eZ80t::Op6D,
+                    &eZ80t::Op6E, &eZ80t::Op6F,
+                    &eZ80t::Op70, &eZ80t::Op71, &eZ80t::Op72, &eZ80t::Op73, &eZ80t::Op74, &eZ80t::Op75,
+                    &eZ80t::Op76, &eZ80t::Op77,
+                    &eZ80t::Op78, &eZ80t::Op79, &eZ80t::Op7A, &eZ80t::Op7B, &eZ80t::Op7C, &eZ80t::Op7D,
+                    &eZ80t::Op7E, &eZ80t::Op7F,
+
+                    &eZ80t::Op80, &eZ80t::Op81, &eZ80t::Op82, &eZ80t::Op83, &eZ80t::Op84, &eZ80t::Op85,
+                    &eZ80t::Op86, &eZ80t::Op87,
+                    &eZ80t::Op88, &eZ80t::Op89, &eZ80t::Op8A, &eZ80t::Op8B, &eZ80t::Op8C, &eZ80t::Op8D,
+                    &eZ80t::Op8E, &eZ80t::Op8F,
+                    &eZ80t::Op90, &eZ80t::Op91, &eZ80t::Op92, &eZ80t::Op93, &eZ80t::Op94, &eZ80t::Op95,
+                    &eZ80t::Op96, &eZ80t::Op97,
+                    &eZ80t::Op98, &eZ80t::Op99, &eZ80t::Op9A, &eZ80t::Op9B, &eZ80t::Op9C, &eZ80t::Op9D,
+                    &eZ80t::Op9E, &eZ80t::Op9F,
+                    &eZ80t::OpA0, &eZ80t::OpA1, &eZ80t::OpA2, &eZ80t::OpA3, &eZ80t::OpA4, &eZ80t::OpA5,
+                    &eZ80t::OpA6, &eZ80t::OpA7,
+                    &eZ80t::OpA8, &eZ80t::OpA9, &eZ80t::OpAA, &eZ80t::OpAB, &eZ80t::OpAC, &eZ80t::OpAD,
+                    &eZ80t::OpAE, &eZ80t::OpAF,
+                    &eZ80t::OpB0, &eZ80t::OpB1, &eZ80t::OpB2, &eZ80t::OpB3, &eZ80t::OpB4, &eZ80t::OpB5,
+                    &eZ80t::OpB6, &eZ80t::OpB7,
+                    &eZ80t::OpB8, &eZ80t::OpB9, &eZ80t::OpBA, &eZ80t::OpBB, &eZ80t::OpBC, &eZ80t::OpBD,
+                    &eZ80t::OpBE, &eZ80t::OpBF,
+
+                    &eZ80t::OpC0, &eZ80t::OpC1, &eZ80t::OpC2, &eZ80t::OpC3, &eZ80t::OpC4, &eZ80t::OpC5,
+                    &eZ80t::OpC6, &eZ80t::OpC7,
+                    &eZ80t::OpC8, &eZ80t::OpC9, &eZ80t::OpCA, &eZ80t::OpCB, &eZ80t::OpCC, &eZ80t::OpCD,
+                    &eZ80t::OpCE, &eZ80t::OpCF,
+                    &eZ80t::OpD0, &eZ80t::OpD1, &eZ80t::OpD2, &eZ80t::OpD3, &eZ80t::OpD4, &eZ80t::OpD5,
+                    &eZ80t::OpD6, &eZ80t::OpD7,
+                    &eZ80t::OpD8, &eZ80t::OpD9, &eZ80t::OpDA, &eZ80t::OpDB, &eZ80t::OpDC, &eZ80t::OpDD,
+                    &eZ80t::OpDE, &eZ80t::OpDF,
+                    &eZ80t::OpE0, &eZ80t::OpE1, &eZ80t::OpE2, &eZ80t::OpE3, &eZ80t::OpE4, &eZ80t::OpE5,
+                    &eZ80t::OpE6, &eZ80t::OpE7,
+                    &eZ80t::OpE8, &eZ80t::OpE9, &eZ80t::OpEA, &eZ80t::OpEB, &eZ80t::OpEC, &eZ80t::OpED,
+                    &eZ80t::OpEE, &eZ80t::OpEF,
+                    &eZ80t::OpF0, &eZ80t::OpF1, &eZ80t::OpF2, &eZ80t::OpF3, &eZ80t::OpF4, &eZ80t::OpF5,
+                    &eZ80t::OpF6, &eZ80t::OpF7,
+                    &eZ80t::OpF8, &eZ80t::OpF9, &eZ80t::OpFA, &eZ80t::OpFB, &eZ80t::OpFC, &eZ80t::OpFD,
+                    &eZ80t::OpFE, &eZ80t::OpFF
+            };
+
+    const eZ80t::CALLFUNC eZ80t::opddcodes[] =
+            {
+                    &eZ80t::Op00, &eZ80t::Op01, &eZ80t::Op02, &eZ80t::Op03, &eZ80t::Op04, &eZ80t::Op05,
+                    &eZ80t::Op06, &eZ80t::Op07,
+                    &eZ80t::Op08, &eZ80t::Opx09, &eZ80t::Op0A, &eZ80t::Op0B, &eZ80t::Op0C, &eZ80t::Op0D,
+                    &eZ80t::Op0E, &eZ80t::Op0F,
+                    &eZ80t::Op10, &eZ80t::Op11, &eZ80t::Op12, &eZ80t::Op13, &eZ80t::Op14, &eZ80t::Op15,
+                    &eZ80t::Op16, &eZ80t::Op17,
+                    &eZ80t::Op18, &eZ80t::Opx19, &eZ80t::Op1A, &eZ80t::Op1B, &eZ80t::Op1C, &eZ80t::Op1D,
+                    &eZ80t::Op1E, &eZ80t::Op1F,
+                    &eZ80t::Op20, &eZ80t::Opx21, &eZ80t::Opx22, &eZ80t::Opx23, &eZ80t::Opx24, &eZ80t::Opx25,
+                    &eZ80t::Opx26, &eZ80t::Op27,
+                    &eZ80t::Op28, &eZ80t::Opx29, &eZ80t::Opx2A, &eZ80t::Opx2B, &eZ80t::Opx2C, &eZ80t::Opx2D,
+                    &eZ80t::Opx2E, &eZ80t::Op2F,
+                    &eZ80t::Op30, &eZ80t::Op31, &eZ80t::Op32, &eZ80t::Op33, &eZ80t::Opx34, &eZ80t::Opx35,
+                    &eZ80t::Opx36, &eZ80t::Op37,
+                    &eZ80t::Op38, &eZ80t::Opx39, &eZ80t::Op3A, &eZ80t::Op3B, &eZ80t::Op3C, &eZ80t::Op3D,
+                    &eZ80t::Op3E, &eZ80t::Op3F,
+
+                    &eZ80t::Op40, &eZ80t::Op41, &eZ80t::Op42, &eZ80t::Op43, &eZ80t::Opx44, &eZ80t::Opx45,
+                    &eZ80t::Opx46, &eZ80t::Op47,
+                    &eZ80t::Op48, &eZ80t::Op49, &eZ80t::Op4A, &eZ80t::Op4B, &eZ80t::Opx4C, &eZ80t::Opx4D,
+                    &eZ80t::Opx4E, &eZ80t::Op4F,
+                    &eZ80t::Op50, &eZ80t::Op51, &eZ80t::Op52, &eZ80t::Op53, &eZ80t::Opx54, &eZ80t::Opx55,
+                    &eZ80t::Opx56, &eZ80t::Op57,
+                    &eZ80t::Op58, &eZ80t::Op59, &eZ80t::Op5A, &eZ80t::Op5B, &eZ80t::Opx5C, &eZ80t::Opx5D,
+                    &eZ80t::Opx5E, &eZ80t::Op5F,
+                    &eZ80t::Opx60, &eZ80t::Opx61, &eZ80t::Opx62, &eZ80t::Opx63, &eZ80t::Op64, &eZ80t::Opx65,
+                    &eZ80t::Opx66, &eZ80t::Opx67,
+                    &eZ80t::Opx68, &eZ80t::Opx69, &eZ80t::Opx6A, &eZ80t::Opx6B, &eZ80t::Opx6C, &eZ80t::Op6D,
+                    &eZ80t::Opx6E, &eZ80t::Opx6F,
+                    &eZ80t::Opx70, &eZ80t::Opx71, &eZ80t::Opx72, &eZ80t::Opx73, &eZ80t::Opx74, &eZ80t::Opx75,
+                    &eZ80t::Op76, &eZ80t::Opx77,
+                    &eZ80t::Op78, &eZ80t::Op79, &eZ80t::Op7A, &eZ80t::Op7B, &eZ80t::Opx7C, &eZ80t::Opx7D,
+                    &eZ80t::Opx7E, &eZ80t::Op7F,
+
+                    &eZ80t::Op80, &eZ80t::Op81, &eZ80t::Op82, &eZ80t::Op83, &eZ80t::Opx84, &eZ80t::Opx85,
+                    &eZ80t::Opx86, &eZ80t::Op87,
+                    &eZ80t::Op88, &eZ80t::Op89, &eZ80t::Op8A, &eZ80t::Op8B, &eZ80t::Opx8C, &eZ80t::Opx8D,
+                    &eZ80t::Opx8E, &eZ80t::Op8F,
+                    &eZ80t::Op90, &eZ80t::Op91, &eZ80t::Op92, &eZ80t::Op93, &eZ80t::Opx94, &eZ80t::Opx95,
+                    &eZ80t::Opx96, &eZ80t::Op97,
+                    &eZ80t::Op98, &eZ80t::Op99, &eZ80t::Op9A, &eZ80t::Op9B, &eZ80t::Opx9C, &eZ80t::Opx9D,
+                    &eZ80t::Opx9E, &eZ80t::Op9F,
+                    &eZ80t::OpA0, &eZ80t::OpA1, &eZ80t::OpA2, &eZ80t::OpA3, &eZ80t::OpxA4, &eZ80t::OpxA5,
+                    &eZ80t::OpxA6, &eZ80t::OpA7,
+                    &eZ80t::OpA8, &eZ80t::OpA9, &eZ80t::OpAA, &eZ80t::OpAB, &eZ80t::OpxAC, &eZ80t::OpxAD,
+                    &eZ80t::OpxAE, &eZ80t::OpAF,
+                    &eZ80t::OpB0, &eZ80t::OpB1, &eZ80t::OpB2, &eZ80t::OpB3, &eZ80t::OpxB4, &eZ80t::OpxB5,
+                    &eZ80t::OpxB6, &eZ80t::OpB7,
+                    &eZ80t::OpB8, &eZ80t::OpB9, &eZ80t::OpBA, &eZ80t::OpBB, &eZ80t::OpxBC, &eZ80t::OpxBD,
+                    &eZ80t::OpxBE, &eZ80t::OpBF,
+
+                    &eZ80t::OpC0, &eZ80t::OpC1, &eZ80t::OpC2, &eZ80t::OpC3, &eZ80t::OpC4, &eZ80t::OpC5,
+                    &eZ80t::OpC6, &eZ80t::OpC7,
+                    &eZ80t::OpC8, &eZ80t::OpC9, &eZ80t::OpCA, &eZ80t::OpCB, &eZ80t::OpCC, &eZ80t::OpCD,
+                    &eZ80t::OpCE, &eZ80t::OpCF,
+                    &eZ80t::OpD0, &eZ80t::OpD1, &eZ80t::OpD2, &eZ80t::OpD3, &eZ80t::OpD4, &eZ80t::OpD5,
+                    &eZ80t::OpD6, &eZ80t::OpD7,
+                    &eZ80t::OpD8, &eZ80t::OpD9, &eZ80t::OpDA, &eZ80t::OpDB, &eZ80t::OpDC, &eZ80t::OpDD,
+                    &eZ80t::OpDE, &eZ80t::OpDF,
+                    &eZ80t::OpE0, &eZ80t::OpxE1, &eZ80t::OpE2, &eZ80t::OpxE3, &eZ80t::OpE4, &eZ80t::OpxE5,
+                    &eZ80t::OpE6, &eZ80t::OpE7,
+                    &eZ80t::OpE8, &eZ80t::OpxE9, &eZ80t::OpEA, &eZ80t::OpEB, &eZ80t::OpEC, &eZ80t::OpED,
+                    &eZ80t::OpEE, &eZ80t::OpEF,
+                    &eZ80t::OpF0, &eZ80t::OpF1, &eZ80t::OpF2, &eZ80t::OpF3, &eZ80t::OpF4, &eZ80t::OpF5,
+                    &eZ80t::OpF6, &eZ80t::OpF7,
+                    &eZ80t::OpF8, &eZ80t::OpxF9, &eZ80t::OpFA, &eZ80t::OpFB, &eZ80t::OpFC, &eZ80t::OpFD,
+                    &eZ80t::OpFE, &eZ80t::OpFF
+            };
+
+    const eZ80t::CALLFUNC eZ80t::opedcodes[] =
+            {
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+
+                    &eZ80t::Ope40, &eZ80t::Ope41, &eZ80t::Ope42, &eZ80t::Ope43, &eZ80t::Ope44, &eZ80t::Ope45,
+                    &eZ80t::Ope46, &eZ80t::Ope47,
+                    &eZ80t::Ope48, &eZ80t::Ope49, &eZ80t::Ope4A, &eZ80t::Ope4B, &eZ80t::Ope4C, &eZ80t::Ope4D,
+                    &eZ80t::Ope4E, &eZ80t::Ope4F,
+                    &eZ80t::Ope50, &eZ80t::Ope51, &eZ80t::Ope52, &eZ80t::Ope53, &eZ80t::Ope54, &eZ80t::Ope55,
+                    &eZ80t::Ope56, &eZ80t::Ope57,
+                    &eZ80t::Ope58, &eZ80t::Ope59, &eZ80t::Ope5A, &eZ80t::Ope5B, &eZ80t::Ope5C, &eZ80t::Ope5D,
+                    &eZ80t::Ope5E, &eZ80t::Ope5F,
+                    &eZ80t::Ope60, &eZ80t::Ope61, &eZ80t::Ope62, &eZ80t::Ope63, &eZ80t::Ope64, &eZ80t::Ope65,
+                    &eZ80t::Ope66, &eZ80t::Ope67,
+                    &eZ80t::Ope68, &eZ80t::Ope69, &eZ80t::Ope6A, &eZ80t::Ope6B, &eZ80t::Ope6C, &eZ80t::Ope6D,
+                    &eZ80t::Ope6E, &eZ80t::Ope6F,
+                    &eZ80t::Ope70, &eZ80t::Ope71, &eZ80t::Ope72, &eZ80t::Ope73, &eZ80t::Ope74, &eZ80t::Ope75,
+                    &eZ80t::Ope76, &eZ80t::Ope77,
+                    &eZ80t::Ope78, &eZ80t::Ope79, &eZ80t::Ope7A, &eZ80t::Ope7B, &eZ80t::Ope7C, &eZ80t::Ope7D,
+                    &eZ80t::Ope7E, &eZ80t::Ope7F,
+
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::OpeA0, &eZ80t::OpeA1, &eZ80t::OpeA2, &eZ80t::OpeA3, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::OpeA8, &eZ80t::OpeA9, &eZ80t::OpeAA, &eZ80t::OpeAB, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::OpeB0, &eZ80t::OpeB1, &eZ80t::OpeB2, &eZ80t::OpeB3, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::OpeB8, &eZ80t::OpeB9, &eZ80t::OpeBA, &eZ80t::OpeBB, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
+                    &eZ80t::Op00, &eZ80t::Op00
+            };
+
+    // === peephole pass over each op handler before it is printed
+    //
+    // the emitters are written one z80 operation at a time, so a handler is full of values shuffled into r0 and back,
+    // re-extended bytes and re-loaded literals. this is a conservative clean up on the emitted text: anything not
+    // understood (calls, branches, macros, preprocessor lines) is a barrier with every register and the flags live,
+    // since the helpers take arguments and return results in both. define NO_Z80T_PEEPHOLE to see the raw output
+
+    enum {
+        LINE_NONE, // blank or comment
+        LINE_LABEL,
+        LINE_BARRIER,
+        LINE_BRANCH, // conditional branch; fall through keeps what we know
+        LINE_INSN,
+    };
+
+    struct asm_line {
+        std::string text;
+        std::string op;
+        std::vector<std::string> args;
+        std::string comment;
+        int kind;
+        int dst;        // register written, or -1
+        uint32_t defs;  // all registers written
+        uint32_t clobbers; // registers which may be written (as well as defs)
+        uint32_t uses;  // all registers read
+        int flags;      // FLAGS_ bits
+        bool flags_live_out;
+    };
+
+    enum {
+        FLAGS_READ = 1,
+        FLAGS_SET = 2,  // some of nzcv
+        FLAGS_KILL = 4, // all of nzcv
+    };
+
+    static const uint32_t ALL_REGS = 0xffff;
+
+    // handlers reached only through the op tables from the step loop have nothing looking at flags after they return
+    static bool flags_live_at_return;
+
+    static bool is_return(const asm_line &l) {
+        return (l.op == "bx" && l.args.size() == 1 && l.args[0] == "lr") ||
+               (l.op == "pop" && l.args.size() == 1 && l.args[0].find("pc") != std::string::npos);
+    }
+
+    static struct {
+        int removed_moves;
+        int removed_extends;
+        int removed_literals;
+        int removed_dead;
+        int fused;
+        int propagated;
+        int insns_before, insns_after;
+        int cycles_before, cycles_after;
+    } peephole_stats;
+
+    static int parse_reg(const std::string &s) {
+        static const struct { const char *name; int reg; } aliases[] = {
+                {"r_temp_restricted", 2}, {"r_temp", 3}, {"r_ixy", 3}, {"r_pc", 4}, {"memory", 5}, {"interp_base", 5},
+                {"r_t", 6}, {"r_af", 7}, {"r_bc", 8}, {"r_de", 9}, {"r_hl", 10}, {"r_memptr", 11}, {"r_sp", 12},
+                {"sp", 13}, {"lr", 14}, {"pc", 15},
+        };
+        if (s.size() >= 2 && s.size() <= 3 && s[0] == 'r' && isdigit(s[1]) && (s.size() == 2 || isdigit(s[2]))) {
+            int r = atoi(s.c_str() + 1);
+            return r < 16 ? r : -1;
+        }
+        for(const auto &a : aliases) {
+            if (s == a.name) return a.reg;
+        }
+        return -1;
+    }
+
+    static std::string trim(const std::string &s) {
+        size_t b = s.find_first_not_of(" \t");
+        if (b == std::string::npos) return "";
+        return s.substr(b, s.find_last_not_of(" \t") + 1 - b);
+    }
+
+    static bool is_lo(int reg) {
+        return reg >= 0 && reg < 8;
+    }
+
+    static bool is_one_of(const std::string &s, std::initializer_list<const char *> names) {
+        for(const char *n : names) {
+            if (s == n) return true;
+        }
+        return false;
+    }
+
+    // registers read inside a [base, offset] operand; false if something there isn't understood
+    static bool parse_address(const std::string &arg, uint32_t &uses) {
+        std::string inner = arg.substr(1, arg.find(']') - 1);
+        size_t start = 0;
+        do {
+            size_t comma = inner.find(',', start);
+            std::string part = trim(inner.substr(start, comma == std::string::npos ? std::string::npos : comma - start));
+            if (part[0] != '#') {
+                int r = parse_reg(part);
+                if (r < 0) return false;
+                uses |= 1u << r;
+            }
+            start = comma == std::string::npos ? comma : comma + 1;
+        } while (start != std::string::npos);
+        return true;
+    }
+
+    // work out what an instruction reads and writes; anything we don't know is left a barrier
+    static void classify(asm_line &l) {
+        l.dst = -1;
+        l.defs = l.uses = l.clobbers = 0;
+        l.flags = 0;
+        if (is_one_of(l.op, {"beq", "bne", "bcs", "bcc", "bhs", "blo", "bmi", "bpl", "bvs", "bvc", "bhi", "bls", "bge", "blt", "bgt", "ble"})) {
+            l.kind = LINE_BRANCH;
+            l.flags = FLAGS_READ;
+            return;
+        }
+        l.kind = LINE_BARRIER;
+        int n = (int)l.args.size();
+        if (!n) return;
+        int r[3];
+        for(int i = 0; i < 3; i++) {
+            r[i] = i < n ? parse_reg(l.args[i]) : -1;
+        }
+        auto reg_or_imm = [&](int i) {
+            if (l.args[i][0] == '#') return true;
+            if (r[i] < 0) return false;
+            l.uses |= 1u << r[i];
+            return true;
+        };
+        if (r[0] < 0 || r[0] >= 13) return;
+        if (l.op == "read8_internal") {
+            // ldrb r0, [memory, reg] (banked memory access also clobbers r1)
+            l.dst = 0;
+            l.defs = 1;
+            l.clobbers = 2;
+            l.uses = (1u << r[0]) | (1u << 5);
+            l.flags = FLAGS_SET; // with ENABLE_64K_ADDRESS_CHECK
+            l.kind = LINE_INSN;
+            return;
+        }
+        if (l.op == "preserve_only_flags") {
+            // movs reg, #~flags; bics r_af, reg
+            l.dst = r[0];
+            l.defs = (1u << r[0]) | (1u << 7);
+            l.uses = 1u << 7;
+            l.flags = FLAGS_SET;
+            l.kind = LINE_INSN;
+            return;
+        }
+        if (is_one_of(l.op, {"ldr", "ldrb", "ldrh", "ldrsb", "ldrsh", "str", "strb", "strh"})) {
+            if (n != 2) return;
+            if (l.args[1][0] == '[') {
+                if (!parse_address(l.args[1], l.uses)) return;
+            } else if (l.op != "ldr") {
+                return;
+            }
+            if (l.op[0] == 'l') {
+                l.dst = r[0];
+            } else {
+                l.uses |= 1u << r[0];
+            }
+        } else if (is_one_of(l.op, {"cmp", "cmn", "tst"})) {
+            if (n != 2) return;
+            l.uses |= 1u << r[0];
+            if (!reg_or_imm(1)) return;
+        } else if (is_one_of(l.op, {"mov", "movs", "mvns", "negs", "uxtb", "uxth", "sxtb", "sxth", "rev", "rev16", "revsh"})) {
+            if (n != 2 || !reg_or_imm(1)) return;
+            if (l.op == "mov" && l.args[1][0] == '#') return;
+            l.dst = r[0];
+        } else if (is_one_of(l.op, {"adds", "subs", "adcs", "sbcs", "ands", "orrs", "eors", "bics", "lsls", "lsrs", "asrs", "rors", "muls", "rsbs", "add", "sub"})) {
+            if (n == 2) {
+                l.uses |= 1u << r[0];
+                if (!reg_or_imm(1)) return;
+            } else if (n == 3) {
+                if (r[1] < 0) return;
+                l.uses |= 1u << r[1];
+                if (!reg_or_imm(2)) return;
+            } else {
+                return;
+            }
+            l.dst = r[0];
+        } else {
+            return;
+        }
+        if (l.dst >= 13) return;
+        if (l.dst >= 0) l.defs = 1u << l.dst;
+        if (is_one_of(l.op, {"adds", "subs", "adcs", "sbcs", "negs", "rsbs", "cmp", "cmn"})) {
+            l.flags = FLAGS_SET | FLAGS_KILL;
+        } else if (l.op.back() == 's' || l.op == "tst") {
+            l.flags = FLAGS_SET;
+        }
+        if (l.op == "adcs" || l.op == "sbcs") l.flags |= FLAGS_READ;
+        l.kind = LINE_INSN;
+    }
+
+    static void parse_line(asm_line &l) {
+        l.op.clear();
+        l.args.clear();
+        l.comment.clear();
+        l.dst = -1;
+        l.defs = l.uses = l.clobbers = 0;
+        l.flags = 0;
+        std::string s = l.text;
+        size_t c = s.find("//");
+        if (c != std::string::npos) {
+            l.comment = s.substr(c);
+            s = s.substr(0, c);
+        }
+        s = trim(s);
+        if (s.empty()) {
+            l.kind = LINE_NONE;
+            return;
+        }
+        if (s.back() == ':') {
+            l.kind = LINE_LABEL;
+            return;
+        }
+        l.kind = LINE_BARRIER;
+        if (s[0] == '.' || s[0] == '#') return;
+        size_t sp = s.find_first_of(" \t");
+        l.op = s.substr(0, sp);
+        if (sp != std::string::npos) {
+            std::string rest = trim(s.substr(sp));
+            int depth = 0;
+            size_t start = 0;
+            for(size_t i = 0; i <= rest.size(); i++) {
+                if (i == rest.size() || (rest[i] == ',' && !depth)) {
+                    l.args.push_back(trim(rest.substr(start, i - start)));
+                    start = i + 1;
+                } else if (rest[i] == '[' || rest[i] == '(' || rest[i] == '{') {
+                    depth++;
+                } else if (rest[i] == ']' || rest[i] == ')' || rest[i] == '}') {
+                    depth--;
+                }
+            }
+        }
+        classify(l);
+    }
+
+    static void set_line(asm_line &l, const std::string &op, const std::vector<std::string> &args) {
+        std::string text = "\t" + op + "  ";
+        for(size_t i = 0; i < args.size(); i++) {
+            if (i) text += ", ";
+            text += args[i];
+        }
+        if (!l.comment.empty()) {
+            text += "\t\t" + l.comment;
+        }
+        l.text = text;
+        parse_line(l);
+    }
+
+    // replace reads of register from by to (which is spelled to_name) in an operand
+    static std::string substitute_reg(const std::string &arg, int from, const std::string &to_name) {
+        std::string out;
+        for(size_t i = 0; i < arg.size();) {
+            if (isalpha(arg[i]) || arg[i] == '_') {
+                size_t j = i;
+                while (j < arg.size() && (isalnum(arg[j]) || arg[j] == '_')) j++;
+                std::string word = arg.substr(i, j - i);
+                out += parse_reg(word) == from ? to_name : word;
+                i = j;
+            } else {
+                out += arg[i++];
+            }
+        }
+        return out;
+    }
+
+    static int imm_value(const std::string &arg) {
+        if (arg.size() < 2 || arg[0] != '#') return -1;
+        char *end;
+        long v = strtol(arg.c_str() + 1, &end, 0);
+        return *end ? -1 : (int)v;
+    }
+
+    // instructions and cycles on a cortex m0+, counting branches as taken; macros are counted as what they
+    // expand to in the default configuration, and #if'd alternatives are both counted
+    static void cost(const std::vector<asm_line> &lines, int &insns, int &cycles) {
+        insns = cycles = 0;
+        for(const auto &l : lines) {
+            if (l.kind == LINE_NONE || l.kind == LINE_LABEL || l.op.empty()) continue;
+            int i = 1, c = 1;
+            if (l.op == "preserve_only_flags") {
+                i = c = 2;
+            } else if (l.op == "read8_internal" || l.op.compare(0, 3, "ldr") == 0 || l.op.compare(0, 3, "str") == 0) {
+                c = 2;
+            } else if (l.op == "push" || l.op == "pop") {
+                // 1 + registers, popping pc is another 2
+                c = 2;
+                for(char ch : l.args[0]) c += ch == ',';
+                if (l.args[0].find("pc") != std::string::npos) c += 2;
+            } else if (l.op == "bl") {
+                c = 3;
+            } else if (l.kind == LINE_BRANCH || l.op == "b" || l.op == "bx" || l.op == "blx") {
+                c = 2;
+            }
+            insns += i;
+            cycles += c;
+        }
+    }
+
+    static void flag_liveness(std::vector<asm_line> &lines) {
+        bool live = true;
+        for(int i = (int)lines.size() - 1; i >= 0; i--) {
+            auto &l = lines[i];
+            l.flags_live_out = live;
+            if (l.kind == LINE_BARRIER) {
+                live = !is_return(l) || flags_live_at_return;
+            } else if (l.kind != LINE_NONE) {
+                if (l.flags & FLAGS_KILL) live = false;
+                if (l.flags & FLAGS_READ) live = true;
+            }
+        }
+    }
+
+    static bool peephole_forward(std::vector<asm_line> &lines) {
+        bool changed = false;
+        flag_liveness(lines);
+        int cls[16], zx[16];
+        std::string lit[16];
+        int next_cls = 0;
+        auto forget = [&](int r) {
+            cls[r] = next_cls++;
+            zx[r] = 32;
+            lit[r].clear();
+        };
+        auto forget_all = [&]() {
+            for(int r = 0; r < 16; r++) forget(r);
+        };
+        forget_all();
+        for(auto &l : lines) {
+            if (l.kind == LINE_NONE || l.kind == LINE_BRANCH) continue;
+            if (l.kind != LINE_INSN) {
+                forget_all();
+                if (l.op == "bl" && l.args.size() == 1) {
+                    // the memory read helpers zero extend their result
+                    if (is_one_of(l.args[0], {"read8", "read8inc"})) zx[0] = 8;
+                    if (is_one_of(l.args[0], {"read16", "read16inc"})) zx[0] = 16;
+                }
+                continue;
+            }
+            int d = l.dst;
+            int s = l.args.size() == 2 ? parse_reg(l.args[1]) : -1;
+            if (l.op == "mov" && s >= 0) {
+                if (cls[d] == cls[s]) {
+                    l.kind = LINE_NONE;
+                    peephole_stats.removed_moves++;
+                    changed = true;
+                    continue;
+                }
+                cls[d] = cls[s];
+                zx[d] = zx[s];
+                lit[d] = lit[s];
+                continue;
+            }
+            if ((l.op == "uxtb" || l.op == "uxth") && s >= 0) {
+                int width = l.op == "uxtb" ? 8 : 16;
+                if (zx[s] <= width) {
+                    if (cls[d] == cls[s]) {
+                        l.kind = LINE_NONE;
+                        peephole_stats.removed_extends++;
+                        changed = true;
+                        continue;
+                    }
+                    cls[d] = cls[s];
+                    zx[d] = zx[s];
+                    lit[d] = lit[s];
+                    continue;
+                }
+                forget(d);
+                zx[d] = width;
+                continue;
+            }
+            if (l.op == "ldr" && l.args[1][0] == '=') {
+                if (lit[d] == l.args[1]) {
+                    l.kind = LINE_NONE;
+                    peephole_stats.removed_literals++;
+                    changed = true;
+                    continue;
+                }
+                forget(d);
+                for(int r = 0; r < 16; r++) {
+                    if (r != d && lit[r] == l.args[1]) cls[d] = cls[r];
+                }
+                lit[d] = l.args[1];
+                continue;
+            }
+            if (l.op == "movs" && l.args[1][0] == '#') {
+                if (lit[d] == l.args[1] && !l.flags_live_out) {
+                    l.kind = LINE_NONE;
+                    peephole_stats.removed_literals++;
+                    changed = true;
+                    continue;
+                }
+                forget(d);
+                lit[d] = l.args[1];
+            } else {
+                for(int r = 0; r < 16; r++) {
+                    if ((l.defs | l.clobbers) & (1u << r)) forget(r);
+                }
+            }
+            if (d >= 0) {
+                int shift = imm_value(l.args.back());
+                if (l.op == "ldrb" || l.op == "read8_internal") {
+                    zx[d] = 8;
+                } else if (l.op == "ldrh") {
+                    zx[d] = 16;
+                } else if (l.op == "movs" && shift >= 0 && shift < 256) {
+                    zx[d] = 8;
+                } else if (l.op == "lsrs" && shift >= 16) {
+                    zx[d] = shift >= 24 ? 8 : 16;
+                }
+            }
+        }
+        return changed;
+    }
+
+    static bool peephole_backward(std::vector<asm_line> &lines) {
+        bool changed = false;
+        // registers live after each line
+        std::vector<uint32_t> live_out(lines.size());
+        uint32_t live = ALL_REGS;
+        bool flags_live = true;
+        for(int i = (int)lines.size() - 1; i >= 0; i--) {
+            auto &l = lines[i];
+            live_out[i] = live;
+            if (l.kind == LINE_NONE || l.kind == LINE_LABEL) continue;
+            if (l.kind != LINE_INSN) {
+                live = ALL_REGS;
+                flags_live = l.kind == LINE_BRANCH || !is_return(l) || flags_live_at_return;
+                continue;
+            }
+            // a register move/extend/literal or an alu op whose flags nobody looks at, with its result unused
+            bool pure = l.op == "mov" || (l.op == "ldr" && l.args[1][0] == '=') ||
+                        is_one_of(l.op, {"uxtb", "uxth", "sxtb", "sxth"}) ||
+                        (l.flags & FLAGS_SET && !flags_live && l.dst >= 0 && l.op.compare(0, 3, "ldr") &&
+                         l.op != "read8_internal" && l.op != "preserve_only_flags");
+            if (pure && !(live & l.defs)) {
+                l.kind = LINE_NONE;
+                peephole_stats.removed_dead++;
+                changed = true;
+                continue;
+            }
+            live = (live & ~l.defs) | l.uses;
+            if (l.flags & FLAGS_KILL) flags_live = false;
+            if (l.flags & FLAGS_READ) flags_live = true;
+        }
+        // now look at a move and the instruction straight after it
+        for(size_t i = 0; i + 1 < lines.size(); i++) {
+            auto &m = lines[i];
+            auto &l = lines[i + 1];
+            if (m.kind != LINE_INSN || m.op != "mov" || l.kind != LINE_INSN) continue;
+            // macro operands aren't plain reads
+            if (l.op == "read8_internal" || l.op == "preserve_only_flags") continue;
+            int d = m.dst;
+            int s = parse_reg(m.args[1]);
+            if (s < 0 || s >= 13) continue;
+            if (l.dst == d && l.args.size() == 2 && is_lo(d) && is_lo(s) && !(l.uses & (1u << s) & ~(1u << d))) {
+                // mov d, s; op d, #n -> op d, s, #n
+                int imm = imm_value(l.args[1]);
+                bool fuse = false;
+                std::vector<std::string> args = {l.args[0], m.args[1]};
+                if (is_one_of(l.op, {"lsls", "lsrs", "asrs"}) && imm >= 0) {
+                    fuse = true;
+                    args.push_back(l.args[1]);
+                } else if (is_one_of(l.op, {"adds", "subs"}) && imm >= 0 && imm < 8) {
+                    fuse = true;
+                    args.push_back(l.args[1]);
+                } else if (is_one_of(l.op, {"uxtb", "uxth", "sxtb", "sxth"}) && parse_reg(l.args[1]) == d) {
+                    fuse = true;
+                }
+                if (fuse) {
+                    set_line(l, l.op, args);
+                    m.kind = LINE_NONE;
+                    peephole_stats.fused++;
+                    changed = true;
+                    continue;
+                }
+            }
+            if ((l.uses & (1u << d)) && !((l.defs | l.clobbers) & (1u << d)) && !(live_out[i + 1] & (1u << d))) {
+                // mov d, s; op x, d (and d not needed after) -> op x, s
+                if (!is_lo(s) && !(is_one_of(l.op, {"mov", "cmp"}) || (l.op == "add" && l.args.size() == 2))) continue;
+                std::vector<std::string> args;
+                for(const auto &a : l.args) {
+                    args.push_back(&a == &l.args[0] && l.dst >= 0 ? a : substitute_reg(a, d, m.args[1]));
+                }
+                set_line(l, l.op, args);
+                m.kind = LINE_NONE;
+                peephole_stats.propagated++;
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    void eZ80t::dump_function(const char *name, bool table_dispatch_only) {
+        flags_live_at_return = !table_dispatch_only;
+        std::vector<asm_line> lines;
+        for(const auto &text : *function_lines) {
+            asm_line l;
+            l.text = text;
+            parse_line(l);
+            lines.push_back(l);
+        }
+        int insns_before, cycles_before;
+        cost(lines, insns_before, cycles_before);
+#ifndef NO_Z80T_PEEPHOLE
+        bool changed;
+        do {
+            changed = peephole_forward(lines);
+            changed |= peephole_backward(lines);
+            std::vector<asm_line> kept;
+            for(auto &l : lines) {
+                // dropped instructions are left as LINE_NONE with their text
+                if (l.kind != LINE_NONE || l.op.empty()) kept.push_back(l);
+            }
+            lines.swap(kept);
+        } while (changed);
+#endif
+        int insns_after, cycles_after;
+        cost(lines, insns_after, cycles_after);
+        peephole_stats.insns_before += insns_before;
+        peephole_stats.insns_after += insns_after;
+        peephole_stats.cycles_before += cycles_before;
+        peephole_stats.cycles_after += cycles_after;
+        if (report) {
+            fprintf(report, "%-24s %4d insns %4d cycles -> %4d insns %4d cycles\n", name, insns_before, cycles_before, insns_after, cycles_after);
+        }
+        function_lines = NULL;
+        for(const auto &l : lines) {
+            emit(l.text.c_str());
+        }
+    }
+
+    void eZ80t::generate_arm(FILE *report) {
+        eZ80t::report = report;
+        memset(&peephole_stats, 0, sizeof(peephole_stats));
         emit("// ================================");
         emit("// == AUTOGENERATED: DO NOT EDIT ==");
         emit("// ================================");
@@ -153,76 +906,6 @@ namespace Z80t
         emit("// ALWAYS DIFF THIS CODE AFTER GENERATION - SENSITVE TO COMPILER VERSION CHANGES!");
         emit("");
 
-        const CALLFUNC opcodes[] =
-                {
-                        &eZ80t::Op00, &eZ80t::Op01, &eZ80t::Op02, &eZ80t::Op03, &eZ80t::Op04, &eZ80t::Op05,
-                        &eZ80t::Op06, &eZ80t::Op07,
-                        &eZ80t::Op08, &eZ80t::Op09, &eZ80t::Op0A, &eZ80t::Op0B, &eZ80t::Op0C, &eZ80t::Op0D,
-                        &eZ80t::Op0E, &eZ80t::Op0F,
-                        &eZ80t::Op10, &eZ80t::Op11, &eZ80t::Op12, &eZ80t::Op13, &eZ80t::Op14, &eZ80t::Op15,
-                        &eZ80t::Op16, &eZ80t::Op17,
-                        &eZ80t::Op18, &eZ80t::Op19, &eZ80t::Op1A, &eZ80t::Op1B, &eZ80t::Op1C, &eZ80t::Op1D,
-                        &eZ80t::Op1E, &eZ80t::Op1F,
-                        &eZ80t::Op20, &eZ80t::Op21, &eZ80t::Op22, &eZ80t::Op23, &eZ80t::Op24, &eZ80t::Op25,
-                        &eZ80t::Op26, &eZ80t::Op27,
-                        &eZ80t::Op28, &eZ80t::Op29, &eZ80t::Op2A, &eZ80t::Op2B, &eZ80t::Op2C, &eZ80t::Op2D,
-                        &eZ80t::Op2E, &eZ80t::Op2F,
-                        &eZ80t::Op30, &eZ80t::Op31, &eZ80t::Op32, &eZ80t::Op33, &eZ80t::Op34, &eZ80t::Op35,
-                        &eZ80t::Op36, &eZ80t::Op37,
-                        &eZ80t::Op38, &eZ80t::Op39, &eZ80t::Op3A, &eZ80t::Op3B, &eZ80t::Op3C, &eZ80t::Op3D,
-                        &eZ80t::Op3E, &eZ80t::Op3F,
-
-                        &eZ80t::Op40, &eZ80t::Op41, &eZ80t::Op42, &eZ80t::Op43, &eZ80t::Op44, &eZ80t::Op45,
-                        &eZ80t::Op46, &eZ80t::Op47,
-                        &eZ80t::Op48, &eZ80t::Op49, &eZ80t::Op4A, &eZ80t::Op4B, &eZ80t::Op4C, &eZ80t::Op4D,
-                        &eZ80t::Op4E, &eZ80t::Op4F,
-                        &eZ80t::Op50, &eZ80t::Op51, &eZ80t::Op52, &eZ80t::Op53, &eZ80t::Op54, &eZ80t::Op55,
-                        &eZ80t::Op56, &eZ80t::Op57,
-                        &eZ80t::Op58, &eZ80t::Op59, &eZ80t::Op5A, &eZ80t::Op5B, &eZ80t::Op5C, &eZ80t::Op5D,
-                        &eZ80t::Op5E, &eZ80t::Op5F,
-                        &eZ80t::Op60, &eZ80t::Op61, &eZ80t::Op62, &eZ80t::Op63, &eZ80t::Op64, &eZ80t::Op65,
-                        &eZ80t::Op66, &eZ80t::Op67,
-                        &eZ80t::Op68, &eZ80t::Op69, &eZ80t::Op6A, &eZ80t::Op6B, &eZ80t::Op6C, &eZ80t::Op6D,
-                        &eZ80t::Op6E, &eZ80t::Op6F,
-                        &eZ80t::Op70, &eZ80t::Op71, &eZ80t::Op72, &eZ80t::Op73, &eZ80t::Op74, &eZ80t::Op75,
-                        &eZ80t::Op76, &eZ80t::Op77,
-                        &eZ80t::Op78, &eZ80t::Op79, &eZ80t::Op7A, &eZ80t::Op7B, &eZ80t::Op7C, &eZ80t::Op7D,
-                        &eZ80t::Op7E, &eZ80t::Op7F,
-
-                        &eZ80t::Op80, &eZ80t::Op81, &eZ80t::Op82, &eZ80t::Op83, &eZ80t::Op84, &eZ80t::Op85,
-                        &eZ80t::Op86, &eZ80t::Op87,
-                        &eZ80t::Op88, &eZ80t::Op89, &eZ80t::Op8A, &eZ80t::Op8B, &eZ80t::Op8C, &eZ80t::Op8D,
-                        &eZ80t::Op8E, &eZ80t::Op8F,
-                        &eZ80t::Op90, &eZ80t::Op91, &eZ80t::Op92, &eZ80t::Op93, &eZ80t::Op94, &eZ80t::Op95,
-                        &eZ80t::Op96, &eZ80t::Op97,
-                        &eZ80t::Op98, &eZ80t::Op99, &eZ80t::Op9A, &eZ80t::Op9B, &eZ80t::Op9C, &eZ80t::Op9D,
-                        &eZ80t::Op9E, &eZ80t::Op9F,
-                        &eZ80t::OpA0, &eZ80t::OpA1, &eZ80t::OpA2, &eZ80t::OpA3, &eZ80t::OpA4, &eZ80t::OpA5,
-                        &eZ80t::OpA6, &eZ80t::OpA7,
-                        &eZ80t::OpA8, &eZ80t::OpA9, &eZ80t::OpAA, &eZ80t::OpAB, &eZ80t::OpAC, &eZ80t::OpAD,
-                        &eZ80t::OpAE, &eZ80t::OpAF,
-                        &eZ80t::OpB0, &eZ80t::OpB1, &eZ80t::OpB2, &eZ80t::OpB3, &eZ80t::OpB4, &eZ80t::OpB5,
-                        &eZ80t::OpB6, &eZ80t::OpB7,
-                        &eZ80t::OpB8, &eZ80t::OpB9, &eZ80t::OpBA, &eZ80t::OpBB, &eZ80t::OpBC, &eZ80t::OpBD,
-                        &eZ80t::OpBE, &eZ80t::OpBF,
-
-                        &eZ80t::OpC0, &eZ80t::OpC1, &eZ80t::OpC2, &eZ80t::OpC3, &eZ80t::OpC4, &eZ80t::OpC5,
-                        &eZ80t::OpC6, &eZ80t::OpC7,
-                        &eZ80t::OpC8, &eZ80t::OpC9, &eZ80t::OpCA, &eZ80t::OpCB, &eZ80t::OpCC, &eZ80t::OpCD,
-                        &eZ80t::OpCE, &eZ80t::OpCF,
-                        &eZ80t::OpD0, &eZ80t::OpD1, &eZ80t::OpD2, &eZ80t::OpD3, &eZ80t::OpD4, &eZ80t::OpD5,
-                        &eZ80t::OpD6, &eZ80t::OpD7,
-                        &eZ80t::OpD8, &eZ80t::OpD9, &eZ80t::OpDA, &eZ80t::OpDB, &eZ80t::OpDC, &eZ80t::OpDD,
-                        &eZ80t::OpDE, &eZ80t::OpDF,
-                        &eZ80t::OpE0, &eZ80t::OpE1, &eZ80t::OpE2, &eZ80t::OpE3, &eZ80t::OpE4, &eZ80t::OpE5,
-                        &eZ80t::OpE6, &eZ80t::OpE7,
-                        &eZ80t::OpE8, &eZ80t::OpE9, &eZ80t::OpEA, &eZ80t::OpEB, &eZ80t::OpEC, &eZ80t::OpED,
-                        &eZ80t::OpEE, &eZ80t::OpEF,
-                        &eZ80t::OpF0, &eZ80t::OpF1, &eZ80t::OpF2, &eZ80t::OpF3, &eZ80t::OpF4, &eZ80t::OpF5,
-                        &eZ80t::OpF6, &eZ80t::OpF7,
-                        &eZ80t::OpF8, &eZ80t::OpF9, &eZ80t::OpFA, &eZ80t::OpFB, &eZ80t::OpFC, &eZ80t::OpFD,
-                        &eZ80t::OpFE, &eZ80t::OpFF
-                };
         dump_instructions("op", opcodes, count_of(opcodes), "top level opcodes");
 
         const CALLFUNC oplscodes[] = {
@@ -341,152 +1024,156 @@ namespace Z80t
         dump_instructions("opl", oplcodes, count_of(oplcodes), "cb logic opcodes");
 #endif
 
-        CALLFUNC const opddcodes[] =
-                {
-                        &eZ80t::Op00, &eZ80t::Op01, &eZ80t::Op02, &eZ80t::Op03, &eZ80t::Op04, &eZ80t::Op05,
-                        &eZ80t::Op06, &eZ80t::Op07,
-                        &eZ80t::Op08, &eZ80t::Opx09, &eZ80t::Op0A, &eZ80t::Op0B, &eZ80t::Op0C, &eZ80t::Op0D,
-                        &eZ80t::Op0E, &eZ80t::Op0F,
-                        &eZ80t::Op10, &eZ80t::Op11, &eZ80t::Op12, &eZ80t::Op13, &eZ80t::Op14, &eZ80t::Op15,
-                        &eZ80t::Op16, &eZ80t::Op17,
-                        &eZ80t::Op18, &eZ80t::Opx19, &eZ80t::Op1A, &eZ80t::Op1B, &eZ80t::Op1C, &eZ80t::Op1D,
-                        &eZ80t::Op1E, &eZ80t::Op1F,
-                        &eZ80t::Op20, &eZ80t::Opx21, &eZ80t::Opx22, &eZ80t::Opx23, &eZ80t::Opx24, &eZ80t::Opx25,
-                        &eZ80t::Opx26, &eZ80t::Op27,
-                        &eZ80t::Op28, &eZ80t::Opx29, &eZ80t::Opx2A, &eZ80t::Opx2B, &eZ80t::Opx2C, &eZ80t::Opx2D,
-                        &eZ80t::Opx2E, &eZ80t::Op2F,
-                        &eZ80t::Op30, &eZ80t::Op31, &eZ80t::Op32, &eZ80t::Op33, &eZ80t::Opx34, &eZ80t::Opx35,
-                        &eZ80t::Opx36, &eZ80t::Op37,
-                        &eZ80t::Op38, &eZ80t::Opx39, &eZ80t::Op3A, &eZ80t::Op3B, &eZ80t::Op3C, &eZ80t::Op3D,
-                        &eZ80t::Op3E, &eZ80t::Op3F,
-
-                        &eZ80t::Op40, &eZ80t::Op41, &eZ80t::Op42, &eZ80t::Op43, &eZ80t::Opx44, &eZ80t::Opx45,
-                        &eZ80t::Opx46, &eZ80t::Op47,
-                        &eZ80t::Op48, &eZ80t::Op49, &eZ80t::Op4A, &eZ80t::Op4B, &eZ80t::Opx4C, &eZ80t::Opx4D,
-                        &eZ80t::Opx4E, &eZ80t::Op4F,
-                        &eZ80t::Op50, &eZ80t::Op51, &eZ80t::Op52, &eZ80t::Op53, &eZ80t::Opx54, &eZ80t::Opx55,
-                        &eZ80t::Opx56, &eZ80t::Op57,
-                        &eZ80t::Op58, &eZ80t::Op59, &eZ80t::Op5A, &eZ80t::Op5B, &eZ80t::Opx5C, &eZ80t::Opx5D,
-                        &eZ80t::Opx5E, &eZ80t::Op5F,
-                        &eZ80t::Opx60, &eZ80t::Opx61, &eZ80t::Opx62, &eZ80t::Opx63, &eZ80t::Op64, &eZ80t::Opx65,
-                        &eZ80t::Opx66, &eZ80t::Opx67,
-                        &eZ80t::Opx68, &eZ80t::Opx69, &eZ80t::Opx6A, &eZ80t::Opx6B, &eZ80t::Opx6C, &eZ80t::Op6D,
-                        &eZ80t::Opx6E, &eZ80t::Opx6F,
-                        &eZ80t::Opx70, &eZ80t::Opx71, &eZ80t::Opx72, &eZ80t::Opx73, &eZ80t::Opx74, &eZ80t::Opx75,
-                        &eZ80t::Op76, &eZ80t::Opx77,
-                        &eZ80t::Op78, &eZ80t::Op79, &eZ80t::Op7A, &eZ80t::Op7B, &eZ80t::Opx7C, &eZ80t::Opx7D,
-                        &eZ80t::Opx7E, &eZ80t::Op7F,
-
-                        &eZ80t::Op80, &eZ80t::Op81, &eZ80t::Op82, &eZ80t::Op83, &eZ80t::Opx84, &eZ80t::Opx85,
-                        &eZ80t::Opx86, &eZ80t::Op87,
-                        &eZ80t::Op88, &eZ80t::Op89, &eZ80t::Op8A, &eZ80t::Op8B, &eZ80t::Opx8C, &eZ80t::Opx8D,
-                        &eZ80t::Opx8E, &eZ80t::Op8F,
-                        &eZ80t::Op90, &eZ80t::Op91, &eZ80t::Op92, &eZ80t::Op93, &eZ80t::Opx94, &eZ80t::Opx95,
-                        &eZ80t::Opx96, &eZ80t::Op97,
-                        &eZ80t::Op98, &eZ80t::Op99, &eZ80t::Op9A, &eZ80t::Op9B, &eZ80t::Opx9C, &eZ80t::Opx9D,
-                        &eZ80t::Opx9E, &eZ80t::Op9F,
-                        &eZ80t::OpA0, &eZ80t::OpA1, &eZ80t::OpA2, &eZ80t::OpA3, &eZ80t::OpxA4, &eZ80t::OpxA5,
-                        &eZ80t::OpxA6, &eZ80t::OpA7,
-                        &eZ80t::OpA8, &eZ80t::OpA9, &eZ80t::OpAA, &eZ80t::OpAB, &eZ80t::OpxAC, &eZ80t::OpxAD,
-                        &eZ80t::OpxAE, &eZ80t::OpAF,
-                        &eZ80t::OpB0, &eZ80t::OpB1, &eZ80t::OpB2, &eZ80t::OpB3, &eZ80t::OpxB4, &eZ80t::OpxB5,
-                        &eZ80t::OpxB6, &eZ80t::OpB7,
-                        &eZ80t::OpB8, &eZ80t::OpB9, &eZ80t::OpBA, &eZ80t::OpBB, &eZ80t::OpxBC, &eZ80t::OpxBD,
-                        &eZ80t::OpxBE, &eZ80t::OpBF,
-
-                        &eZ80t::OpC0, &eZ80t::OpC1, &eZ80t::OpC2, &eZ80t::OpC3, &eZ80t::OpC4, &eZ80t::OpC5,
-                        &eZ80t::OpC6, &eZ80t::OpC7,
-                        &eZ80t::OpC8, &eZ80t::OpC9, &eZ80t::OpCA, &eZ80t::OpCB, &eZ80t::OpCC, &eZ80t::OpCD,
-                        &eZ80t::OpCE, &eZ80t::OpCF,
-                        &eZ80t::OpD0, &eZ80t::OpD1, &eZ80t::OpD2, &eZ80t::OpD3, &eZ80t::OpD4, &eZ80t::OpD5,
-                        &eZ80t::OpD6, &eZ80t::OpD7,
-                        &eZ80t::OpD8, &eZ80t::OpD9, &eZ80t::OpDA, &eZ80t::OpDB, &eZ80t::OpDC, &eZ80t::OpDD,
-                        &eZ80t::OpDE, &eZ80t::OpDF,
-                        &eZ80t::OpE0, &eZ80t::OpxE1, &eZ80t::OpE2, &eZ80t::OpxE3, &eZ80t::OpE4, &eZ80t::OpxE5,
-                        &eZ80t::OpE6, &eZ80t::OpE7,
-                        &eZ80t::OpE8, &eZ80t::OpxE9, &eZ80t::OpEA, &eZ80t::OpEB, &eZ80t::OpEC, &eZ80t::OpED,
-                        &eZ80t::OpEE, &eZ80t::OpEF,
-                        &eZ80t::OpF0, &eZ80t::OpF1, &eZ80t::OpF2, &eZ80t::OpF3, &eZ80t::OpF4, &eZ80t::OpF5,
-                        &eZ80t::OpF6, &eZ80t::OpF7,
-                        &eZ80t::OpF8, &eZ80t::OpxF9, &eZ80t::OpFA, &eZ80t::OpFB, &eZ80t::OpFC, &eZ80t::OpFD,
-                        &eZ80t::OpFE, &eZ80t::OpFF
-                };
-
         dump_instructions("opxy", opddcodes, count_of(opddcodes), "dd/fd prefix xy opcodes r_temp holds ix or iy");
 
-        CALLFUNC const opedcodes[] =
-                {
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-
-                        &eZ80t::Ope40, &eZ80t::Ope41, &eZ80t::Ope42, &eZ80t::Ope43, &eZ80t::Ope44, &eZ80t::Ope45,
-                        &eZ80t::Ope46, &eZ80t::Ope47,
-                        &eZ80t::Ope48, &eZ80t::Ope49, &eZ80t::Ope4A, &eZ80t::Ope4B, &eZ80t::Ope4C, &eZ80t::Ope4D,
-                        &eZ80t::Ope4E, &eZ80t::Ope4F,
-                        &eZ80t::Ope50, &eZ80t::Ope51, &eZ80t::Ope52, &eZ80t::Ope53, &eZ80t::Ope54, &eZ80t::Ope55,
-                        &eZ80t::Ope56, &eZ80t::Ope57,
-                        &eZ80t::Ope58, &eZ80t::Ope59, &eZ80t::Ope5A, &eZ80t::Ope5B, &eZ80t::Ope5C, &eZ80t::Ope5D,
-                        &eZ80t::Ope5E, &eZ80t::Ope5F,
-                        &eZ80t::Ope60, &eZ80t::Ope61, &eZ80t::Ope62, &eZ80t::Ope63, &eZ80t::Ope64, &eZ80t::Ope65,
-                        &eZ80t::Ope66, &eZ80t::Ope67,
-                        &eZ80t::Ope68, &eZ80t::Ope69, &eZ80t::Ope6A, &eZ80t::Ope6B, &eZ80t::Ope6C, &eZ80t::Ope6D,
-                        &eZ80t::Ope6E, &eZ80t::Ope6F,
-                        &eZ80t::Ope70, &eZ80t::Ope71, &eZ80t::Ope72, &eZ80t::Ope73, &eZ80t::Ope74, &eZ80t::Ope75,
-                        &eZ80t::Ope76, &eZ80t::Ope77,
-                        &eZ80t::Ope78, &eZ80t::Ope79, &eZ80t::Ope7A, &eZ80t::Ope7B, &eZ80t::Ope7C, &eZ80t::Ope7D,
-                        &eZ80t::Ope7E, &eZ80t::Ope7F,
-
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::OpeA0, &eZ80t::OpeA1, &eZ80t::OpeA2, &eZ80t::OpeA3, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::OpeA8, &eZ80t::OpeA9, &eZ80t::OpeAA, &eZ80t::OpeAB, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::OpeB0, &eZ80t::OpeB1, &eZ80t::OpeB2, &eZ80t::OpeB3, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::OpeB8, &eZ80t::OpeB9, &eZ80t::OpeBA, &eZ80t::OpeBB, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00, &eZ80t::Op00,
-                        &eZ80t::Op00, &eZ80t::Op00
-                };
-
 
         dump_instructions("ope", opedcodes, count_of(opedcodes), "ed prefix");
+
+        if (report) {
+            fprintf(report, "total: %d insns %d cycles -> %d insns %d cycles\n", peephole_stats.insns_before,
+                    peephole_stats.cycles_before, peephole_stats.insns_after, peephole_stats.cycles_after);
+            fprintf(report, "moves %d, extends %d, literal loads %d, dead %d removed; %d fused, %d propagated\n",
+                    peephole_stats.removed_moves, peephole_stats.removed_extends, peephole_stats.removed_literals,
+                    peephole_stats.removed_dead, peephole_stats.fused, peephole_stats.propagated);
+        }
+    }
+
+    void eZ80t::generate_cpp() {
+        emit("// ================================");
+        emit("// == AUTOGENERATED: DO NOT EDIT ==");
+        emit("// ================================");
+        emit("");
+        emit("// decoding for the host core (USE_Z80_GEN), from the tables z80khan_gen.S is made from. every case is the");
+        emit("// op inlined into the switch, so operands, flag masks and t-states are constants there");
+        emit("");
+
+        emit("//=============================================================================");
+        emit("//\teZ80::Dispatch");
+        emit("//-----------------------------------------------------------------------------");
+        emit("void eZ80::Dispatch(byte opcode)");
+        emit("{");
+        emit("\tswitch(opcode)");
+        dump_cpp_switch("Op", opcodes);
+        emit("}");
+
+        emit("//=============================================================================");
+        emit("//\teZ80::OpCB");
+        emit("//-----------------------------------------------------------------------------");
+        emit("void eZ80::OpCB()");
+        emit("{");
+        emit("\tswitch(Fetch())");
+        dump_cpp_switch("Opl", NULL);
+        emit("}");
+
+        const char xy[] = { 'x', 'y' };
+        for(uint i = 0; i < count_of(xy); i++) {
+            char buf[128];
+            emit("//=============================================================================");
+            snprintf(buf, sizeof(buf), "//\teZ80::Op%s", xy[i] == 'x' ? "DD" : "FD");
+            emit(buf);
+            emit("//-----------------------------------------------------------------------------");
+            snprintf(buf, sizeof(buf), "void eZ80::Op%s()", xy[i] == 'x' ? "DD" : "FD");
+            emit(buf);
+            emit("{");
+            emit("\tswitch(Fetch())");
+            dump_cpp_switch("Opx", opddcodes, xy[i]);
+            emit("}");
+        }
+
+        emit("//=============================================================================");
+        emit("//\teZ80::OpED");
+        emit("//-----------------------------------------------------------------------------");
+        emit("void eZ80::OpED()");
+        emit("{");
+        emit("\tswitch(Fetch())");
+        dump_cpp_switch("Ope", opedcodes);
+        emit("}");
+
+        // ddcb has one shape, the inner op on (ix+d) with the result also going to a register
+        emit("//=============================================================================");
+        emit("//\teZ80::OpDDCB");
+        emit("//-----------------------------------------------------------------------------");
+        emit("void eZ80::OpDDCB(dword ptr)");
+        emit("{");
+        emit("\tmemptr = ptr;");
+        emit("\t// DDCBnnXX,FDCBnnXX increment R by 2, not 3!");
+        emit("\tbyte opcode = ReadInc(pc);");
+        emit("\tt += 4;");
+        emit("\tswitch(opcode)");
+        emit("\t{");
+        const char *regs[] = { "b", "c", "d", "e", "h", "l", NULL, "a" };
+        for(int i = 0; i < 256; i += 8) {
+            char buf[256];
+            if ((i & 0xc0) == 0x40) { // bit n,(ix+d) whatever the register
+                snprintf(buf, sizeof(buf), "\tcase 0x%02x: case 0x%02x: case 0x%02x: case 0x%02x: case 0x%02x: case 0x%02x: case 0x%02x: case 0x%02x:",
+                         i, i + 1, i + 2, i + 3, i + 4, i + 5, i + 6, i + 7);
+                emit(buf);
+                snprintf(buf, sizeof(buf), "\t\tOplx%02X(Read(ptr)); t += 8; break;", i);
+                emit(buf);
+                continue;
+            }
+            for(uint r = 0; r < count_of(regs); r++) {
+                if (regs[r]) {
+                    snprintf(buf, sizeof(buf), "\tcase 0x%02x: %s = Oplx%02X(Read(ptr)); Write(ptr, %s); t += 11; break;", i + r, regs[r], i, regs[r]);
+                } else {
+                    snprintf(buf, sizeof(buf), "\tcase 0x%02x: Write(ptr, Oplx%02X(Read(ptr))); t += 11; break;", i + r, i);
+                }
+                emit(buf);
+            }
+        }
+        emit("\t}");
+        emit("}");
+    }
+
+    // name of the eZ80 op for an entry, ops the unprefixed table has keep its name
+    const char *eZ80t::cpp_name(const char *prefix, const CALLFUNC *instrs, int i, char xy) {
+        static char buf[16];
+        if (instrs && instrs != opcodes) {
+            for(int j = 0; j < 256; j++) {
+                if (opcodes[j] == instrs[i]) {
+                    snprintf(buf, sizeof(buf), "Op%02X", j);
+                    return buf;
+                }
+            }
+        }
+        snprintf(buf, sizeof(buf), "%s%02X", prefix, i);
+        if (xy) {
+            buf[2] = xy; // Opx -> Opy for the fd table
+        }
+        return buf;
+    }
+
+    void eZ80t::dump_cpp_switch(const char *prefix, const CALLFUNC *instrs, char xy) {
+        char names[256][16];
+        int most = 0, most_count = 0;
+        for(int i = 0; i < 256; i++) {
+            strcpy(names[i], cpp_name(prefix, instrs, i, xy));
+            int count = 0;
+            for(int j = 0; j < 256; j++) {
+                count += !strcmp(names[i], names[j]);
+            }
+            if (count > most_count) {
+                most = i;
+                most_count = count;
+            }
+        }
+        emit("\t{");
+        char buf[128];
+        for(int i = 0; i < 256; i++) {
+            if (xy && i == 0xcb) {
+                snprintf(buf, sizeof(buf), "\tcase 0xcb: OpDDCB(i%c + (signed char)ReadInc(pc)); break;", xy);
+            } else if (most_count > 1 && !strcmp(names[i], names[most])) {
+                continue; // the default
+            } else {
+                snprintf(buf, sizeof(buf), "\tcase 0x%02x: %s(); break;", i, names[i]);
+            }
+            emit(buf);
+        }
+        if (most_count > 1) {
+            snprintf(buf, sizeof(buf), "\tdefault: %s(); break;", names[most]);
+            emit(buf);
+        }
+        emit("\t}");
     }
 
     void eZ80t::dump_instructions(const char *prefix, const CALLFUNC *instrs, int count, const char *description, int mult) {
@@ -546,10 +1233,15 @@ namespace Z80t
                 {
                     emit(".thumb_func");
                 }
+                std::vector<std::string> lines;
+                function_lines = &lines;
                 snprintf(buf, sizeof(buf), "%s%02x:", prefix, i * mult);
                 emit(buf);
                 (this->*instrs[i])();
                 emit_function_return();
+                snprintf(buf, sizeof(buf), "%s%02x", prefix, i * mult);
+                // the opli functions are also called directly by the cb/ddcb wrappers
+                dump_function(buf, strncmp(prefix, "opli_", 5) != 0);
                 if (!strcmp(prefix, "opxy")) {
                     // can't use r_temp and r_ixy since they are the same reg
                     assert(!r_temp_used);
@@ -26,6 +26,8 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include <cstring>
 #include "z80khan.h" // needed for struct layout
 #include <type_traits>
+#include <string>
+#include <vector>
 
 #ifdef DECLARE_REG16
 #error z80 already included in same compilation unit
@@ -844,7 +846,10 @@ public:
     typedef void (eZ80t::*CALLFUNC)();
 //    typedef temp8 (eZ80t::*CALLFUNCI)(temp8);
 
-    void generate_arm();
+    // report gets instructions and estimated cycles of every op handler before and after the peephole pass
+    void generate_arm(FILE *report = NULL);
+    // the same decoding as switches over the eZ80 ops, for the host core built with USE_Z80_GEN (z80/z80_gen.h)
+    void generate_cpp();
 
 protected:
 	ZeroExtendedByteInR0 IoRead(WordInR0 port) const;
@@ -857,6 +862,18 @@ protected:
     void WriteXY(WordInR0 addr, Reg8Ref v);
     void Write2(Reg16Ref addr, WordInR0 v); // low then high
     void dump_instructions(const char *prefix, const CALLFUNC *instrs, int count, const char *description=NULL, int mult = 1);
+    void dump_cpp_switch(const char *prefix, const CALLFUNC *instrs, char xy = 0);
+    const char *cpp_name(const char *prefix, const CALLFUNC *instrs, int i, char xy);
+
+    static const CALLFUNC opcodes[256];
+    static const CALLFUNC opddcodes[256];
+    static const CALLFUNC opedcodes[256];
+
+    void dump_function(const char *name, bool table_dispatch_only);
+
+    // op handler being emitted, held back for the peephole pass
+    static std::vector<std::string> *function_lines;
+    static FILE *report;
 
     static const char *pending_call;
     static void emit_pending_call() {
@@ -869,6 +886,10 @@ protected:
     }
     static void emit(const char *a) {
         emit_pending_call();
+        if (function_lines) {
+            function_lines->push_back(a);
+            return;
+        }
         printf("%s\n", a);
     }
     static void emit(const char *a, const char *b, const char *c = "") {
@@ -2013,7 +2034,7 @@ protected:
         emit("adds ", "r0, r1");
         emit("bics ", "r0, r1");
         emit("add ", "r_t, r0");
-#ifndef NO_USE_REPLAY
+#if 0 // the generated core is device only, and the device has no replay (NO_USE_REPLAY)
         if(handler.io) // replay is active
         {
             r_low += fetches;
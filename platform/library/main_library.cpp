@@ -1,6 +1,7 @@
 /*
 Portable ZX-Spectrum emulator.
 Copyright (C) 2001-2017 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
 
 This program is free software: you can redistribute it and/or modify
 it under the terms of the GNU General Public License as published by
@@ -20,19 +21,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../../tools/tick.h"
 #include "../../speccy.h"
 #include "../../devices/memory.h"
+#include "../../devices/ula.h"
+#ifndef NO_USE_AY
+#include "../../devices/sound/ay.h"
+#endif
+#include "usp_library.h"
 
 #ifdef USE_LIBRARY
 
-#ifdef _WINDOWS
-#define USP_API __declspec(dllexport)
-#else
-#define USP_API
-#endif//
-
 extern "C"
 {
 
 using namespace xPlatform;
+
+static USP_View view;
+static const char* run_error = NULL;
+
 USP_API void USP_Init()
 {
 	Handler()->OnInit();
@@ -41,6 +45,7 @@ USP_API void USP_Init()
 USP_API void USP_Loop()
 {
 	Handler()->OnLoop();
+	++view.frame;
 }
 
 USP_API void USP_Done()
@@ -58,10 +63,12 @@ USP_API void USP_OnKey(char key, dword flags)
 	Handler()->OnKey(key, flags);
 }
 
+#ifndef NO_USE_SCREEN
 USP_API void USP_GetVideoData(byte buf[320*240])
 {
 	memcpy(buf, Handler()->VideoData(), 320*240);
 }
+#endif
 
 USP_API void USP_MemoryRead(byte* buf, dword addr, dword size)
 {
@@ -77,7 +84,145 @@ USP_API void USP_MemoryWrite(const byte* buf, dword addr, dword size)
 	memcpy(dst, buf, size);
 }
 
+//=============================================================================
+//	v2
+//-----------------------------------------------------------------------------
+USP_API int USP_ApiVersion()
+{
+	return USP_API_VERSION;
+}
+
+static bool Stopped(const USP_Stop* stop)
+{
+	if(stop->addr >= 0 && (Handler()->Speccy()->Memory()->Read(stop->addr) & stop->mask) == stop->value)
+		return true;
+	return stop->callback && stop->callback(stop->ctx, view.frame);
+}
+
+USP_API int USP_Run(int frames, const USP_Stop* stop)
+{
+	run_error = NULL;
+	int i = 0;
+	while(i < frames)
+	{
+		run_error = Handler()->OnLoop();
+		++view.frame;
+		++i;
+		if(run_error || (stop && Stopped(stop)))
+			break;
+	}
+	return i;
+}
+
+USP_API const char* USP_RunError()
+{
+	return run_error;
+}
+
+USP_API const USP_View* USP_GetView()
+{
+	eSpeccy* s = Handler()->Speccy();
+	eMemory* m = s->Memory();
+	eUla* ula = s->Device<eUla>();
+	view.pixels = ula->ScreenMemory();
+	view.attrs = view.pixels + 6144;
+	view.pages = m->Get(0);
+	view.page_size = eMemory::PAGE_SIZE;
+	view.page_count = eMemory::P_AMOUNT;
+	for(int i = 0; i < eMemory::BANKS_AMOUNT; ++i)
+	{
+#ifdef USE_BANKED_MEMORY_ACCESS
+		view.banks[i] = m->Page(i);
+#else
+		view.banks[i] = i; // pages are laid out as the 64K address space
+#endif
+	}
+	view.border = ula->BorderColor();
+	return &view;
+}
+
+USP_API void USP_Read(uint8_t* buf, uint16_t addr, uint32_t size)
+{
+	eMemory* m = Handler()->Speccy()->Memory();
+	for(dword i = 0; i < size; ++i)
+		buf[i] = m->Read(addr + i);
+}
+
+USP_API void USP_Write(const uint8_t* buf, uint16_t addr, uint32_t size)
+{
+	eMemory* m = Handler()->Speccy()->Memory();
+	for(dword i = 0; i < size; ++i)
+		m->Write(addr + i, buf[i]);
+}
+
+static byte* PageData(int page, dword offset, dword size)
+{
+	if(page < 0 || page >= eMemory::P_AMOUNT || offset > eMemory::PAGE_SIZE || size > eMemory::PAGE_SIZE - offset)
+		return NULL;
+	return Handler()->Speccy()->Memory()->Get(page) + offset;
+}
+
+USP_API int USP_PageRead(uint8_t* buf, int page, uint32_t offset, uint32_t size)
+{
+	byte* src = PageData(page, offset, size);
+	if(!src)
+		return false;
+	memcpy(buf, src, size);
+	return true;
+}
+
+USP_API int USP_PageWrite(const uint8_t* buf, int page, uint32_t offset, uint32_t size)
+{
+	byte* dst = PageData(page, offset, size);
+	if(!dst)
+		return false;
+	memcpy(dst, buf, size);
+	return true;
+}
+
+//=============================================================================
+//	sound - the ay takes its output buffers straight out of the ring
+//-----------------------------------------------------------------------------
+enum
+{
+	SOUND_SIZE = 1 << 15,
+	SOUND_SLACK = 2048,	// more than a frame, the ay fills at most a frame per buffer
+};
+static int16_t sound_ring[SOUND_SIZE + SOUND_SLACK];
+static USP_Sound sound = { sound_ring, SOUND_SIZE, 0, SNDR_DEFAULT_SAMPLE_RATE };
+
+USP_API const USP_Sound* USP_GetSound()
+{
+	return &sound;
+}
+
 }
 //extern "C"
 
+#ifndef NO_USE_AY
+struct audio_buffer_pool* producer_pool = NULL;
+static mem_buffer_t sound_mem;
+static audio_buffer_t sound_buffer;
+
+audio_buffer_t* take_audio_buffer(audio_buffer_pool_t* pool, bool block)
+{
+	dword pos = sound.written & (SOUND_SIZE - 1);
+	sound_mem.bytes = (uint8_t*)(sound_ring + pos);
+	sound_mem.size = SOUND_SLACK * sizeof(int16_t);
+	sound_buffer.buffer = &sound_mem;
+	sound_buffer.max_sample_count = SOUND_SLACK;
+	sound_buffer.sample_count = 0;
+	return &sound_buffer;
+}
+
+void give_audio_buffer(audio_buffer_pool_t* pool, audio_buffer_t* buffer)
+{
+	dword pos = sound.written & (SOUND_SIZE - 1);
+	dword end = pos + buffer->sample_count;
+	if(end > SOUND_SIZE) // ran on into the slack, wrap that round to the start
+		memcpy(sound_ring, sound_ring + SOUND_SIZE, (end - SOUND_SIZE) * sizeof(int16_t));
+	sound.written += buffer->sample_count;
+}
+#endif//NO_USE_AY
+
 #endif//USE_LIBRARY
@@ -0,0 +1,121 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2017 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __USP_LIBRARY_H__
+#define __USP_LIBRARY_H__
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef _WINDOWS
+#define USP_API __declspec(dllexport)
+#else
+#define USP_API
+#endif//
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+// v2 api: frames run in batches, machine state is handed out as pointers into the live machine rather than copied.
+// every pointer stays valid until the next USP_Init/USP_Done/USP_OpenFile, the ones into memory across USP_Run too
+enum { USP_API_VERSION = 2 };
+
+typedef struct USP_View
+{
+	const uint8_t* pixels;	// displayed screen, 6144 bytes in spectrum layout
+	const uint8_t* attrs;	// its 768 attribute bytes
+	uint8_t* pages;			// all memory pages back to back, page_size bytes each
+	uint32_t page_size;
+	uint32_t page_count;
+	int32_t banks[4];		// page mapped at 0x0000, 0x4000, 0x8000, 0xc000
+	uint8_t border;
+	uint32_t frame;			// frames run by USP_Run/USP_Loop since USP_Init
+} USP_View;
+
+typedef struct USP_Sound
+{
+	const int16_t* samples;	// mono ring buffer of size samples (a power of two)
+	uint32_t size;
+	uint32_t written;		// total samples written, wraps at 2^32. new samples are samples[read & (size - 1)] up to here
+	uint32_t sample_rate;
+} USP_Sound;
+
+// checked after each frame, any met condition ends USP_Run
+typedef struct USP_Stop
+{
+	int32_t addr;			// z80 address watched, -1 for none
+	uint8_t mask;			// stop once (byte & mask) == value
+	uint8_t value;
+	int (*callback)(void* ctx, uint32_t frame);	// stop when it returns non zero, may be NULL
+	void* ctx;
+} USP_Stop;
+
+USP_API int USP_ApiVersion();
+// runs up to frames frames, returns how many were run. stops early on a stop condition or a replay error
+USP_API int USP_Run(int frames, const USP_Stop* stop);
+// error text that ended the last USP_Run, NULL if none
+USP_API const char* USP_RunError();
+USP_API const USP_View* USP_GetView();
+USP_API const USP_Sound* USP_GetSound();
+// through the current z80 memory map, writes to rom are ignored like on the real thing
+USP_API void USP_Read(uint8_t* buf, uint16_t addr, uint32_t size);
+USP_API void USP_Write(const uint8_t* buf, uint16_t addr, uint32_t size);
+// explicit page, offset within it. returns false if out of range
+USP_API int USP_PageRead(uint8_t* buf, int page, uint32_t offset, uint32_t size);
+USP_API int USP_PageWrite(const uint8_t* buf, int page, uint32_t offset, uint32_t size);
+
+// batch of machines stepped in parallel, one worker process each (a machine needs its own process). call before
+// USP_Init, or not at all in the same process. the workers are forked, so also call it before the host starts any
+// threads of its own: only the calling thread exists in a worker, and a lock another thread held stays held
+typedef struct USP_VecConfig
+{
+	int envs;
+	const char* file;		// opened by every env at start and on reset, NULL to just reset the machine
+	int frames;				// frames run by each step
+	int screen_scale;		// 0 for no screen, 1, 2, 4 or 8: (256/scale)x(192/scale) colour bytes 0..15, ink/paper + bright
+	const uint16_t* ram;	// z80 addresses copied into each observation after the screen
+	int ram_count;
+	// called in this process for each env after a step, on its observation
+	float (*reward)(void* ctx, int env, const uint8_t* obs);
+	void* reward_ctx;
+} USP_VecConfig;
+
+typedef struct USP_VecAction
+{
+	uint8_t keys[8];		// a bit set for each key held, half rows and bits as port 0xfe reads them
+	uint8_t kempston;		// KEMPSTON_R/L/D/U/F bits
+} USP_VecAction;
+
+USP_API void* USP_VecOpen(const USP_VecConfig* cfg);
+// bytes of each env's observation in the buffer USP_VecStep fills, envs back to back
+USP_API uint32_t USP_VecObsSize(void* vec);
+// applies actions[env], runs every env cfg->frames frames, then writes observations and rewards (may be NULL).
+// returns false if a worker died
+USP_API int USP_VecStep(void* vec, const USP_VecAction* actions, void* obs, float* rewards);
+USP_API int USP_VecReset(void* vec, int env);
+USP_API void USP_VecClose(void* vec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif//__USP_LIBRARY_H__
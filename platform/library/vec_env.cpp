@@ -0,0 +1,305 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2017 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../platform.h"
+#include "../../speccy.h"
+#include "../../devices/memory.h"
+#include "../../devices/ula.h"
+#include "../../devices/input/keyboard.h"
+#ifndef NO_USE_KEMPSTON
+#include "../../devices/input/kempston_joy.h"
+#endif
+#include "usp_library.h"
+
+#if defined(USE_LIBRARY) && !defined(_WINDOWS)
+
+#include <vector>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+namespace xPlatform
+{
+
+//*****************************************************************************
+//	eVecEnv
+//-----------------------------------------------------------------------------
+// Every env is a worker process owning the one machine the handler provides. Actions and observations of all of
+// them live in a shared mapping made before forking, so a step costs a byte down and a byte back up each socket and
+// the workers run their frames in parallel. Signal dispositions are the host's, so nothing here relies on SIGPIPE
+// being ignored.
+class eVecEnv
+{
+public:
+	eVecEnv() : slots(NULL), slots_size(0), slot_size(0), obs_size(0) {}
+	bool Open(const USP_VecConfig& cfg);
+	void Close();
+	bool Step(const USP_VecAction* actions, byte* obs, float* rewards);
+	bool Reset(int env);
+	dword ObsSize() const { return obs_size; }
+
+private:
+	enum eCommand { C_STEP = 's', C_RESET = 'r' };
+	enum { ACTION_SIZE = 16 };
+	struct eWorker
+	{
+		pid_t pid;
+		int fd;
+	};
+	USP_VecAction* Action(int env) const { return (USP_VecAction*)(slots + env*slot_size); }
+	byte* Obs(int env) const { return slots + env*slot_size + ACTION_SIZE; }
+	bool Command(int env, byte c);
+	bool Done(int env);
+	void Work(int env, int fd);
+	bool Load() const;
+	void Observe(byte* obs) const;
+
+	USP_VecConfig cfg;
+	std::vector<word> ram;
+	std::vector<eWorker> workers;
+	byte* slots;
+	size_t slots_size;
+	size_t slot_size;
+	dword obs_size;
+};
+
+bool eVecEnv::Open(const USP_VecConfig& _cfg)
+{
+	cfg = _cfg;
+	if(cfg.envs <= 0 || cfg.frames <= 0)
+		return false;
+	switch(cfg.screen_scale)
+	{
+	case 0: case 1: case 2: case 4: case 8:
+		break;
+	default:
+		return false;
+	}
+	ram.assign(cfg.ram, cfg.ram + cfg.ram_count);
+	cfg.ram = NULL;
+	obs_size = cfg.ram_count;
+	if(cfg.screen_scale)
+		obs_size += (256/cfg.screen_scale)*(192/cfg.screen_scale);
+	slot_size = (ACTION_SIZE + obs_size + 63) & ~63; // keep envs off each other's cache lines
+	slots_size = slot_size*cfg.envs;
+	void* m = mmap(NULL, slots_size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_ANONYMOUS, -1, 0);
+	if(m == MAP_FAILED)
+		return false;
+	slots = (byte*)m;
+	memset(slots, 0, slots_size);
+	for(int i = 0; i < cfg.envs; ++i)
+	{
+		int fds[2];
+		if(socketpair(AF_UNIX, SOCK_STREAM, 0, fds))
+			break;
+		pid_t pid = fork();
+		if(!pid)
+		{
+			// only this worker's end, the others' were copied in too
+			for(size_t w = 0; w < workers.size(); ++w)
+				close(workers[w].fd);
+			close(fds[0]);
+			Work(i, fds[1]);
+		}
+		close(fds[1]);
+		eWorker w = { pid, fds[0] };
+		workers.push_back(w);
+		if(pid < 0)
+			break;
+	}
+	// workers report in once their machine is loaded
+	bool ok = (int)workers.size() == cfg.envs;
+	for(int i = 0; i < (int)workers.size(); ++i)
+		ok &= Done(i);
+	if(!ok)
+		Close();
+	return ok;
+}
+void eVecEnv::Close()
+{
+	for(size_t i = 0; i < workers.size(); ++i)
+		close(workers[i].fd); // worker exits on end of input
+	for(size_t i = 0; i < workers.size(); ++i)
+	{
+		if(workers[i].pid > 0)
+			waitpid(workers[i].pid, NULL, 0);
+	}
+	workers.clear();
+	if(slots)
+		munmap(slots, slots_size);
+	slots = NULL;
+}
+// a dead peer shows up as a failed send rather than SIGPIPE, which the host may not be ignoring
+static bool SendByte(int fd, byte c)
+{
+#ifdef MSG_NOSIGNAL
+	return send(fd, &c, 1, MSG_NOSIGNAL) == 1;
+#else
+	int on = 1; // no MSG_NOSIGNAL on darwin, the socket option does the same
+	setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+	return send(fd, &c, 1, 0) == 1;
+#endif
+}
+static bool RecvByte(int fd, byte* c)
+{
+	return recv(fd, c, 1, 0) == 1;
+}
+bool eVecEnv::Command(int env, byte c)
+{
+	return SendByte(workers[env].fd, c);
+}
+bool eVecEnv::Done(int env)
+{
+	byte r = 0;
+	return RecvByte(workers[env].fd, &r) && r;
+}
+bool eVecEnv::Step(const USP_VecAction* actions, byte* obs, float* rewards)
+{
+	int envs = workers.size();
+	bool ok = true;
+	for(int i = 0; i < envs; ++i)
+	{
+		*Action(i) = actions[i];
+		ok &= Command(i, C_STEP);
+	}
+	for(int i = 0; i < envs; ++i)
+	{
+		ok &= Done(i);
+		byte* o = obs + i*obs_size;
+		memcpy(o, Obs(i), obs_size);
+		if(rewards)
+			rewards[i] = cfg.reward ? cfg.reward(cfg.reward_ctx, i, o) : 0.0f;
+	}
+	return ok;
+}
+bool eVecEnv::Reset(int env)
+{
+	if(env < 0 || env >= (int)workers.size())
+		return false;
+	return Command(env, C_RESET) && Done(env);
+}
+bool eVecEnv::Load() const
+{
+	if(cfg.file)
+		return Handler()->OnOpenFile(cfg.file);
+	Handler()->OnAction(A_RESET);
+	return true;
+}
+void eVecEnv::Work(int env, int fd)
+{
+	Handler()->OnInit();
+	byte ok = Load();
+	for(;;)
+	{
+		Observe(Obs(env));
+		if(!SendByte(fd, ok))
+			break;
+		byte c;
+		if(!RecvByte(fd, &c))
+			break;
+		switch(c)
+		{
+		case C_STEP:
+			{
+				eSpeccy* s = Handler()->Speccy();
+				const USP_VecAction* a = Action(env);
+				s->Device<eKeyboard>()->Matrix(a->keys);
+#ifndef NO_USE_KEMPSTON
+				s->Device<eKempstonJoy>()->setState(a->kempston);
+#endif
+				for(int i = 0; i < cfg.frames; ++i)
+					Handler()->OnLoop();
+				ok = true;
+			}
+			break;
+		case C_RESET:
+			ok = Load();
+			break;
+		}
+	}
+	_exit(0); // the machine and everything else goes with the process
+}
+void eVecEnv::Observe(byte* obs) const
+{
+	eSpeccy* s = Handler()->Speccy();
+	if(cfg.screen_scale)
+	{
+		const byte* pixels = s->Device<eUla>()->ScreenMemory();
+		const byte* attrs = pixels + 0x1800;
+		int step = cfg.screen_scale;
+		for(int y = 0; y < 192; y += step)
+		{
+			const byte* line = pixels + ((y & 0xc0) << 5) + ((y & 7) << 8) + ((y & 0x38) << 2);
+			const byte* attr = attrs + (y >> 3)*32;
+			for(int x = 0; x < 256; x += step)
+			{
+				byte a = attr[x >> 3];
+				bool ink = line[x >> 3] & (0x80 >> (x & 7));
+				*obs++ = (ink ? a & 7 : (a >> 3) & 7) | ((a >> 3) & 8);
+			}
+		}
+	}
+	eMemory* m = s->Memory();
+	for(size_t i = 0; i < ram.size(); ++i)
+		*obs++ = m->Read(ram[i]);
+}
+
+}
+//namespace xPlatform
+
+extern "C"
+{
+
+using namespace xPlatform;
+
+USP_API void* USP_VecOpen(const USP_VecConfig* cfg)
+{
+	eVecEnv* v = new eVecEnv;
+	if(!v->Open(*cfg))
+		SAFE_DELETE(v);
+	return v;
+}
+
+USP_API uint32_t USP_VecObsSize(void* vec)
+{
+	return ((eVecEnv*)vec)->ObsSize();
+}
+
+USP_API int USP_VecStep(void* vec, const USP_VecAction* actions, void* obs, float* rewards)
+{
+	return ((eVecEnv*)vec)->Step(actions, (byte*)obs, rewards);
+}
+
+USP_API int USP_VecReset(void* vec, int env)
+{
+	return ((eVecEnv*)vec)->Reset(env);
+}
+
+USP_API void USP_VecClose(void* vec)
+{
+	eVecEnv* v = (eVecEnv*)vec;
+	v->Close();
+	SAFE_DELETE(v);
+}
+
+}
+//extern "C"
+
+#endif//USE_LIBRARY && !_WINDOWS
@@ -0,0 +1,351 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2013 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../platform.h"
+#include "../../speccy.h"
+#include "../../z80/z80.h"
+#include "../../devices/memory.h"
+
+#if defined(USE_LOCKSTEP) && !defined(_WINDOWS)
+
+#include <vector>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+// The core is chosen at build time, so each core is its own build of this tool. Run with -t it loads an image and
+// writes a record per instruction (or per frame) to stdout; otherwise it starts itself and the -b build with -t and
+// reads both traces in lockstep, stopping at the first record that differs. Either build can be this one, which
+// checks the run is deterministic. With -f -w the first run gets through each frame one watch stop per instruction,
+// so a run carried on over stops is checked against a plain one.
+
+#ifndef USE_Z80_TRACE
+#error USE_LOCKSTEP needs USE_Z80_TRACE
+#endif
+
+namespace xLockstep
+{
+
+enum { MAX_EVENTS = 8 };
+
+#pragma pack(push, 1)
+struct eEvent
+{
+	byte	kind;	// 'W'rite, 'I'n or 'O'ut
+	byte	v;
+	word	addr;	// or port
+	int		tact;
+};
+
+// machine state after a step, all of it compared. one step is an instruction, with any interrupt accepted before
+// it, or a frame
+struct eRecord
+{
+	dword	step;
+	word	pc, sp, af, bc, de, hl, ix, iy;
+	word	alt_af, alt_bc, alt_de, alt_hl;
+	word	ir, memptr;
+	byte	im, iff1, iff2, halted;
+	qword	t;
+	dword	events;		// writes and port accesses in the step
+	dword	events_hash;
+	dword	memory_hash; // every page, frame steps only
+	eEvent	event[MAX_EVENTS]; // the first of them
+};
+#pragma pack(pop)
+
+struct eOptions
+{
+	eOptions() : frames(false), watched(false), count(0), context(16), other(NULL) {}
+	bool frames;
+	bool watched;
+	int count;
+	int context;
+	const char* other;
+};
+
+struct eZ80Probe : public xZ80::eZ80
+{
+	void Registers(eRecord* r) const
+	{
+		r->pc = pc; r->sp = sp; r->af = af; r->bc = bc; r->de = de; r->hl = hl; r->ix = ix; r->iy = iy;
+		r->alt_af = alt.af; r->alt_bc = alt.bc; r->alt_de = alt.de; r->alt_hl = alt.hl;
+		r->ir = ir; r->memptr = memptr;
+		r->im = im; r->iff1 = iff1; r->iff2 = iff2; r->halted = halted;
+	}
+};
+
+class eTracer : public xZ80::eZ80::eHandlerTrace
+{
+public:
+	eTracer() : r(NULL) {}
+	void Begin(eRecord* _r)
+	{
+		r = _r;
+		memset(r, 0, sizeof(*r));
+		r->events_hash = 2166136261u;
+	}
+	virtual void Z80_Write(word addr, byte v, int tact) { Event('W', addr, v, tact); }
+	virtual void Z80_Io(word port, byte v, bool out, int tact) { Event(out ? 'O' : 'I', port, v, tact); }
+
+protected:
+	void Event(byte kind, word addr, byte v, int tact)
+	{
+		if(r->events < MAX_EVENTS)
+		{
+			eEvent& e = r->event[r->events];
+			e.kind = kind;
+			e.v = v;
+			e.addr = addr;
+			e.tact = tact;
+		}
+		++r->events;
+		dword h = r->events_hash;
+		h = (h ^ kind)*16777619u;
+		h = (h ^ v)*16777619u;
+		h = (h ^ addr)*16777619u;
+		h = (h ^ (dword)tact)*16777619u;
+		r->events_hash = h;
+	}
+	eRecord* r;
+};
+
+static dword MemoryHash(eMemory* m)
+{
+	dword h = 2166136261u;
+	for(int p = 0; p < eMemory::P_AMOUNT; ++p)
+	{
+		const byte* d = m->Get(p);
+		for(int i = 0; i < eMemory::PAGE_SIZE; ++i)
+			h = (h ^ d[i])*16777619u;
+	}
+	return h;
+}
+
+// trace side: the image's run as records on stdout
+static int Trace(const char* name, const eOptions& op)
+{
+	using namespace xPlatform;
+	// records go down the pipe alone, anything the emulator prints ends up on stderr
+	FILE* out = fdopen(dup(1), "wb");
+	dup2(2, 1);
+	if(!out)
+		return 1;
+	Handler()->OnInit();
+	if(!Handler()->OnOpenFile(name))
+	{
+		fprintf(stderr, "Error : %s - unsupported image format\n", name);
+		Handler()->OnDone();
+		return 1;
+	}
+	eSpeccy* speccy = Handler()->Speccy();
+	eZ80Probe* cpu = (eZ80Probe*)speccy->CPU();
+	eTracer tracer;
+	cpu->HandlerTrace(&tracer);
+	eSpeccy::eWatch w;
+	w.tstates = 1; // stops after the next instruction
+	eRecord r;
+	for(int i = 0; i < op.count; ++i)
+	{
+		tracer.Begin(&r);
+		if(op.frames && op.watched)
+		{
+			int frames;
+			do
+			{
+				frames = 1;
+				speccy->Run(w, &frames);
+			} while(!frames);
+		}
+		else if(op.frames)
+			speccy->Update();
+		else
+		{
+			int frames = 2; // the end of one and the first instruction of the next
+			speccy->Run(w, &frames);
+		}
+		r.step = i;
+		cpu->Registers(&r);
+		r.t = speccy->T() + cpu->T();
+		if(op.frames)
+			r.memory_hash = MemoryHash(speccy->Memory());
+		if(fwrite(&r, sizeof(r), 1, out) != 1)
+			break; // compare side has seen enough
+	}
+	cpu->HandlerTrace(NULL);
+	fclose(out);
+	Handler()->OnDone();
+	return 0;
+}
+
+static FILE* Spawn(const char* exe, const char* name, const eOptions& op, bool watched, pid_t* pid)
+{
+	int fd[2];
+	if(pipe(fd))
+		return NULL;
+	char count[16];
+	sprintf(count, "%d", op.count);
+	const char* args[8] = { exe, "-t", "-n", count };
+	int n = 4;
+	if(op.frames)
+		args[n++] = "-f";
+	if(watched)
+		args[n++] = "-w";
+	args[n++] = name;
+	args[n] = NULL;
+	fflush(NULL);
+	*pid = fork();
+	if(!*pid)
+	{
+		dup2(fd[1], 1);
+		close(fd[0]);
+		close(fd[1]);
+		execvp(exe, (char* const*)args);
+		fprintf(stderr, "Error : %s - can't run\n", exe);
+		_exit(1);
+	}
+	close(fd[1]);
+	if(*pid < 0)
+	{
+		close(fd[0]);
+		return NULL;
+	}
+	return fdopen(fd[0], "r");
+}
+
+static void Print(const char* prefix, const eRecord& r)
+{
+	printf("%s%8u pc=%04x sp=%04x af=%04x bc=%04x de=%04x hl=%04x ix=%04x iy=%04x af'=%04x bc'=%04x de'=%04x hl'=%04x"
+			" ir=%04x wz=%04x im=%d iff=%d%d%s t=%llu", prefix, r.step, r.pc, r.sp, r.af, r.bc, r.de, r.hl, r.ix, r.iy,
+			r.alt_af, r.alt_bc, r.alt_de, r.alt_hl, r.ir, r.memptr, r.im, r.iff1, r.iff2, r.halted ? " halt" : "",
+			(unsigned long long)r.t);
+	for(dword i = 0; i < r.events && i < MAX_EVENTS; ++i)
+		printf(" %c%04x=%02x@%d", r.event[i].kind, r.event[i].addr, r.event[i].v, r.event[i].tact);
+	if(r.events > MAX_EVENTS)
+		printf(" +%u", r.events - MAX_EVENTS);
+	if(r.memory_hash)
+		printf(" mem=%08x", r.memory_hash);
+	printf("\n");
+}
+
+#define DIFF(f) if(a.f != b.f) printf("  %-12s %llx vs %llx\n", #f, (unsigned long long)a.f, (unsigned long long)b.f)
+static void Diff(const eRecord& a, const eRecord& b)
+{
+	DIFF(pc); DIFF(sp); DIFF(af); DIFF(bc); DIFF(de); DIFF(hl); DIFF(ix); DIFF(iy);
+	DIFF(alt_af); DIFF(alt_bc); DIFF(alt_de); DIFF(alt_hl); DIFF(ir); DIFF(memptr);
+	DIFF(im); DIFF(iff1); DIFF(iff2); DIFF(halted); DIFF(t);
+	DIFF(events); DIFF(events_hash); DIFF(memory_hash);
+}
+#undef DIFF
+
+// compare side: returns 0 if both runs are the same all the way, 2 on a difference
+static int Compare(const char* self, const char* name, const eOptions& op)
+{
+	pid_t pid_a, pid_b;
+	FILE* a = Spawn(self, name, op, op.watched, &pid_a);
+	FILE* b = a ? Spawn(op.other ? op.other : self, name, op, false, &pid_b) : NULL;
+	if(!a || !b)
+	{
+		printf("Error : can't start the traced runs\n");
+		return 1;
+	}
+	std::vector<eRecord> history(op.context > 0 ? op.context : 1);
+	int steps = 0;
+	int res = 0;
+	for(;; ++steps)
+	{
+		eRecord ra, rb;
+		bool got_a = fread(&ra, sizeof(ra), 1, a) == 1;
+		bool got_b = fread(&rb, sizeof(rb), 1, b) == 1;
+		if(!got_a && !got_b)
+			break;
+		if(got_a != got_b)
+		{
+			printf("%s run ended at %s %d\n", got_a ? "second" : "first", op.frames ? "frame" : "step", steps);
+			res = 2;
+			break;
+		}
+		if(memcmp(&ra, &rb, sizeof(ra)))
+		{
+			printf("first difference at %s %d\n", op.frames ? "frame" : "step", steps);
+			int n = steps < (int)history.size() ? steps : history.size();
+			for(int i = steps - n; i < steps && op.context > 0; ++i)
+				Print("   ", history[i % history.size()]);
+			Print("a: ", ra);
+			Print("b: ", rb);
+			Diff(ra, rb);
+			res = 2;
+			break;
+		}
+		history[steps % history.size()] = ra;
+	}
+	// stop the runs early on a difference, they see a broken pipe
+	fclose(a);
+	fclose(b);
+	waitpid(pid_a, NULL, 0);
+	waitpid(pid_b, NULL, 0);
+	if(!res)
+		printf("%d %s the same\n", steps, op.frames ? "frames" : "steps");
+	return res;
+}
+
+}
+//namespace xLockstep
+
+int main(int argc, char* argv[])
+{
+	using namespace xLockstep;
+	eOptions op;
+	bool trace = false;
+	int arg = 1;
+	for(; arg < argc && argv[arg][0] == '-' && argv[arg][1]; ++arg)
+	{
+		const char* a = argv[arg];
+		if(!strcmp(a, "-t"))
+			trace = true;
+		else if(!strcmp(a, "-f"))
+			op.frames = true;
+		else if(!strcmp(a, "-w"))
+			op.watched = true;
+		else if(arg + 1 >= argc)
+			break;
+		else if(!strcmp(a, "-n"))
+			op.count = atoi(argv[++arg]);
+		else if(!strcmp(a, "-c"))
+			op.context = atoi(argv[++arg]);
+		else if(!strcmp(a, "-b"))
+			op.other = argv[++arg];
+		else
+			break;
+	}
+	if(arg + 1 != argc)
+	{
+		printf("Usage : %s [-f [-w]] [-n count] [-c context] [-b other_build] image\n", argv[0]);
+		printf("        %s -t [-f [-w]] [-n count] image\n", argv[0]);
+		return 1;
+	}
+	if(op.count <= 0)
+		op.count = op.frames ? 3000 : 1000000;
+	signal(SIGPIPE, SIG_IGN);
+	if(trace)
+		return Trace(argv[arg], op);
+	return Compare(argv[0], argv[arg], op);
+}
+
+#endif//USE_LOCKSTEP && !_WINDOWS
@@ -0,0 +1,128 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2013 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../platform.h"
+#include "../../tools/tick.h"
+#include "../../file_type.h"
+#include "../../snapshot/snapshot_pack.h"
+
+#ifdef USE_PACK_TOOL
+
+static bool IsSnapshot(const char* name)
+{
+	const xPlatform::eFileType* t = xPlatform::eFileType::FindByName(name);
+	if(!t)
+		return false;
+	return !strcmp(t->Type(), "sna") || !strcmp(t->Type(), "z80") || !strcmp(t->Type(), "szx");
+}
+
+static const char* BaseName(const char* name)
+{
+	const char* s = strrchr(name, '/');
+	const char* bs = strrchr(name, '\\');
+	if(bs > s)
+		s = bs;
+	return s ? s + 1 : name;
+}
+
+int main(int argc, char* argv[])
+{
+	if(argc < 3)
+	{
+		printf("Usage : %s pack_name.spk snapshot_name...\n", argv[0]);
+		return 1;
+	}
+	int r = 0;
+	using namespace xPlatform;
+	Handler()->OnInit();
+	xSnapshot::ePackWriter pack;
+	if(!pack.Open(argv[1]))
+	{
+		printf("Error : %s - can't create\n", argv[1]);
+		Handler()->OnDone();
+		return 1;
+	}
+	int count = 0;
+	for(int i = 2; i < argc; ++i)
+	{
+		if(!IsSnapshot(argv[i]))
+		{
+			printf("Skipping : %s - not a snapshot\n", argv[i]);
+			continue;
+		}
+		if(!Handler()->OnOpenFile(argv[i]) || !pack.Add(Handler()->Speccy(), BaseName(argv[i])))
+		{
+			printf("Error : %s - can't pack\n", argv[i]);
+			r = 1;
+			continue;
+		}
+		++count;
+	}
+	if(!pack.Close())
+	{
+		printf("Error : %s - write failed\n", argv[1]);
+		r = 1;
+	}
+	printf("%d snapshot(s) packed to %s\n", count, argv[1]);
+
+	// read back and time each restore
+	FILE* f = fopen(argv[1], "rb");
+	if(f && count)
+	{
+		fseek(f, 0, SEEK_END);
+		size_t size = ftell(f);
+		fseek(f, 0, SEEK_SET);
+		byte* data = new byte[size];
+		if(fread(data, 1, size, f) == size)
+		{
+#ifndef USE_STREAM
+			int n = xSnapshot::PackCount(data, size);
+#else
+			struct stream* s = memory_stream_open(data, size, false);
+			int n = xSnapshot::PackCount(s);
+#endif
+			eTick tick_start;
+			tick_start.SetCurrent();
+			for(int e = 0; e < n; ++e)
+			{
+#ifndef USE_STREAM
+				if(!xSnapshot::LoadPack(Handler()->Speccy(), data, size, e))
+#else
+				if(!xSnapshot::LoadPack(Handler()->Speccy(), s, e))
+#endif
+				{
+					printf("Error : entry %d - can't load\n", e);
+					r = 1;
+				}
+			}
+			float t = tick_start.Passed().Ms();
+			printf("%d entries restored in %g ms (%g us per entry)\n", n, t, n ? t*1000.0f/n : 0.0f);
+#ifdef USE_STREAM
+			stream_close(s);
+#endif
+		}
+		delete[] data;
+	}
+	if(f)
+		fclose(f);
+	Handler()->OnDone();
+	return r;
+}
+
+#endif//USE_PACK_TOOL
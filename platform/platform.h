@@ -76,7 +76,7 @@ enum eAction
 {
 	A_RESET,
 #ifndef NO_USE_TAPE
-	A_TAPE_TOGGLE, A_TAPE_QUERY, A_TAPE_REWIND
+	A_TAPE_TOGGLE, A_TAPE_QUERY, A_TAPE_REWIND,
 #endif
 #ifndef NO_USE_FDD
 	A_DISK_QUERY
@@ -120,6 +120,8 @@ struct eHandler
 
 #ifndef NO_USE_REPLAY
 	virtual bool GetReplayProgress(dword* frame_current, dword* frames_total, dword* frames_cached) = 0;
+	// plays the rest of the open replay as fast as possible, checking sync every frame. NULL if it played to the end
+	virtual const char* ReplayVerify(dword* frames) = 0;
 #endif
 
 	// data to draw
@@ -0,0 +1,427 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2013 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../platform.h"
+#include "../io.h"
+#include "../../tools/tick.h"
+#include "../../tools/io_select.h"
+#include "../../file_type.h"
+#include "../../speccy.h"
+#include "../../z80/z80.h"
+#include "../../devices/ula.h"
+#include "../../snapshot/snapshot.h"
+
+#ifdef USE_VALIDATOR
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+
+// Each image runs in a worker process which owns the one machine the handler provides; worker processes are fed
+// and drained by one thread each. A crashing or asserting image only takes down its worker, which is restarted.
+// .rzx recordings ignore the frame count and are replayed to the end, checking they stay in sync.
+
+namespace xValidate
+{
+
+struct eResult
+{
+	eResult() : ok(false), frames(0), screen_hash(0), ms(0) {}
+	std::string name;
+	std::string type;
+	bool ok;
+	std::string error;
+	int frames;
+	dword screen_hash;
+	float ms;
+};
+
+struct eOptions
+{
+	eOptions() : frames(250), threads(0), out_dir(NULL), report(NULL) {}
+	int frames;
+	int threads;
+	const char* out_dir;
+	const char* report;
+};
+
+struct eZ80Probe : public xZ80::eZ80
+{
+	// DI; HALT - nothing but NMI gets the machine out of this
+	bool Hung() const
+	{
+#ifndef USE_Z80_ARM
+		return halted && !iff1;
+#else
+		return z80a_resting_state.halted && !z80a_resting_state.iff1;
+#endif
+	}
+};
+
+static void Collect(const char* path, std::vector<std::string>& files)
+{
+	xIo::eFileSelect* fs = xIo::FileSelect(path);
+	for(; fs->Valid(); fs->Next())
+	{
+		const char* name = fs->Name();
+		if(name[0] == '.')
+			continue;
+		std::string full = std::string(path) + name;
+		if(fs->IsDir())
+			Collect((full + "/").c_str(), files);
+		else if(fs->IsFile() && xPlatform::eFileType::FindByName(name))
+			files.push_back(full);
+	}
+	SAFE_DELETE(fs);
+}
+
+// fnv-1a over border, attributes and pixels of every visible line
+static dword ScreenHash(eSpeccy* speccy)
+{
+	eUla* ula = speccy->Device<eUla>();
+	dword h = 2166136261u;
+	for(int l = -24; l < 192 + 24; ++l)
+	{
+		byte border;
+		const byte* attr;
+		const byte* pixels;
+		ula->GetLineInfo(l, border, attr, pixels);
+		h = (h ^ border) * 16777619u;
+		if(!pixels)
+			continue;
+		for(int i = 0; i < 32; ++i)
+		{
+			h = (h ^ pixels[i]) * 16777619u;
+			h = (h ^ attr[i]) * 16777619u;
+		}
+	}
+	return h;
+}
+
+static const char* Extension(const char* name)
+{
+	const char* ext = strrchr(name, '.');
+	return ext ? ext + 1 : "";
+}
+
+static eResult Run(const std::string& name, const eOptions& op)
+{
+	using namespace xPlatform;
+	eResult r;
+	r.name = name;
+	const eFileType* t = eFileType::FindByName(name.c_str());
+	r.type = t ? t->Type() : Extension(name.c_str());
+	eTick tick_start;
+	tick_start.SetCurrent();
+	Handler()->OnAction(A_RESET);
+	if(!Handler()->OnOpenFile(name.c_str()))
+	{
+		r.error = "load";
+		return r;
+	}
+#ifndef NO_USE_SAVE
+	if(op.out_dir && eFileType::Find("sna") && r.type != "tap" && r.type != "tzx" && r.type != "csw" && r.type != "rzx")
+	{
+		// canonical copy of the state as loaded
+		const char* base = strrchr(name.c_str(), '/');
+		std::string out = std::string(op.out_dir) + (base ? base + 1 : name.c_str()) + ".sna";
+		if(!eFileType::Find("sna")->Store(out.c_str()))
+		{
+			r.error = "store";
+			return r;
+		}
+	}
+#endif
+#ifndef NO_USE_REPLAY
+	if(r.type == "rzx")
+	{
+		// whole recording, as fast as it goes
+		dword frames = 0;
+		const char* error = Handler()->ReplayVerify(&frames);
+		r.frames = frames;
+		if(error)
+		{
+			r.error = error;
+			r.ms = tick_start.Passed().Ms();
+			return r;
+		}
+	}
+	else
+#endif
+	for(; r.frames < op.frames; ++r.frames)
+	{
+		Handler()->OnLoop();
+	}
+	r.screen_hash = ScreenHash(Handler()->Speccy());
+	r.ms = tick_start.Passed().Ms();
+	if(((eZ80Probe*)Handler()->Speccy()->CPU())->Hung())
+		r.error = "hung";
+	else
+		r.ok = true;
+	return r;
+}
+
+// worker side: reads image indices from in_fd, writes one result line per image to out_fd
+static void Worker(int in_fd, int out_fd, const std::vector<std::string>& files, const eOptions& op)
+{
+	FILE* in = fdopen(in_fd, "r");
+	FILE* out = fdopen(out_fd, "w");
+	int index;
+	while(fscanf(in, "%d", &index) == 1)
+	{
+		eResult r = Run(files[index], op);
+		fprintf(out, "%d\t%d\t%s\t%d\t%08x\t%.3f\n", index, r.ok, r.error.c_str(), r.frames, r.screen_hash, r.ms);
+		fflush(out);
+	}
+	// no OnDone() - workers must not race each other storing options
+	_exit(0);
+}
+
+// fork() copies every descriptor, so each worker has to close the parent's ends of the other workers' pipes or
+// they never see end of input
+static std::mutex spawn_lock;
+static std::vector<int> parent_fds;
+
+struct eWorker
+{
+	eWorker() : pid(-1), in(NULL), out(NULL) {}
+	pid_t pid;
+	FILE* in;	// indices to the worker
+	FILE* out;	// results from the worker
+	bool Start(const std::vector<std::string>& files, const eOptions& op)
+	{
+		std::lock_guard<std::mutex> lock(spawn_lock);
+		int to_worker[2], from_worker[2];
+		if(pipe(to_worker))
+			return false;
+		if(pipe(from_worker))
+		{
+			close(to_worker[0]);
+			close(to_worker[1]);
+			return false;
+		}
+		fflush(NULL);
+		pid = fork();
+		if(!pid)
+		{
+			for(size_t i = 0; i < parent_fds.size(); ++i)
+				close(parent_fds[i]);
+			close(to_worker[1]);
+			close(from_worker[0]);
+			xPlatform::Handler()->OnInit();
+			Worker(to_worker[0], from_worker[1], files, op);
+		}
+		close(to_worker[0]);
+		close(from_worker[1]);
+		if(pid < 0)
+		{
+			close(to_worker[1]);
+			close(from_worker[0]);
+			return false;
+		}
+		parent_fds.push_back(to_worker[1]);
+		parent_fds.push_back(from_worker[0]);
+		in = fdopen(to_worker[1], "w");
+		out = fdopen(from_worker[0], "r");
+		return in && out;
+	}
+	void Stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(spawn_lock);
+			for(size_t i = 0; i < parent_fds.size();)
+			{
+				if((in && parent_fds[i] == fileno(in)) || (out && parent_fds[i] == fileno(out)))
+					parent_fds.erase(parent_fds.begin() + i);
+				else
+					++i;
+			}
+			if(in)
+				fclose(in);
+			if(out)
+				fclose(out);
+			in = out = NULL;
+		}
+		if(pid > 0)
+			waitpid(pid, NULL, 0);
+		pid = -1;
+	}
+};
+
+static void Drive(const std::vector<std::string>& files, const eOptions& op, std::vector<eResult>& results, std::atomic<int>& next)
+{
+	eWorker w;
+	for(int index; (index = next++) < (int)files.size();)
+	{
+		eResult& r = results[index];
+		r.name = files[index];
+		const xPlatform::eFileType* t = xPlatform::eFileType::FindByName(files[index].c_str());
+		r.type = t ? t->Type() : Extension(files[index].c_str());
+		if(w.pid < 0 && !w.Start(files, op))
+		{
+			r.error = "spawn";
+			continue;
+		}
+		fprintf(w.in, "%d\n", index);
+		fflush(w.in);
+		char line[256];
+		char error[64] = "";
+		int i = -1, ok = 0;
+		if(fgets(line, sizeof(line), w.out) && sscanf(line, "%d\t%d\t%63[^\t]\t%d\t%x\t%f", &i, &ok, error, &r.frames, &r.screen_hash, &r.ms) >= 2 && i == index)
+		{
+			r.ok = ok != 0;
+			r.error = ok ? "" : error;
+			// an empty error field makes sscanf stop early
+			if(ok && sscanf(line, "%d\t%d\t\t%d\t%x\t%f", &i, &ok, &r.frames, &r.screen_hash, &r.ms) != 5)
+				r.ok = false, r.error = "protocol";
+		}
+		else
+		{
+			r.error = "crash";
+			w.Stop();
+		}
+	}
+	w.Stop();
+}
+
+static std::string Json(const std::string& s)
+{
+	std::string r;
+	for(size_t i = 0; i < s.size(); ++i)
+	{
+		char c = s[i];
+		if(c == '"' || c == '\\')
+			r += '\\', r += c;
+		else if((byte)c < 0x20)
+		{
+			char b[8];
+			sprintf(b, "\\u%04x", c);
+			r += b;
+		}
+		else
+			r += c;
+	}
+	return r;
+}
+
+static bool Report(const char* name, const std::vector<eResult>& results)
+{
+	FILE* f = strcmp(name, "-") ? fopen(name, "w") : stdout;
+	if(!f)
+		return false;
+	fprintf(f, "[\n");
+	for(size_t i = 0; i < results.size(); ++i)
+	{
+		const eResult& r = results[i];
+		fprintf(f, "  {\"file\": \"%s\", \"type\": \"%s\", \"ok\": %s, \"error\": \"%s\", \"frames\": %d, \"screen_hash\": \"%08x\", \"ms\": %.3f}%s\n",
+				Json(r.name).c_str(), Json(r.type).c_str(), r.ok ? "true" : "false", Json(r.error).c_str(),
+				r.frames, r.screen_hash, r.ms, i + 1 < results.size() ? "," : "");
+	}
+	fprintf(f, "]\n");
+	return f == stdout || !fclose(f);
+}
+
+}
+//namespace xValidate
+
+int main(int argc, char* argv[])
+{
+	using namespace xValidate;
+	eOptions op;
+	int arg = 1;
+	for(; arg < argc && argv[arg][0] == '-' && argv[arg][1]; ++arg)
+	{
+		const char* a = argv[arg];
+		if(arg + 1 >= argc)
+			break;
+		if(!strcmp(a, "-f"))
+			op.frames = atoi(argv[++arg]);
+		else if(!strcmp(a, "-j"))
+			op.threads = atoi(argv[++arg]);
+#ifndef NO_USE_SAVE
+		else if(!strcmp(a, "-o"))
+			op.out_dir = argv[++arg];
+#endif
+		else if(!strcmp(a, "-r"))
+			op.report = argv[++arg];
+		else
+			break;
+	}
+	if(arg >= argc)
+	{
+#ifndef NO_USE_SAVE
+		printf("Usage : %s [-f frames] [-j threads] [-o store_dir/] [-r report.json] image_or_dir...\n", argv[0]);
+#else
+		printf("Usage : %s [-f frames] [-j threads] [-r report.json] image_or_dir...\n", argv[0]);
+#endif
+		return 1;
+	}
+	std::vector<std::string> files;
+	for(; arg < argc; ++arg)
+	{
+		std::string path = argv[arg];
+		xIo::eFileSelect* fs = xIo::FileSelect((path + "/").c_str());
+		bool dir = fs->Valid();
+		SAFE_DELETE(fs);
+		if(dir)
+			Collect((path + "/").c_str(), files);
+		else
+			files.push_back(path);
+	}
+	if(op.threads <= 0)
+		op.threads = std::thread::hardware_concurrency();
+	if(op.threads <= 0)
+		op.threads = 1;
+	signal(SIGPIPE, SIG_IGN);
+
+	eTick tick_start;
+	tick_start.SetCurrent();
+	std::vector<eResult> results(files.size());
+	std::atomic<int> next(0);
+	std::vector<std::thread> drivers;
+	for(int i = 0; i < op.threads && i < (int)files.size(); ++i)
+		drivers.push_back(std::thread(Drive, std::cref(files), std::cref(op), std::ref(results), std::ref(next)));
+	for(size_t i = 0; i < drivers.size(); ++i)
+		drivers[i].join();
+	float t = tick_start.Passed().Sec();
+
+	int failed = 0;
+	for(size_t i = 0; i < results.size(); ++i)
+	{
+		if(!results[i].ok)
+		{
+			printf("FAIL %s (%s)\n", results[i].name.c_str(), results[i].error.c_str());
+			++failed;
+		}
+	}
+	printf("%d images, %d failed, %d threads, %g sec. (%g images/sec)\n", (int)files.size(), failed, op.threads, t, t > 0 ? files.size() / t : 0.0f);
+	if(op.report && !Report(op.report, results))
+	{
+		printf("Error : %s - can't write report\n", op.report);
+		return 1;
+	}
+	return failed ? 2 : 0;
+}
+
+#endif//USE_VALIDATOR
@@ -43,24 +43,38 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../options_common.h"
 #include "rzx.h"
 
+#ifndef USE_STREAM
 #ifdef USE_ZIP
 #include <zlib.h>
-#endif
+#define RZX_INFLATE
+#endif//USE_ZIP
+#else
+#include "miniz_tinfl.h"
+#define RZX_INFLATE
+#endif//USE_STREAM
 
 class eRZX::eImpl
 {
 public:
-	eImpl() : status(0), file(NULL), handler(NULL), frames_in_block(0), frames_total(0), frame_current(0), INmax(0), INcount(0), INold(0)
+	eImpl() : status(0), file(NULL), handler(NULL), frames_in_block(0), frames_total(0), frame_current(0), INmax(0), INcount(0), INold(0), INlost(false)
 		, inputbuffer(NULL)
+#ifndef USE_STREAM
 #ifdef USE_ZIP
 		,zbuf(NULL)
 #endif//USE_ZIP
+#else
+		,inflator(NULL), zdict(NULL), zdict_pos(0), zdict_avail(0), zstatus(TINFL_STATUS_DONE)
+#endif//USE_STREAM
 	{}
 	~eImpl() { Close(); }
+#ifndef USE_STREAM
 	eError Open(const void* data, size_t data_size, eHandler* handler);
+#else
+	eError Open(struct stream* stream, eHandler* handler);
+#endif
 	eError Update(int* icount);
 	eError IoRead(byte* data);
-	eError CheckSync() const { return INcount == INmax ? E_OK : E_SYNC_LOST; }
+	eError CheckSync() const { return INcount == INmax && !INlost ? E_OK : E_SYNC_LOST; }
 	eError GetProgress(dword* _frame_current, dword* _frames_total, dword* _frames_cached) const
 	{
 		*_frame_current = frame_current;
@@ -70,6 +84,7 @@ public:
 	}
 
 private:
+#ifndef USE_STREAM
 	class eStream : public xIo::eStreamMemory
 	{
 	public:
@@ -87,6 +102,52 @@ private:
 			SAFE_DELETE_ARRAY(data);
 		}
 	};
+#else
+	// reads forward through the stream as the replay advances, so only the current block is ever in memory;
+	// seeking backwards (only done once, after counting the frames on open) restarts the stream
+	class eStream
+	{
+	public:
+		eStream(struct stream* _stream) : stream(_stream), pos(0) {}
+		~eStream() { stream_close(stream); }
+		size_t Read(void* dst, size_t size)
+		{
+			int32_t r = stream_read(stream, (uint8_t*)dst, size, true);
+			if(r <= 0)
+				return 0;
+			pos += r;
+			return r;
+		}
+		const byte* Peek(size_t* available)
+		{
+			const byte* p = stream_peek_avail(stream, 1, available, NULL);
+			if(!p)
+				*available = 0;
+			return p;
+		}
+		bool Skip(size_t size)
+		{
+			if(!stream_skip(stream, size))
+				return false;
+			pos += size;
+			return true;
+		}
+		int Seek(size_t offset)
+		{
+			if(offset < pos)
+			{
+				stream_reset(stream);
+				pos = 0;
+			}
+			return Skip(offset - pos) ? 0 : -1;
+		}
+		size_t Pos() const { return pos; }
+		size_t Size() const { return stream->size; }
+	private:
+		struct stream* stream;
+		size_t pos;
+	};
+#endif//USE_STREAM
 	enum eBlockId
 	{
 		RZXBLK_CREATOR	= 0x10,
@@ -126,16 +187,27 @@ private:
 	word INmax;
 	word INcount;
 	word INold;
+	bool INlost; // more port reads in the frame than were recorded
 	byte* inputbuffer;
 
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
+#ifndef USE_STREAM
 	enum { ZBUFLEN = 16384 };
 	z_stream zs;
 	byte* zbuf;
+#else
+	// output ring holding the whole deflate window, input comes straight from the stream
+	enum { ZDICTLEN = 32768 };
+	tinfl_decompressor* inflator;
+	byte* zdict;
+	size_t zdict_pos;
+	size_t zdict_avail;
+	tinfl_status zstatus;
+#endif//USE_STREAM
 	int ZipOpen();
 	int ZipRead(byte* buffer, int len);
 	int ZipClose();
-#endif//USE_ZIP
+#endif//RZX_INFLATE
 	eError ReadBlock(bool test_IRB = false);
 	void Close();
 };
@@ -143,6 +215,7 @@ private:
 
 /* ======================================================================== */
 
+#ifndef USE_STREAM
 #ifdef USE_ZIP
 int eRZX::eImpl::ZipRead(byte *buffer, int len)
 {
@@ -186,6 +259,56 @@ int eRZX::eImpl::ZipOpen()
 	return 0;
 }
 #endif//USE_ZIP
+#else//USE_STREAM
+int eRZX::eImpl::ZipRead(byte* buffer, int len)
+{
+	int done = 0;
+	while(done < len)
+	{
+		if(zdict_avail)
+		{
+			// pending output always ends at zdict_pos
+			size_t size = zdict_avail < size_t(len - done) ? zdict_avail : len - done;
+			memcpy(buffer + done, zdict + ((zdict_pos - zdict_avail) & (ZDICTLEN - 1)), size);
+			zdict_avail -= size;
+			done += size;
+			continue;
+		}
+		if(zstatus != TINFL_STATUS_NEEDS_MORE_INPUT && zstatus != TINFL_STATUS_HAS_MORE_OUTPUT)
+			break;
+		size_t in_bytes = 0;
+		const byte* in = file->Peek(&in_bytes);
+		size_t out_bytes = ZDICTLEN - zdict_pos;
+		zstatus = tinfl_decompress(inflator, in, &in_bytes, zdict, zdict + zdict_pos, &out_bytes,
+				TINFL_FLAG_PARSE_ZLIB_HEADER | (in_bytes ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+		file->Skip(in_bytes);
+		if(!in_bytes && !out_bytes)
+			break;
+		zdict_pos = (zdict_pos + out_bytes) & (ZDICTLEN - 1);
+		zdict_avail = out_bytes;
+	}
+	return done;
+}
+
+int eRZX::eImpl::ZipClose()
+{
+	SAFE_DELETE(inflator);
+	SAFE_DELETE_ARRAY(zdict);
+	zstatus = TINFL_STATUS_DONE;
+	return 0;
+}
+
+int eRZX::eImpl::ZipOpen()
+{
+	assert(!inflator);
+	inflator = new tinfl_decompressor;
+	zdict = new byte[ZDICTLEN];
+	tinfl_init(inflator);
+	zdict_pos = zdict_avail = 0;
+	zstatus = TINFL_STATUS_NEEDS_MORE_INPUT;
+	return 0;
+}
+#endif//USE_STREAM
 
 eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 {
@@ -209,7 +332,7 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 				if(!(block.buff[0] & 0x01))
 				{
 					/* embedded snap */
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 					bool compressed = (block.buff[0] & 0x02) != 0;
 					fpos = file->Pos();
 					ZipOpen();
@@ -222,7 +345,7 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 					while(fpos > 0)
 					{
 						done = (fpos > RZXBLKBUF) ? RZXBLKBUF : fpos;
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 						if(compressed)
 							ZipRead(block.buff, done);
 						else
@@ -232,7 +355,7 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 						snap_pos += done;
 						fpos -= done;
 					}
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 					ZipClose();
 #endif
 					done = 0;
@@ -248,6 +371,9 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 					const char* snap_fullname = (const char*)block.buff + 16;
 					if(!handler->RZX_OnOpenSnapshot(snap_fullname, NULL, 0))
 					{
+#ifdef USE_MU_SIMPLIFICATIONS
+						return E_UNSUPPORTED; // no last folder to look in
+#else
 						// trying to open snapshot from the same folder where .rzx placed
 						int l = strlen(snap_fullname);
 						while(l >= 0 && snap_fullname[l] != '/' && snap_fullname[l] != '\\')
@@ -256,6 +382,7 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 						strcat(snap_filename, snap_fullname + l + 1);
 						if(!handler->RZX_OnOpenSnapshot(snap_filename, NULL, 0))
 							return E_UNSUPPORTED;
+#endif
 					}
 				}
 			}
@@ -277,9 +404,9 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 				status &= ~RZX_PACK;
 
 			if(status & RZX_PACK)
-#ifndef USE_ZIP
+#ifndef RZX_INFLATE
 				return E_UNSUPPORTED;
-#else//USE_ZIP
+#else//RZX_INFLATE
 			{
 				fpos = file->Pos();
 				ZipOpen();
@@ -298,10 +425,17 @@ eRZX::eError eRZX::eImpl::ReadBlock(bool test_IRB)
 }
 
 
+#ifndef USE_STREAM
 eRZX::eError eRZX::eImpl::Open(const void* _data, size_t _data_size, eHandler* _handler)
 {
 	assert(!file);
 	file = new eStream(_data, _data_size);
+#else
+eRZX::eError eRZX::eImpl::Open(struct stream* _stream, eHandler* _handler)
+{
+	assert(!file);
+	file = new eStream(_stream);
+#endif
 	handler = _handler;
 	if(!handler)
 		return E_INVALID;
@@ -349,9 +483,9 @@ eRZX::eError eRZX::eImpl::Open(const void* _data, size_t _data_size, eHandler* _
 
 void eRZX::eImpl::Close()
 {
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 	ZipClose();
-#endif//USE_ZIP
+#endif//RZX_INFLATE
 	SAFE_DELETE(file);
 	status = RZX_INIT;
 	SAFE_DELETE_ARRAY(inputbuffer);
@@ -366,9 +500,9 @@ eRZX::eError eRZX::eImpl::Update(int* icount)
 	/* need to seek another IRB? */
 	if(!(status & RZX_IRB))
 	{
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 		ZipClose();
-#endif//USE_ZIP
+#endif//RZX_INFLATE
 		block.start += block.length;
 		if(file->Seek(block.start) != 0) // bugfix with possible buffer overread when readed zipped data
 			return E_INVALID;
@@ -383,7 +517,7 @@ eRZX::eError eRZX::eImpl::Update(int* icount)
 
 	/* fetch the instruction and IN counters */
 	INold = INmax;
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 	if(status & RZX_PACK)
 		ZipRead(block.buff, 4);
 	else
@@ -397,17 +531,18 @@ eRZX::eError eRZX::eImpl::Update(int* icount)
 	{
 		if(INmax)
 		{
-#ifdef USE_ZIP
+#ifdef RZX_INFLATE
 			if(status & RZX_PACK)
 				ZipRead(inputbuffer, INmax);
 			else
-#endif//USE_ZIP
+#endif//RZX_INFLATE
 				file->Read(inputbuffer, INmax);
 		}
 	}
 	else
 		INmax = INold;
 	INcount = 0;
+	INlost = false;
 	--frames_in_block;
 	++frame_current;
 	return E_OK;
@@ -415,14 +550,21 @@ eRZX::eError eRZX::eImpl::Update(int* icount)
 eRZX::eError eRZX::eImpl::IoRead(byte* data)
 {
 	if(INcount >= INmax)
+	{
+		INlost = true;
 		return E_SYNC_LOST;
+	}
 	*data = inputbuffer[INcount++];
 	return E_OK;
 }
 
 eRZX::eRZX() { impl = new eImpl; }
 eRZX::~eRZX() { delete impl; }
+#ifndef USE_STREAM
 eRZX::eError eRZX::Open(const void* data, size_t data_size, eHandler* handler) { return impl->Open(data, data_size, handler); }
+#else
+eRZX::eError eRZX::Open(struct stream* stream, eHandler* handler) { return impl->Open(stream, handler); }
+#endif
 eRZX::eError eRZX::Update(int* icount) { return impl->Update(icount); }
 eRZX::eError eRZX::IoRead(byte* data) { return impl->IoRead(data); }
 eRZX::eError eRZX::CheckSync() const { return impl->CheckSync(); }
@@ -21,6 +21,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "../std_types.h"
 
+#ifdef USE_STREAM
+#include "stream.h"
+#endif
+
 class eRZX
 {
 public:
@@ -35,7 +39,12 @@ public:
 		virtual bool RZX_OnOpenSnapshot(const char* name, const void* data, size_t data_size) = 0;
 	};
 
+#ifndef USE_STREAM
 	eError Open(const void* data, size_t data_size, eHandler* handler);
+#else
+	// blocks are read from the stream as the replay advances (the stream is owned and closed by eRZX)
+	eError Open(struct stream* stream, eHandler* handler);
+#endif
 	eError Update(int* icount);
 	eError IoRead(byte* data);
 	eError CheckSync() const;
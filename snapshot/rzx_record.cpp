@@ -0,0 +1,254 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2015 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../std.h"
+#include "../speccy.h"
+#include "snapshot.h"
+#include "rzx_record.h"
+
+#ifndef NO_USE_REPLAY
+#ifndef NO_USE_SAVE
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+
+#ifdef USE_ZIP
+#include <zlib.h>
+#endif
+
+enum
+{
+	RZXBLK_CREATOR	= 0x10,
+	RZXBLK_SNAP		= 0x30,
+	RZXBLK_DATA		= 0x80,
+	// fetch count and IN count words, then the values. an IN count of 0xffff means "as last frame", so stop short
+	FRAME_MAX		= 4 + 0xfffe,
+	BLOCK_SIZE		= 256*1024 + FRAME_MAX,
+};
+
+static void PutDword(byte* p, dword v)
+{
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+//=============================================================================
+//	eRZXRecorder::eImpl - compresses and writes out blocks on its own thread
+//-----------------------------------------------------------------------------
+class eRZXRecorder::eImpl
+{
+public:
+	eImpl(FILE* _file) : file(_file), done(false)
+	{
+		byte h[10 + 29];
+		memcpy(h, "RZX!", 4);
+		h[4] = 0; h[5] = 13;
+		PutDword(h + 6, 0);
+		h[10] = RZXBLK_CREATOR;
+		PutDword(h + 11, 29);
+		memset(h + 15, 0, 24);
+		strcpy((char*)h + 15, "Unreal Speccy");
+		fwrite(h, 1, sizeof(h), file);
+		thread = std::thread(&eImpl::Run, this);
+	}
+	~eImpl()
+	{
+		{
+			std::lock_guard<std::mutex> l(lock);
+			done = true;
+		}
+		ready.notify_one();
+		thread.join();
+		fclose(file);
+	}
+	// takes ownership of data
+	void Queue(byte type, byte* data, size_t size, dword frames)
+	{
+		eJob j = { type, data, size, frames };
+		{
+			std::lock_guard<std::mutex> l(lock);
+			jobs.push_back(j);
+		}
+		ready.notify_one();
+	}
+
+private:
+	struct eJob
+	{
+		byte type;
+		byte* data;
+		size_t size;
+		dword frames;
+	};
+	void Run()
+	{
+		for(;;)
+		{
+			eJob j;
+			{
+				std::unique_lock<std::mutex> l(lock);
+				while(jobs.empty() && !done)
+					ready.wait(l);
+				if(jobs.empty())
+					return;
+				j = jobs.front();
+				jobs.pop_front();
+			}
+			Write(j);
+			SAFE_DELETE_ARRAY(j.data);
+		}
+	}
+	void Write(const eJob& j)
+	{
+		const byte* data = j.data;
+		size_t size = j.size;
+		bool packed = false;
+#ifdef USE_ZIP
+		uLongf packed_size = compressBound(j.size);
+		byte* packed_data = new byte[packed_size];
+		if(compress2(packed_data, &packed_size, j.data, j.size, Z_DEFAULT_COMPRESSION) == Z_OK && packed_size < j.size)
+		{
+			data = packed_data;
+			size = packed_size;
+			packed = true;
+		}
+#endif//USE_ZIP
+		byte h[18];
+		size_t h_size;
+		h[0] = j.type;
+		if(j.type == RZXBLK_SNAP)
+		{
+			h_size = 17;
+			PutDword(h + 5, packed ? 0x02 : 0);
+			memcpy(h + 9, "sna", 4);
+			PutDword(h + 13, j.size);
+		}
+		else
+		{
+			h_size = 18;
+			PutDword(h + 5, j.frames);
+			h[9] = 0;
+			PutDword(h + 10, 0);
+			PutDword(h + 14, packed ? 0x02 : 0);
+		}
+		PutDword(h + 1, h_size + size);
+		fwrite(h, 1, h_size, file);
+		fwrite(data, 1, size, file);
+		// file is always complete up to the last block
+		fflush(file);
+#ifdef USE_ZIP
+		SAFE_DELETE_ARRAY(packed_data);
+#endif//USE_ZIP
+	}
+
+	FILE* file;
+	std::thread thread;
+	std::mutex lock;
+	std::condition_variable ready;
+	std::deque<eJob> jobs;
+	bool done;
+};
+
+//=============================================================================
+//	eRZXRecorder
+//-----------------------------------------------------------------------------
+eRZXRecorder::eRZXRecorder() : impl(NULL), speccy(NULL), block(NULL), frame(NULL), in_pos(NULL), in_end(NULL)
+	, block_frames(0), snapshot_frames(0)
+{
+}
+eRZXRecorder::~eRZXRecorder()
+{
+	Close();
+}
+bool eRZXRecorder::Open(const char* name, eSpeccy* _speccy)
+{
+	Close();
+	FILE* f = fopen(name, "wb");
+	if(!f)
+		return false;
+	impl = new eImpl(f);
+	speccy = _speccy;
+	BlockBegin();
+	Snapshot();
+	return true;
+}
+void eRZXRecorder::Close()
+{
+	if(!speccy)
+		return;
+	speccy->CPU()->RecordFrame();
+	speccy->CPU()->HandlerRecord(NULL);
+	BlockEnd();
+	SAFE_DELETE(impl); // waits for everything queued to be written
+	speccy = NULL;
+}
+void eRZXRecorder::Update()
+{
+	if(++snapshot_frames >= SNAPSHOT_FRAMES)
+		Snapshot();
+}
+void eRZXRecorder::Z80_FrameRecord(int fetches)
+{
+	dword ins = in_pos - (frame + 4);
+	frame[0] = fetches;
+	frame[1] = fetches >> 8;
+	frame[2] = ins;
+	frame[3] = ins >> 8;
+	frame = in_pos;
+	++block_frames;
+	if(block_frames >= BLOCK_FRAMES || block + BLOCK_SIZE - frame < FRAME_MAX)
+	{
+		BlockEnd();
+		BlockBegin();
+	}
+	in_pos = frame + 4;
+	in_end = frame + FRAME_MAX;
+}
+void eRZXRecorder::BlockBegin()
+{
+	block = new byte[BLOCK_SIZE];
+	frame = block;
+	in_pos = frame + 4;
+	in_end = frame + FRAME_MAX;
+	block_frames = 0;
+}
+void eRZXRecorder::BlockEnd()
+{
+	if(block_frames)
+		impl->Queue(RZXBLK_DATA, block, frame - block, block_frames);
+	else
+		SAFE_DELETE_ARRAY(block);
+	block = NULL;
+}
+void eRZXRecorder::Snapshot()
+{
+	// the frame in progress is dropped, replay goes on from the snapshot
+	speccy->CPU()->HandlerRecord(this);
+	BlockEnd();
+	byte* sna = new byte[xSnapshot::STORE_MAX_SIZE];
+	size_t size = xSnapshot::Store(speccy, sna);
+	assert(size);
+	impl->Queue(RZXBLK_SNAP, sna, size, 0);
+	BlockBegin();
+	snapshot_frames = 0;
+}
+
+#endif//NO_USE_SAVE
+#endif//NO_USE_REPLAY
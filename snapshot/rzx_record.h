@@ -0,0 +1,79 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2015 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __RZX_RECORD_H__
+#define __RZX_RECORD_H__
+
+#include "../z80/z80.h"
+
+#pragma once
+
+#ifndef NO_USE_REPLAY
+#ifndef NO_USE_SAVE
+
+class eSpeccy;
+
+//*****************************************************************************
+//	eRZXRecorder
+//-----------------------------------------------------------------------------
+// Records the fetch count and port reads of every frame straight into the current input recording block; full
+// blocks (and the snapshots taken every SNAPSHOT_FRAMES) are compressed and written out by a worker thread, so the
+// file is valid up to the last completed block at any time.
+class eRZXRecorder : public xZ80::eZ80::eHandlerRecord
+{
+public:
+	enum { BLOCK_FRAMES = 500, SNAPSHOT_FRAMES = 50*60 };
+
+	eRZXRecorder();
+	~eRZXRecorder();
+
+	// starts recording from the current state (snapshotted first)
+	bool Open(const char* name, eSpeccy* speccy);
+	void Close();
+	// call after each eSpeccy::Update()
+	void Update();
+	bool Recording() const { return speccy != NULL; }
+
+	virtual void Z80_IoRecord(byte v)
+	{
+		if(in_pos < in_end)
+			*in_pos++ = v;
+	}
+	virtual void Z80_FrameRecord(int fetches);
+
+private:
+	class eImpl;
+	void BlockBegin();
+	void BlockEnd();
+	void Snapshot();
+
+	eImpl* impl;
+	eSpeccy* speccy;
+	byte* block;		// current input recording block
+	byte* frame;		// current frame header within it
+	byte* in_pos;
+	byte* in_end;
+	dword block_frames;
+	dword snapshot_frames;
+};
+
+#endif//NO_USE_SAVE
+#endif//NO_USE_REPLAY
+
+#endif//__RZX_RECORD_H__
@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../platform/platform.h"
 
 #include "snapshot.h"
+#include "snapshot_pack.h"
 
 namespace xSnapshot
 {
@@ -70,6 +71,11 @@ struct eSnapshot_SNA {
 #endif
 	};
 };
+#ifndef NO_USE_128K
+static_assert(sizeof(eSnapshot_SNA) == eSnapshot_SNA::S_128_6, "sna layout doesn't match the file format");
+#else
+static_assert(sizeof(eSnapshot_SNA) >= eSnapshot_SNA::S_48, "sna layout doesn't match the file format");
+#endif
 #endif
 
 struct eSnapshot_Z80_v1
@@ -129,7 +135,6 @@ struct eZ80Accessor : public xZ80::eZ80
 #else
 		assert(model48k);
 #endif
-		devices->Init();
 	}
 };
 #ifndef NO_USE_SNA
@@ -198,7 +203,7 @@ bool eZ80Accessor::SetStateSNA(struct stream *stream)
 
 #ifndef USE_STREAM
 #ifndef NO_USE_128K
-	uint p = sna48 ? 0 : (s128->p7FFD & 7u);
+	uint p = sna48 ? 0 : (sna->header_128.p7FFD & 7u);
 #else
 	uint p = 0;
 #endif
@@ -272,16 +277,42 @@ bool eZ80Accessor::SetStateSNA(struct stream *stream)
 	return true;
 }
 #ifndef NO_USE_SAVE
-size_t eZ80Accessor::StoreState(eSnapshot_SNA* s)
+size_t eZ80Accessor::StoreState(eSnapshot_SNA* sna)
 {
-	s->trdos = devices->Get<eRom>()->DosSelected();
+	eSnapshot_SNA_header* s = &sna->header;
+	eSnaphsot_SNA128_header* s128 = &sna->header_128;
 	s->alt_af = alt.af; s->alt_bc = alt.bc;
 	s->alt_de = alt.de; s->alt_hl = alt.hl;
 	s->af = af; s->bc = bc; s->de = de; s->hl = hl;
-	s->ix = ix; s->iy = iy; s->sp = sp; s->pc = pc;
+	s->ix = ix; s->iy = iy; s->sp = sp; s128->pc = pc;
 	s->i = i; s->r = (r_low & 0x7F)+r_hi; s->im = im;
 	s->iff1 = iff1 ? 0xFF : 0;
 
+	byte p7FFD = memory->Page(3) - eMemory::P_RAM0;
+	if(!devices->Get<eUla>()->FirstScreen())
+		p7FFD |= 0x08;
+	s->pFE = devices->Get<eUla>()->BorderColor();
+	byte mapped = 0x24 | (1 << (p7FFD & 7));
+	bool pushed_pc = false;
+	word pushed_at = 0;
+	byte overwritten[2];
+#ifndef NO_USE_128K
+	s128->p7FFD = p7FFD;
+	s128->trdos = devices->Get<eRom>()->DosSelected();
+	if(devices->Get<eRam>()->Mode48k())
+#endif
+	{
+		// 48k snapshot keeps pc on the stack; only for the page copies below, the machine may carry on running
+		mapped = 0xff;
+		s->sp -= 2;
+		pushed_pc = true;
+		pushed_at = s->sp;
+		overwritten[0] = memory->Read(pushed_at);
+		overwritten[1] = memory->Read(pushed_at + 1);
+		memory->Write(pushed_at, pc_l);
+		memory->Write(pushed_at + 1, pc_h);
+	}
+
 	SwapEndian(s->alt_af);
 	SwapEndian(s->alt_bc);
 	SwapEndian(s->alt_de);
@@ -293,26 +324,18 @@ size_t eZ80Accessor::StoreState(eSnapshot_SNA* s)
 	SwapEndian(s->ix);
 	SwapEndian(s->iy);
 	SwapEndian(s->sp);
-	SwapEndian(s->pc);
+	SwapEndian(s128->pc);
 
-	byte p7FFD = memory->Page(3) - eMemory::P_RAM0;
-	if(!devices->Get<eUla>()->FirstScreen())
-		p7FFD |= 0x08;
-	byte pFE = devices->Get<eUla>()->BorderColor();
-	s->p7FFD = p7FFD;
-	s->pFE = pFE;
-	byte mapped = 0x24 | (1 << (p7FFD & 7));
-	if(devices->Get<eRam>()->Mode48k())
+	memcpy(sna->page5, memory->Get(eMemory::P_RAM5), eMemory::PAGE_SIZE);
+	memcpy(sna->page2, memory->Get(eMemory::P_RAM2), eMemory::PAGE_SIZE);
+	memcpy(sna->page,  memory->Get(eMemory::P_RAM0 + (p7FFD & 7)), eMemory::PAGE_SIZE);
+	if(pushed_pc)
 	{
-		mapped = 0xff;
-		s->sp -= 2;
-		memory->Write(s->sp, pc_l);
-		memory->Write(s->sp + 1, pc_h);
+		memory->Write(pushed_at, overwritten[0]);
+		memory->Write(pushed_at + 1, overwritten[1]);
 	}
-	memcpy(s->page5, memory->Get(eMemory::P_RAM5), eMemory::PAGE_SIZE);
-	memcpy(s->page2, memory->Get(eMemory::P_RAM2), eMemory::PAGE_SIZE);
-	memcpy(s->page,  memory->Get(eMemory::P_RAM0 + (p7FFD & 7)), eMemory::PAGE_SIZE);
-	byte* page = s->pages;
+#ifndef NO_USE_128K
+	byte* page = sna->pages;
 	int stored_128_pages = 0;
 	for(byte i = 0; i < 8; i++)
 	{
@@ -331,6 +354,9 @@ size_t eZ80Accessor::StoreState(eSnapshot_SNA* s)
 		return eSnapshot_SNA::S_128_6;
 	}
 	return eSnapshot_SNA::S_128_5;
+#else
+	return eSnapshot_SNA::S_48;
+#endif
 }
 #endif
 #endif
@@ -563,12 +589,20 @@ void eZ80Accessor::UnpackPage(byte* dst, int dstlen, struct stream *stream, int
 #endif
 
 #ifndef NO_USE_SZX
+#ifndef USE_STREAM
 bool LoadSZX(eSpeccy* speccy, const void* data, size_t data_size);
+#else
+bool LoadSZX(eSpeccy* speccy, struct stream* stream);
+#endif
 #endif
 
 #ifndef USE_STREAM
 bool Load(eSpeccy* speccy, const char* type, const void* data, size_t data_size)
 {
+#ifndef NO_USE_SNAPSHOT_PACK
+	if(!strcmp(type, "spk"))
+		return LoadPack(speccy, data, data_size);
+#endif
 	speccy->Devices().FrameStart(0);
 	eZ80Accessor* z80 = (eZ80Accessor*)speccy->CPU();
 	bool ok = false;
@@ -589,6 +623,14 @@ bool Load(eSpeccy* speccy, const char* type, const void* data, size_t data_size)
 #else
 bool Load(eSpeccy* speccy, const char* type, struct stream *stream)
 {
+#ifndef NO_USE_SNAPSHOT_PACK
+		if(!strcmp(type, "spk"))
+		{
+			bool ok = LoadPack(speccy, stream);
+			stream_close(stream);
+			return ok;
+		}
+#endif
 		speccy->Devices().FrameStart(0);
 		eZ80Accessor* z80 = (eZ80Accessor*)speccy->CPU();
 		bool ok = false;
@@ -600,7 +642,7 @@ bool Load(eSpeccy* speccy, const char* type, struct stream *stream)
 #endif
 #ifndef NO_USE_SZX
 		else if(!strcmp(type, "szx"))
-		ok = LoadSZX(speccy, data, data_size);
+			ok = LoadSZX(speccy, stream);
 #endif
 		stream_close(stream);
 		speccy->Devices().FrameUpdate();
@@ -616,8 +658,7 @@ bool Store(eSpeccy* speccy, const char* file)
 	if(!f)
 		return false;
 	eSnapshot_SNA* s = new eSnapshot_SNA;
-	eZ80Accessor* z80 = (eZ80Accessor*)speccy->CPU();
-	size_t size = z80->StoreState(s);
+	size_t size = Store(speccy, s);
 	bool ok = false;
 	if(size)
 		ok = fwrite(s, 1, size, f) == size;
@@ -625,6 +666,12 @@ bool Store(eSpeccy* speccy, const char* file)
 	fclose(f);
 	return ok;
 }
+const size_t STORE_MAX_SIZE = sizeof(eSnapshot_SNA);
+size_t Store(eSpeccy* speccy, void* data)
+{
+	eZ80Accessor* z80 = (eZ80Accessor*)speccy->CPU();
+	return z80->StoreState((eSnapshot_SNA*)data);
+}
 #endif
 
 }
@@ -37,6 +37,11 @@ bool Load(eSpeccy* speccy, const char* type, const void* data, size_t data_size)
 bool Load(eSpeccy* speccy, const char* type, struct stream *stream);
 #endif
 bool Store(eSpeccy* speccy, const char* file);
+#ifndef NO_USE_SAVE
+// .sna image of the current state into data, which must hold STORE_MAX_SIZE bytes. returns the image size, 0 on error
+extern const size_t STORE_MAX_SIZE;
+size_t Store(eSpeccy* speccy, void* data);
+#endif
 }
 //namespace xSnapshot
 
@@ -0,0 +1,394 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2010 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "../std.h"
+#include "../z80/z80.h"
+#include "../devices/memory.h"
+#include "../devices/ula.h"
+#ifndef NO_USE_AY
+#include "../devices/sound/ay.h"
+#endif
+#include "../speccy.h"
+#include "../platform/endian.h"
+
+#include "snapshot_pack.h"
+
+#ifndef NO_USE_SNAPSHOT_PACK
+
+namespace xSnapshot
+{
+
+//*****************************************************************************
+//	ePackSource - random access reads from the pack
+//-----------------------------------------------------------------------------
+struct ePackSource
+{
+#ifndef USE_STREAM
+	ePackSource(const void* _data, size_t _size) : data((const byte*)_data), size(_size) {}
+	bool Read(size_t offset, void* dst, size_t len)
+	{
+		if(offset > size || len > size - offset)
+			return false;
+		memcpy(dst, data + offset, len);
+		return true;
+	}
+	const byte* data;
+	size_t size;
+#else
+	ePackSource(struct stream* _stream) : stream(_stream), pos(0) { stream_reset(stream); }
+	bool Read(size_t offset, void* dst, size_t len)
+	{
+		if(offset < pos)
+		{
+			stream_reset(stream);
+			pos = 0;
+		}
+		if(offset > pos && !stream_skip(stream, offset - pos))
+			return false;
+		pos = offset;
+		if(stream_read(stream, (uint8_t*)dst, len, true) != (int32_t)len)
+			return false;
+		pos += len;
+		return true;
+	}
+	struct stream* stream;
+	size_t pos;
+#endif
+};
+
+static int PackCount(ePackSource& src)
+{
+	ePackHeader h;
+	if(!src.Read(0, &h, sizeof(h)) || memcmp(h.magic, SNAPSHOT_PACK_MAGIC, sizeof(h.magic)))
+		return -1;
+	return Dword((const byte*)&h.count);
+}
+
+static bool ReadEntry(ePackSource& src, int index, ePackEntry* e)
+{
+	ePackHeader h;
+	if(!src.Read(0, &h, sizeof(h)) || memcmp(h.magic, SNAPSHOT_PACK_MAGIC, sizeof(h.magic)))
+		return false;
+	if(index < 0 || (dword)index >= Dword((const byte*)&h.count))
+		return false;
+	return src.Read(Dword((const byte*)&h.index_offset) + index * sizeof(ePackEntry), e, sizeof(ePackEntry));
+}
+
+static int PackFind(ePackSource& src, const char* name)
+{
+	int count = PackCount(src);
+	for(int i = 0; i < count; ++i)
+	{
+		ePackEntry e;
+		if(!ReadEntry(src, i, &e))
+			break;
+		e.name[ePackEntry::NAME_LEN - 1] = 0;
+		if(!strcmp(e.name, name))
+			return i;
+	}
+	return -1;
+}
+
+// RAM page n (0-7) in eMemory
+static byte* RamPage(eMemory* memory, int n)
+{
+#ifndef NO_USE_128K
+	return memory->Get(eMemory::P_RAM0 + n);
+#else
+	switch(n)
+	{
+	case 0: return memory->Get(eMemory::P_RAM0);
+	case 2: return memory->Get(eMemory::P_RAM2);
+	case 5: return memory->Get(eMemory::P_RAM5);
+	}
+	return NULL;
+#endif
+}
+
+struct eZ80PackAccessor : public xZ80::eZ80
+{
+	bool SetState(ePackSource& src, int index);
+#ifndef USE_Z80_ARM
+	void StoreState(ePackEntry* e);
+#endif
+	eMemory* Memory() { return memory; }
+};
+
+bool eZ80PackAccessor::SetState(ePackSource& src, int index)
+{
+	ePackEntry e;
+	if(!ReadEntry(src, index, &e))
+		return false;
+	bool model48k = e.model48k != 0;
+#ifdef NO_USE_128K
+	if(!model48k)
+		return false;
+#endif
+	const ePackState* s = &e.state;
+#ifndef NO_USE_128K
+	devices->Get<eRom>()->Mode48k(model48k);
+	devices->Get<eRam>()->Mode48k(model48k);
+	devices->Get<eUla>()->Mode48k(model48k);
+#endif
+
+	// pages are stored uncompressed in ascending order, so this is one sequential read per page
+	size_t offset = Dword((const byte*)&e.pages_offset);
+	for(int n = 0; n < 8; ++n)
+	{
+		if(!(e.page_mask & (1 << n)))
+			continue;
+		byte* page = RamPage(memory, n);
+		if(!page || !src.Read(offset, page, eMemory::PAGE_SIZE))
+			return false;
+		offset += eMemory::PAGE_SIZE;
+	}
+
+#ifndef USE_Z80_ARM
+	af = SwapWord(s->af); bc = SwapWord(s->bc);
+	de = SwapWord(s->de); hl = SwapWord(s->hl);
+	alt.af = SwapWord(s->alt_af); alt.bc = SwapWord(s->alt_bc);
+	alt.de = SwapWord(s->alt_de); alt.hl = SwapWord(s->alt_hl);
+	ix = SwapWord(s->ix); iy = SwapWord(s->iy);
+	sp = SwapWord(s->sp); pc = SwapWord(s->pc);
+	memptr = SwapWord(s->memptr);
+	i = s->i; r_low = s->r; r_hi = s->r & 0x80;
+	im = s->im; iff1 = s->iff1; iff2 = s->iff2; halted = s->halted;
+	t = Dword((const byte*)&s->t);
+	devices->IoWrite(0xfe, s->pFE, t);
+#ifndef NO_USE_128K
+	if(!model48k)
+		devices->IoWrite(0x7ffd, s->p7FFD, t);
+#endif
+#else
+	auto &rs = z80a_resting_state;
+	rs.af = SwapWord(s->af); rs.bc = SwapWord(s->bc);
+	rs.de = SwapWord(s->de); rs.hl = SwapWord(s->hl);
+	rs.alt_af = SwapWord(s->alt_af); rs.alt_bc = SwapWord(s->alt_bc);
+	rs.alt_de = SwapWord(s->alt_de); rs.alt_hl = SwapWord(s->alt_hl);
+	rs.ix = SwapWord(s->ix); rs.iy = SwapWord(s->iy);
+	rs.sp = SwapWord(s->sp); rs.pc = SwapWord(s->pc);
+	rs.memptr = SwapWord(s->memptr);
+	rs.i = s->i; rs.r_low = s->r; rs.r_hi = s->r & 0x80;
+	rs.im = s->im; rs.iff1 = s->iff1; rs.iff2 = s->iff2; rs.halted = s->halted;
+	rs.t = Dword((const byte*)&s->t);
+	devices->IoWrite(0xfe, s->pFE, rs.t);
+#ifndef NO_USE_128K
+	if(!model48k)
+		devices->IoWrite(0x7ffd, s->p7FFD, rs.t);
+#endif
+#endif
+
+	switch(s->rom)
+	{
+#ifndef NO_USE_128K
+	case PR_128_0:	devices->Get<eRom>()->SelectPage(eRom::ROM_128_0);	break;
+	case PR_128_1:	devices->Get<eRom>()->SelectPage(eRom::ROM_128_1);	break;
+#endif
+#ifndef NO_USE_DOS
+	case PR_DOS:	devices->Get<eRom>()->SelectPage(eRom::ROM_DOS);	break;
+#endif
+	case PR_48:		devices->Get<eRom>()->SelectPage(eRom::ROM_48);		break;
+	default:
+		return false;
+	}
+#ifndef NO_USE_AY
+	devices->Get<eAY>()->SetRegs(s->ay_regs);
+	devices->Get<eAY>()->Select(s->ay_selected);
+#endif
+	return true;
+}
+
+static bool LoadPack(eSpeccy* speccy, ePackSource& src, int index)
+{
+	speccy->Devices().FrameStart(0);
+	eZ80PackAccessor* z80 = (eZ80PackAccessor*)speccy->CPU();
+	bool ok = z80->SetState(src, index);
+	speccy->Devices().FrameUpdate();
+	speccy->Devices().FrameEnd(z80->FrameTacts() + z80->T());
+	return ok;
+}
+
+#ifndef USE_STREAM
+int PackCount(const void* data, size_t data_size)
+{
+	ePackSource src(data, data_size);
+	return PackCount(src);
+}
+int PackFind(const void* data, size_t data_size, const char* name)
+{
+	ePackSource src(data, data_size);
+	return PackFind(src, name);
+}
+bool LoadPack(eSpeccy* speccy, const void* data, size_t data_size, int index)
+{
+	ePackSource src(data, data_size);
+	return LoadPack(speccy, src, index);
+}
+#else
+int PackCount(struct stream* stream)
+{
+	ePackSource src(stream);
+	return PackCount(src);
+}
+int PackFind(struct stream* stream, const char* name)
+{
+	ePackSource src(stream);
+	return PackFind(src, name);
+}
+bool LoadPack(eSpeccy* speccy, struct stream* stream, int index)
+{
+	ePackSource src(stream);
+	return LoadPack(speccy, src, index);
+}
+#endif
+
+#ifndef USE_Z80_ARM
+static void PutDword(dword* dst, dword v)
+{
+	byte* p = (byte*)dst;
+	p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+void eZ80PackAccessor::StoreState(ePackEntry* e)
+{
+	ePackState* s = &e->state;
+	s->af = SwapWord(af); s->bc = SwapWord(bc);
+	s->de = SwapWord(de); s->hl = SwapWord(hl);
+	s->alt_af = SwapWord(alt.af); s->alt_bc = SwapWord(alt.bc);
+	s->alt_de = SwapWord(alt.de); s->alt_hl = SwapWord(alt.hl);
+	s->ix = SwapWord(ix); s->iy = SwapWord(iy);
+	s->sp = SwapWord(sp); s->pc = SwapWord(pc);
+	s->memptr = SwapWord(memptr);
+	s->i = i; s->r = (r_low & 0x7f) | r_hi;
+	s->im = im; s->iff1 = iff1; s->iff2 = iff2; s->halted = halted;
+	PutDword(&s->t, t);
+
+	eUla* ula = devices->Get<eUla>();
+	s->pFE = ula->BorderColor();
+	bool model48k = devices->Get<eRam>()->Mode48k();
+	e->model48k = model48k;
+#ifndef NO_USE_128K
+	byte p7FFD = memory->Page(3) - eMemory::P_RAM0;
+	if(!ula->FirstScreen())
+		p7FFD |= 0x08;
+	eRom::ePage rom = devices->Get<eRom>()->PageSelected();
+	if(rom == eRom::ROM_128_0 || (rom != eRom::ROM_128_1 && !model48k))
+		p7FFD |= 0x10;
+	if(devices->Get<eRam>()->Locked())
+		p7FFD |= 0x20; // restored along with the rest by the 7FFD write in SetState
+	s->p7FFD = model48k ? 0x30 : p7FFD;
+#else
+	s->p7FFD = 0x30;
+#endif
+	if(devices->Get<eRom>()->DosSelected())
+		s->rom = PR_DOS;
+	else if(model48k)
+		s->rom = PR_48;
+	else
+		s->rom = (s->p7FFD & 0x10) ? PR_128_0 : PR_128_1;
+#ifndef NO_USE_AY
+	eAY* ay = devices->Get<eAY>();
+	memcpy(s->ay_regs, ay->GetRegs(), sizeof(s->ay_regs));
+	s->ay_selected = ay->Selected();
+#else
+	memset(s->ay_regs, 0, sizeof(s->ay_regs));
+	s->ay_selected = 0;
+#endif
+	e->page_mask = model48k ? 0x25 : 0xff;
+}
+
+//=============================================================================
+//	ePackWriter::Open
+//-----------------------------------------------------------------------------
+bool ePackWriter::Open(const char* name)
+{
+	Close();
+	file = fopen(name, "wb");
+	if(!file)
+		return false;
+	// header is rewritten on close; pages start on the first PAGE_SIZE boundary
+	static const byte zero[eMemory::PAGE_SIZE] = { 0 };
+	return fwrite(zero, 1, sizeof(zero), file) == sizeof(zero);
+}
+
+//=============================================================================
+//	ePackWriter::Add
+//-----------------------------------------------------------------------------
+bool ePackWriter::Add(eSpeccy* speccy, const char* name)
+{
+	if(!file)
+		return false;
+	if(count == capacity)
+	{
+		int new_capacity = capacity ? capacity * 2 : 64;
+		ePackEntry* e = (ePackEntry*)realloc(entries, new_capacity * sizeof(ePackEntry));
+		if(!e)
+			return false;
+		entries = e;
+		capacity = new_capacity;
+	}
+	ePackEntry* e = &entries[count];
+	memset(e, 0, sizeof(*e));
+	strncpy(e->name, name, ePackEntry::NAME_LEN - 1);
+	eZ80PackAccessor* z80 = (eZ80PackAccessor*)speccy->CPU();
+	z80->StoreState(e);
+	long offset = ftell(file);
+	assert(!(offset % eMemory::PAGE_SIZE));
+	PutDword(&e->pages_offset, offset);
+	for(int n = 0; n < 8; ++n)
+	{
+		if(!(e->page_mask & (1 << n)))
+			continue;
+		byte* page = RamPage(z80->Memory(), n);
+		if(fwrite(page, 1, eMemory::PAGE_SIZE, file) != eMemory::PAGE_SIZE)
+			return false;
+	}
+	++count;
+	return true;
+}
+
+//=============================================================================
+//	ePackWriter::Close
+//-----------------------------------------------------------------------------
+bool ePackWriter::Close()
+{
+	bool ok = true;
+	if(file)
+	{
+		ePackHeader h;
+		memcpy(h.magic, SNAPSHOT_PACK_MAGIC, sizeof(h.magic));
+		PutDword(&h.count, count);
+		PutDword(&h.index_offset, ftell(file));
+		ok = fwrite(entries, sizeof(ePackEntry), count, file) == (size_t)count;
+		ok = ok && !fseek(file, 0, SEEK_SET);
+		ok = ok && fwrite(&h, 1, sizeof(h), file) == sizeof(h);
+		ok = !fclose(file) && ok;
+		file = NULL;
+	}
+	free(entries);
+	entries = NULL;
+	count = capacity = 0;
+	return ok;
+}
+#endif
+
+}
+//namespace xSnapshot
+
+#endif//NO_USE_SNAPSHOT_PACK
@@ -0,0 +1,116 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2010 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef	__SNAPSHOT_PACK_H__
+#define	__SNAPSHOT_PACK_H__
+
+#include "../std.h"
+#ifdef USE_STREAM
+#include "stream.h"
+#endif
+
+#pragma once
+
+#ifndef NO_USE_SNAPSHOT_PACK
+
+class eSpeccy;
+
+namespace xSnapshot
+{
+
+// A snapshot pack (.spk) holds many machine states. Each entry in the index has a fixed CPU/device state record,
+// and the entry's RAM pages are stored already decoded, PAGE_SIZE aligned within the file, so restoring a state is
+// a straight copy of each page (from a mapping, with a memory or mmap stream). All values are little endian.
+#define SNAPSHOT_PACK_MAGIC "USPPACK1"
+
+#pragma pack(push, 1)
+struct ePackHeader
+{
+	char magic[8];
+	dword count;
+	dword index_offset; // count ePackEntry
+};
+
+struct ePackState
+{
+	word af, bc, de, hl;
+	word alt_af, alt_bc, alt_de, alt_hl;
+	word ix, iy, sp, pc, memptr;
+	byte i, r, im, iff1, iff2, halted;
+	byte p7FFD, pFE;
+	byte rom; // ePackRom
+	byte ay_selected;
+	byte ay_regs[16];
+	dword t; // t-states into the frame
+};
+
+struct ePackEntry
+{
+	enum { NAME_LEN = 48 };
+	char name[NAME_LEN]; // nul terminated
+	dword pages_offset; // PAGE_SIZE aligned; the pages in page_mask follow in ascending order
+	byte model48k;
+	byte page_mask; // bit n set if RAM page n is stored
+	byte reserved[2];
+	ePackState state;
+};
+#pragma pack(pop)
+
+enum ePackRom { PR_48, PR_128_0, PR_128_1, PR_DOS };
+
+#ifndef USE_STREAM
+int PackCount(const void* data, size_t data_size); // -1 if not a pack
+int PackFind(const void* data, size_t data_size, const char* name);
+bool LoadPack(eSpeccy* speccy, const void* data, size_t data_size, int index = 0);
+#else
+int PackCount(struct stream* stream);
+int PackFind(struct stream* stream, const char* name);
+bool LoadPack(eSpeccy* speccy, struct stream* stream, int index = 0);
+#endif
+
+// packs are written by the native pack tool, so this doesn't follow NO_USE_SAVE
+#ifndef USE_Z80_ARM
+//*****************************************************************************
+//	ePackWriter
+//-----------------------------------------------------------------------------
+class ePackWriter
+{
+public:
+	ePackWriter() : file(NULL), entries(NULL), count(0), capacity(0) {}
+	~ePackWriter() { Close(); }
+	bool Open(const char* name);
+	// append the current state of speccy
+	bool Add(eSpeccy* speccy, const char* name);
+	// writes the index; the pack is not valid until closed
+	bool Close();
+
+protected:
+	FILE* file;
+	ePackEntry* entries;
+	int count;
+	int capacity;
+};
+#endif
+
+}
+//namespace xSnapshot
+
+#endif//NO_USE_SNAPSHOT_PACK
+
+#endif//__SNAPSHOT_PACK_H__
@@ -21,16 +21,22 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "../z80/z80.h"
 #include "../devices/memory.h"
 #include "../devices/ula.h"
+#ifndef NO_USE_AY
 #include "../devices/sound/ay.h"
+#endif
 #include "../speccy.h"
 #include "../platform/endian.h"
-#include "../tools/stream_memory.h"
 
 #include "snapshot.h"
 
+#ifndef USE_STREAM
+#include "../tools/stream_memory.h"
 #ifdef USE_ZIP
 #include <zlib.h>
 #endif//USE_ZIP
+#else
+#include "miniz_tinfl.h"
+#endif
 
 namespace xSnapshot
 {
@@ -149,19 +155,112 @@ typedef struct _tagZXSTAYBLOCK
 
 #pragma pack(pop)
 
+//*****************************************************************************
+//	eSZXInput - blocks come from a memory image or, with USE_STREAM, a stream
+//-----------------------------------------------------------------------------
+struct eSZXInput
+{
+#ifndef USE_STREAM
+	eSZXInput(const void* data, size_t data_size) : is(data, data_size) { is.Open(); }
+	size_t Read(void* dst, size_t size) { return is.Read(dst, size); }
+	bool Skip(size_t size) { return is.Seek(size, xIo::eStreamMemory::S_CUR) == 0; }
+	bool Eos() const { return is.Pos() == is.Size(); }
+	bool Inflate(byte* dst, size_t size)
+	{
+		bool ok = false;
+#ifdef USE_ZIP
+		byte* buf_compr = new byte[size];
+		ok = is.Read(buf_compr, size) == size;
+		if(ok)
+		{
+			z_stream zs;
+			memset(&zs, 0, sizeof(zs));
+			zs.next_in = buf_compr;
+			zs.avail_in = size;
+			zs.next_out = dst;
+			zs.avail_out = eMemory::PAGE_SIZE;
+			ok = inflateInit2(&zs, 15) == Z_OK;
+			if(ok)
+				ok = inflate(&zs, Z_NO_FLUSH) == Z_STREAM_END;
+			inflateEnd(&zs);
+		}
+		SAFE_DELETE_ARRAY(buf_compr);
+#endif//USE_ZIP
+		return ok;
+	}
+	xIo::eStreamMemory is;
+#else
+	eSZXInput(struct stream* _stream) : stream(_stream), inflator(NULL) {}
+	~eSZXInput() { SAFE_DELETE(inflator); }
+	size_t Read(void* dst, size_t size)
+	{
+		int32_t r = stream_read(stream, (uint8_t*)dst, size, true);
+		return r < 0 ? 0 : r;
+	}
+	bool Skip(size_t size) { return stream_skip(stream, size); }
+	bool Eos() { return stream_is_eos(stream); }
+	// inflates straight from the stream's own buffer into the page; the whole page is the output window, so
+	// no dictionary or staging buffer is needed
+	bool Inflate(byte* dst, size_t size)
+	{
+		if(!inflator)
+			inflator = new tinfl_decompressor;
+		tinfl_init(inflator);
+		tinfl_status status = TINFL_STATUS_NEEDS_MORE_INPUT;
+		size_t out_pos = 0;
+		while(status == TINFL_STATUS_NEEDS_MORE_INPUT && size)
+		{
+			size_t in_bytes = 0;
+			const uint8_t* in = stream_peek_avail(stream, 1, &in_bytes, NULL);
+			if(!in || !in_bytes)
+				return false;
+			if(in_bytes > size)
+				in_bytes = size;
+			size_t out_bytes = eMemory::PAGE_SIZE - out_pos;
+			status = tinfl_decompress(inflator, in, &in_bytes, dst, dst + out_pos, &out_bytes,
+					TINFL_FLAG_PARSE_ZLIB_HEADER | TINFL_FLAG_USING_NON_WRAPPING_OUTPUT_BUF |
+					(in_bytes < size ? TINFL_FLAG_HAS_MORE_INPUT : 0));
+			stream_skip(stream, in_bytes);
+			size -= in_bytes;
+			out_pos += out_bytes;
+		}
+		if(size && !Skip(size))
+			return false;
+		return status == TINFL_STATUS_DONE && out_pos == eMemory::PAGE_SIZE;
+	}
+	struct stream* stream;
+	tinfl_decompressor* inflator;
+#endif
+};
+
 struct eZ80AccessorSZX : public xZ80::eZ80
 {
-	bool SetState(xIo::eStreamMemory& is);
+	bool SetState(eSZXInput& is);
 	void SetupDevices(bool model48k)
 	{
+#ifndef NO_USE_128K
 		devices->Get<eRom>()->Mode48k(model48k);
 		devices->Get<eRam>()->Mode48k(model48k);
 		devices->Get<eUla>()->Mode48k(model48k);
-		devices->Init();
+#endif
+	}
+	byte* RamPage(int n)
+	{
+#ifndef NO_USE_128K
+		return n <= 7 ? memory->Get(eMemory::P_RAM0 + n) : NULL;
+#else
+		switch(n)
+		{
+		case 0: return memory->Get(eMemory::P_RAM0);
+		case 2: return memory->Get(eMemory::P_RAM2);
+		case 5: return memory->Get(eMemory::P_RAM5);
+		}
+		return NULL;
+#endif
 	}
 };
 
-template<class B> static bool ReadBlock(xIo::eStreamMemory& is, B* b, const ZXSTBLOCK& block, size_t size = 0)
+template<class B> static bool ReadBlock(eSZXInput& is, B* b, const ZXSTBLOCK& block, size_t size = 0)
 {
 	b->blk = block;
 	if(!size)
@@ -169,7 +268,7 @@ template<class B> static bool ReadBlock(xIo::eStreamMemory& is, B* b, const ZXST
 	return is.Read((byte*)b + sizeof(b->blk), size) == size;
 }
 
-bool eZ80AccessorSZX::SetState(xIo::eStreamMemory& is)
+bool eZ80AccessorSZX::SetState(eSZXInput& is)
 {
 	ZXSTHEADER header;
 	if(is.Read(&header, sizeof(header)) != sizeof(header))
@@ -184,13 +283,18 @@ bool eZ80AccessorSZX::SetState(xIo::eStreamMemory& is)
 	case ZXSTMID_NTSC48K:
 		model48k = true;
 		break;
+#ifndef NO_USE_128K
 	case ZXSTMID_128K:
 	case ZXSTMID_PENTAGON128:
 		break;
+#endif
 	default:
 		return false;
 	}
 	SetupDevices(model48k);
+#ifdef USE_Z80_ARM
+	auto &rs = z80a_resting_state;
+#endif
 	ZXSTBLOCK block;
 	while(is.Read(&block, sizeof(block)) == sizeof(block))
 	{
@@ -201,6 +305,7 @@ bool eZ80AccessorSZX::SetState(xIo::eStreamMemory& is)
 				ZXSTZ80REGS regs;
 				if(!ReadBlock(is, &regs, block))
 					return false;
+#ifndef USE_Z80_ARM
 				af = SwapWord(regs.AF);
 				bc = SwapWord(regs.BC);
 				de = SwapWord(regs.DE);
@@ -223,6 +328,30 @@ bool eZ80AccessorSZX::SetState(xIo::eStreamMemory& is)
 				t = Dword((const byte*)&regs.dwCyclesStart) % frame_tacts;
 				if(regs.wMemPtr)
 					memptr = SwapWord(regs.wMemPtr);
+#else
+				rs.af = SwapWord(regs.AF);
+				rs.bc = SwapWord(regs.BC);
+				rs.de = SwapWord(regs.DE);
+				rs.hl = SwapWord(regs.HL);
+				rs.alt_af = SwapWord(regs.AF1);
+				rs.alt_bc = SwapWord(regs.BC1);
+				rs.alt_de = SwapWord(regs.DE1);
+				rs.alt_hl = SwapWord(regs.HL1);
+
+				rs.ix = SwapWord(regs.IX);
+				rs.iy = SwapWord(regs.IY);
+				rs.sp = SwapWord(regs.SP);
+				rs.pc = SwapWord(regs.PC);
+				rs.i = regs.I;
+				rs.r_low = regs.R;
+				rs.r_hi = regs.R & 0x80;
+				rs.im = regs.IM;
+				rs.iff1 = regs.IFF1;
+				rs.iff2 = regs.IFF2;
+				rs.t = Dword((const byte*)&regs.dwCyclesStart) % FrameTacts();
+				if(regs.wMemPtr)
+					rs.memptr = SwapWord(regs.wMemPtr);
+#endif
 			}
 			break;
 		case FOURCC('S', 'P', 'C', 'R'):
@@ -230,87 +359,83 @@ bool eZ80AccessorSZX::SetState(xIo::eStreamMemory& is)
 				ZXSTSPECREGS regs;
 				if(!ReadBlock(is, &regs, block))
 					return false;
-				devices->IoWrite(0xfe, (regs.chFe&0x18) | regs.chBorder, t);
-				devices->IoWrite(0x7ffd, model48k ? 0x30 : regs.ch7ffd, t);
+#ifndef USE_Z80_ARM
+				int tact = t;
+#else
+				int tact = rs.t;
+#endif
+				devices->IoWrite(0xfe, (regs.chFe&0x18) | regs.chBorder, tact);
+#ifndef NO_USE_128K
+				devices->IoWrite(0x7ffd, model48k ? 0x30 : regs.ch7ffd, tact);
 				if(model48k)
 					devices->Get<eRom>()->SelectPage(eRom::ROM_48);
 				else
 					devices->Get<eRom>()->SelectPage((regs.ch7ffd & 0x10) ? eRom::ROM_128_0 : eRom::ROM_128_1);
+#else
+				devices->Get<eRom>()->SelectPage(eRom::ROM_48);
+#endif
 			}
 			break;
 		case FOURCC('R', 'A', 'M', 'P'):
 			{
 				ZXSTRAMPAGE ram_page;
-				if(!ReadBlock(is, &ram_page, block, sizeof(ZXSTRAMPAGE) - sizeof(ZXSTBLOCK) - 1))
+				const size_t header_size = sizeof(ZXSTRAMPAGE) - sizeof(ZXSTBLOCK) - 1;
+				if(!ReadBlock(is, &ram_page, block, header_size))
 					return false;
-				byte* buf = new byte[eMemory::PAGE_SIZE];
-				bool ok = false;
-				if(SwapWord(ram_page.wFlags)&ZXSTRF_COMPRESSED)
+				size_t size = ram_page.blk.dwSize - header_size;
+				byte* page = RamPage(ram_page.chPageNo);
+				if(!page)
 				{
-#ifdef USE_ZIP
-					size_t size = ram_page.blk.dwSize - (sizeof(ZXSTRAMPAGE) - sizeof(ZXSTBLOCK) - 1);
-					byte* buf_compr = new byte[size];
-					ok = is.Read(buf_compr, size) == size;
-					if(ok)
-					{
-						z_stream zs;
-						memset(&zs, 0, sizeof(zs));
-						zs.next_in = buf_compr;
-						zs.avail_in = size;
-						zs.next_out = buf;
-						zs.avail_out = eMemory::PAGE_SIZE;
-						ok = inflateInit2(&zs, 15) == Z_OK;
-						if(ok)
-							ok = inflate(&zs, Z_NO_FLUSH) == Z_STREAM_END;
-						inflateEnd(&zs);
-					}
-					SAFE_DELETE_ARRAY(buf_compr);
-#endif//USE_ZIP
+					// a page this machine doesn't have
+					if(!is.Skip(size))
+						return false;
+					break;
 				}
+				bool ok;
+				if(SwapWord(ram_page.wFlags)&ZXSTRF_COMPRESSED)
+					ok = is.Inflate(page, size);
 				else
-				{
-					size_t size = ram_page.blk.dwSize - (sizeof(ZXSTRAMPAGE) - sizeof(ZXSTBLOCK) - 1);
-					ok = size == eMemory::PAGE_SIZE;
-					if(ok)
-					{
-						ok = is.Read(buf, size) == size;
-					}
-				}
-				if(ok && ram_page.chPageNo <= 7)
-				{
-					memcpy(memory->Get(eMemory::P_RAM0 + ram_page.chPageNo), buf, eMemory::PAGE_SIZE);
-				}
-				SAFE_DELETE(buf);
+					ok = size == eMemory::PAGE_SIZE && is.Read(page, size) == size;
 				if(!ok)
 					return false;
 			}
 			break;
+#ifndef NO_USE_AY
 		case FOURCC('A', 'Y', '\0', '\0'):
 			{
 				ZXSTAYBLOCK ay_state;
 				if(!ReadBlock(is, &ay_state, block))
 					return false;
-				devices->Get<eAY>()->SetRegs(ay_state.chAyRegs);
-				devices->Get<eAY>()->Select(ay_state.chCurrentRegister);
+				devices->Get<eAY>()->SetRegs(ay_state.chAyRegs);
+				devices->Get<eAY>()->Select(ay_state.chCurrentRegister);
 			}
 			break;
+#endif
 		default:
-			if(is.Seek(block.dwSize, xIo::eStreamMemory::S_CUR) != 0)
+			if(!is.Skip(block.dwSize))
 				return false;
 		}
-		if(is.Pos() == is.Size())
+		if(is.Eos())
 			return true;
 	}
 	return false;
 }
 
+#ifndef USE_STREAM
 bool LoadSZX(eSpeccy* speccy, const void* data, size_t data_size)
 {
-	xIo::eStreamMemory is(data, data_size);
-	is.Open();
+	eSZXInput is(data, data_size);
 	eZ80AccessorSZX* z80 = (eZ80AccessorSZX*)speccy->CPU();
 	return z80->SetState(is);
 }
+#else
+bool LoadSZX(eSpeccy* speccy, struct stream* stream)
+{
+	eSZXInput is(stream);
+	eZ80AccessorSZX* z80 = (eZ80AccessorSZX*)speccy->CPU();
+	return z80->SetState(is);
+}
+#endif
 
 }
 //namespace xSnapshot
@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include "speccy.h"
 #include "devices/device.h"
+#include "devices/device_list.h"
 #include "z80/z80.h"
 #include "devices/memory.h"
 #include "devices/ula.h"
@@ -44,56 +45,171 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "devices/fdd/wd1793.h"
 #endif
 #include "tools/profiler.h"
+#include "tools/arena.h"
 
 PROFILER_DECLARE(dev_e);
 PROFILER_DECLARE(dev);
 PROFILER_DECLARE(dev_s);
 PROFILER_DECLARE(frame);
+PROFILER_DECLARE(boot_mem);
+PROFILER_DECLARE(boot_dev);
+PROFILER_DECLARE(boot_cpu);
+PROFILER_DECLARE(boot_rst);
+
+#ifndef USE_HACKED_DEVICE_ABSTRACTION
+// everything eSpeccy::eSpeccy adds, in the same order (it's the order IN/OUT reach them)
+typedef eDeviceList<eRom, eRam, eUla, eKeyboard
+#ifndef NO_USE_KEMPSTON
+	, eKempstonJoy
+#ifndef USE_MU
+	, eKempstonMouse
+#endif
+#endif
+#ifndef NO_USE_BEEPER
+	, eBeeper
+#endif
+#ifndef NO_USE_AY
+	, eAY
+#endif
+#ifndef NO_USE_FDD
+	, eWD1793
+#endif
+#ifndef NO_USE_TAPE
+	, eTape
+#endif
+	> eSpeccyDevices;
+
+//=============================================================================
+//	eDevices::IoRead
+//-----------------------------------------------------------------------------
+byte eDevices::IoRead(word port, int tact)
+{
+	byte v = 0xff;
+	eSpeccyDevices::IoRead(*this, port, &v, tact);
+	return v;
+}
+//=============================================================================
+//	eDevices::IoWrite
+//-----------------------------------------------------------------------------
+void eDevices::IoWrite(word port, byte v, int tact)
+{
+	eSpeccyDevices::IoWrite(*this, port, v, tact);
+}
+#endif
+
+#ifdef USE_MACHINE_ARENA
+#if defined(USE_HACKED_DEVICE_ABSTRACTION) || defined(USE_SINGLE_64K_MEMORY) || defined(NO_USE_DESTRUCTORS)
+#error USE_MACHINE_ARENA needs the device list, paged memory and destructors
+#endif
+// one machine's block: eSpeccy, eMemory (bank pointers) and eZ80 (registers, then op tables) first as the hot part,
+// the devices after them, then the memory pages on a page boundary of their own
+enum { ARENA_PAGE = 4096 };
+static const size_t arena_objects = eArena::Align(eArena::Align(sizeof(eSpeccy)) + eArena::Align(sizeof(eMemory))
+	+ eArena::Align(sizeof(xZ80::eZ80)) + eSpeccyDevices::Size(eArena::LINE), ARENA_PAGE);
+static const size_t arena_size = arena_objects + eMemory::SIZE;
+
+//=============================================================================
+//	eSpeccy::operator new
+//-----------------------------------------------------------------------------
+void* eSpeccy::operator new(size_t size)
+{
+	assert(size == sizeof(eSpeccy)); // the constructor lays out the rest behind it
+	// aligned by hand: aligned_alloc's padding keeps a block this big over malloc's mmap threshold, so every
+	// machine would start on fresh pages
+	byte* block = (byte*)malloc(arena_size + ARENA_PAGE);
+	assert(block);
+	byte* p = (byte*)eArena::Align((size_t)block + sizeof(byte*), ARENA_PAGE);
+	((byte**)p)[-1] = block;
+	return p;
+}
+//=============================================================================
+//	eSpeccy::operator delete
+//-----------------------------------------------------------------------------
+void eSpeccy::operator delete(void* p)
+{
+	if(p)
+		free(((byte**)p)[-1]);
+}
+#define MACHINE_NEW(T) new(arena.Alloc(sizeof(T))) T
+#else//USE_MACHINE_ARENA
+#define MACHINE_NEW(T) new T
+#endif//USE_MACHINE_ARENA
 
 //=============================================================================
 //	eSpeccy::eSpeccy
 //-----------------------------------------------------------------------------
 eSpeccy::eSpeccy() : cpu(NULL), memory(NULL), frame_tacts(0)
 	, int_len(0), nmi_pending(0), t_states(0)
+#ifndef NO_USE_WATCH
+	, mid_frame(false), pc_hit(false)
+#endif
 {
 	// pentagon timings
 	frame_tacts = 71680;
 	int_len = 32;
 
+	PROFILER_BEGIN(boot_mem);
+#ifdef USE_MACHINE_ARENA
+	eArena arena(this, arena_objects);
+	arena.Alloc(sizeof(eSpeccy));
+	memory = MACHINE_NEW(eMemory)((byte*)this + arena_objects);
+	void* cpu_at = arena.Alloc(sizeof(xZ80::eZ80)); // made once the devices it looks up are there
+#else
 	memory = new eMemory;
-	devices.Add(new eRom(memory));
-	devices.Add(new eRam(memory));
-	devices.Add(new eUla(memory));
-	devices.Add(new eKeyboard);
+#endif
+	PROFILER_END(boot_mem);
+	PROFILER_BEGIN(boot_dev);
+	devices.Add(MACHINE_NEW(eRom)(memory));
+	devices.Add(MACHINE_NEW(eRam)(memory));
+	devices.Add(MACHINE_NEW(eUla)(memory));
+	devices.Add(MACHINE_NEW(eKeyboard));
 #ifndef NO_USE_KEMPSTON
-	devices.Add(new eKempstonJoy);
+	devices.Add(MACHINE_NEW(eKempstonJoy));
 #ifndef USE_MU
-	devices.Add(new eKempstonMouse);
+	devices.Add(MACHINE_NEW(eKempstonMouse));
 #endif
 #endif
 #ifndef NO_USE_BEEPER
-	devices.Add(new eBeeper);
+	devices.Add(MACHINE_NEW(eBeeper));
 #endif
 #ifndef NO_USE_AY
-	devices.Add(new eAY);
+	devices.Add(MACHINE_NEW(eAY));
 #endif
 #ifndef NO_USE_FDD
-	devices.Add(new eWD1793(this, Device<eRom>()));
+	devices.Add(MACHINE_NEW(eWD1793)(this, Device<eRom>()));
 #endif
 #ifndef NO_USE_TAPE
-	devices.Add(new eTape(this));
+	devices.Add(MACHINE_NEW(eTape)(this));
 #endif
+	PROFILER_END(boot_dev);
+#ifndef USE_HACKED_DEVICE_ABSTRACTION
+	assert(eSpeccyDevices::Present(devices));
+#endif
+	PROFILER_BEGIN(boot_cpu);
+#ifdef USE_MACHINE_ARENA
+	cpu = new(cpu_at) xZ80::eZ80(memory, &devices, frame_tacts);
+#else
 	cpu = new xZ80::eZ80(memory, &devices, frame_tacts);
+#endif
+	PROFILER_END(boot_cpu);
+	PROFILER_BEGIN(boot_rst);
 	Reset();
+	PROFILER_END(boot_rst);
 }
+#undef MACHINE_NEW
 //=============================================================================
 //	eSpeccy::~eSpeccy
 //-----------------------------------------------------------------------------
 #ifndef NO_USE_DESTRUCTORS
 eSpeccy::~eSpeccy()
 {
+#ifndef USE_MACHINE_ARENA
 	delete cpu;
 	delete memory;
+#else
+	cpu->~eZ80();
+	memory->~eMemory(); // the devices go with eDevices, the block with operator delete
+#endif
 }
 #endif
 //=============================================================================
@@ -102,8 +218,10 @@ eSpeccy::~eSpeccy()
 void eSpeccy::Reset()
 {
 	cpu->Reset();
-	devices.Init();
 	devices.Reset();
+#ifndef NO_USE_WATCH
+	mid_frame = pc_hit = false;
+#endif
 }
 #ifndef NO_USE_128K
 //=============================================================================
@@ -128,6 +246,9 @@ void eSpeccy::Mode48k(bool on)
 //-----------------------------------------------------------------------------
 void eSpeccy::Update(int* fetches)
 {
+#ifndef NO_USE_WATCH
+	if(!mid_frame)
+#endif
 	{
 		PROFILER_SECTION(dev_s);
 		devices.FrameStart(fetches ? 0 : cpu->T());
@@ -144,6 +265,11 @@ void eSpeccy::Update(int* fetches)
 		cpu->Update(int_len, &nmi_pending);
 #endif
 	}
+#ifndef NO_USE_WATCH
+	mid_frame = cpu->Watch().hit != 0;
+	if(mid_frame)
+		return;
+#endif
 	{
 		PROFILER_SECTION(dev);
 		devices.FrameUpdate();
@@ -154,3 +280,79 @@ void eSpeccy::Update(int* fetches)
 	}
 	t_states += fetches ? cpu->T() : cpu->FrameTacts();
 }
+#ifndef NO_USE_WATCH
+//=============================================================================
+//	eSpeccy::Run
+//-----------------------------------------------------------------------------
+static dword ScreenHash(const byte* s)
+{
+	dword h = 2166136261u;
+	for(int i = 0; i < 0x1b00; ++i)
+		h = (h ^ s[i])*16777619u;
+	return h;
+}
+dword eSpeccy::Run(const eWatch& w, int* frames)
+{
+	typedef xZ80::eZ80::eWatch eCpuWatch;
+	eCpuWatch& cw = cpu->Watch();
+	cw.flags = 0;
+	cw.hit = 0;
+	if(w.pc_map)
+	{
+		cw.flags |= eCpuWatch::W_PC;
+		cw.pc_map = w.pc_map;
+		cw.pc_skip = pc_hit; // not stopping straight away on the same pc again
+	}
+	if(w.mem_addr >= 0)
+	{
+		cw.flags |= eCpuWatch::W_MEM;
+		cw.mem_addr = w.mem_addr;
+		cw.mem_mask = w.mem_mask;
+		cw.mem_value = w.mem_change ? memory->Read(w.mem_addr) & w.mem_mask : w.mem_value;
+		cw.mem_change = w.mem_change;
+	}
+	if(w.port)
+	{
+		cw.flags |= eCpuWatch::W_PORT;
+		cw.port_mask = w.port_mask;
+		cw.port_value = w.port_value;
+	}
+	if(w.tstates > 0)
+	{
+		cw.flags |= eCpuWatch::W_TSTATES;
+		cw.t_stop = cpu->T() + w.tstates;
+	}
+	const byte* screen = Device<eUla>()->ScreenMemory();
+	dword screen_hash = w.screen_frames ? ScreenHash(screen) : 0;
+	int screen_same = 0;
+	dword hit = 0;
+	int done = 0;
+	while(done < *frames)
+	{
+		Update();
+		if(mid_frame)
+		{
+			hit = cw.hit;
+			break;
+		}
+		++done;
+		if(w.screen_frames)
+		{
+			screen = Device<eUla>()->ScreenMemory(); // may have been switched
+			dword h = ScreenHash(screen);
+			screen_same = h == screen_hash ? screen_same + 1 : 0;
+			screen_hash = h;
+			if(screen_same >= w.screen_frames)
+			{
+				hit = W_SCREEN;
+				break;
+			}
+		}
+	}
+	pc_hit = (hit & eCpuWatch::W_PC) != 0;
+	cw.flags = 0; // Update() outside Run() carries on unwatched
+	cw.hit = 0;
+	*frames = done;
+	return hit;
+}
+#endif
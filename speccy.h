@@ -39,10 +39,38 @@ public:
 #else
 	~eSpeccy() =delete;
 #endif
+#ifdef USE_MACHINE_ARENA
+	// the whole machine is one block, so it has to be made with new
+	static void* operator new(size_t size);
+	static void operator delete(void* p);
+#endif
 
 	void Reset();
 	void Update(int* fetches = NULL);
 
+#ifndef NO_USE_WATCH
+	struct eWatch
+	{
+		eWatch() : pc_map(NULL), mem_addr(-1), mem_mask(0xff), mem_value(0), mem_change(false), port_mask(0)
+			, port_value(0), port(false), tstates(0), screen_frames(0) {}
+		const byte* pc_map;	// 8K, bit per address to stop at, NULL for none
+		int mem_addr;		// z80 address, -1 for none
+		byte mem_mask;		// stop when (byte & mem_mask) == mem_value
+		byte mem_value;
+		bool mem_change;	// or instead when it's no longer what it was on starting
+		word port_mask;		// stop after an in/out with (port & port_mask) == port_value
+		word port_value;
+		bool port;
+		int tstates;		// stop once this many have gone, 0 for none
+		int screen_frames;	// stop once the screen hasn't changed for this many frames, 0 for none
+	};
+	enum { W_SCREEN = 0x10 }; // after the cpu ones in xZ80::eZ80::eWatch::eFlag
+	// runs up to *frames frames or until a condition is met, setting *frames to the frames finished. it can stop
+	// part way through a frame, with devices mid frame as they would be between two instructions; the next Run() or
+	// Update() carries on from there. returns the conditions met, 0 if it ran all the frames
+	dword Run(const eWatch& w, int* frames);
+#endif
+
 	xZ80::eZ80*	CPU() const { return cpu; }
 	eMemory*	Memory() const { return memory; }
 	eDevices&	Devices() { return devices; }
@@ -64,6 +92,10 @@ protected:
 	int		int_len;		// length of INT signal (for Z80)
 	int		nmi_pending;
 	qword	t_states;
+#ifndef NO_USE_WATCH
+	bool	mid_frame;		// last Update() stopped on a watch condition
+	bool	pc_hit;			// on a pc one
+#endif
 };
 
 #endif//__SPECCY_H__
@@ -52,6 +52,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "tools/options.h"
 #include "tools/io_select.h"
 #include "snapshot/rzx.h"
+#include "snapshot/rzx_record.h"
 #include "options_common.h"
 #include "file_type.h"
 #ifdef USE_STREAM
@@ -82,7 +83,7 @@ static struct eSpeccyHandler : public eHandler
 #ifndef NO_USE_REPLAY
 		, public eRZX::eHandler
 #endif
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
+#ifndef NO_USE_REPLAY
 		,public xZ80::eZ80::eHandlerIo
 #endif
 {
@@ -144,7 +145,7 @@ static struct eSpeccyHandler : public eHandler
 
 	virtual bool FullSpeed() const final {
 #ifndef NO_USE_FAST_TAPE
-		return speccy->CPU()->HandlerStep() != NULL;
+		return speccy->CPU()->HandlerStep() == fast_tape_emul;
 #else
 		return false;
 #endif
@@ -175,6 +176,8 @@ static struct eSpeccyHandler : public eHandler
 			return replay->GetProgress(frame_current, frames_total, frames_cached) == eRZX::E_OK;
 		return false;
 	}
+	virtual const char* ReplayVerify(dword* frames);
+	eRZX::eError ReplayUpdate();
 #endif
 
 #ifndef NO_USE_RZX
@@ -184,12 +187,39 @@ static struct eSpeccyHandler : public eHandler
 #ifndef NO_USE_REPLAY
 	void Replay(eRZX* r)
 	{
+#ifndef NO_USE_SAVE
+		if(r)
+			recorder.Close();
+#endif
 		speccy->CPU()->HandlerIo(NULL);
 		SAFE_DELETE(replay);
 		replay = r;
 		if(replay)
 			speccy->CPU()->HandlerIo(this);
+#ifndef NO_USE_FDD
+		FastDisk();
+#endif
 	}
+#ifndef NO_USE_SAVE
+	bool Record(const char* name)
+	{
+		if(replay)
+			return false;
+#ifndef NO_USE_FAST_TAPE
+		speccy->CPU()->HandlerStep(NULL); // fast tape skips whole frames, which can't be recorded
+#endif
+		if(!recorder.Open(name, speccy))
+			return false;
+#ifndef NO_USE_FDD
+		FastDisk();
+#endif
+		return true;
+	}
+#endif
+#endif
+#ifndef NO_USE_FDD
+	void FastDisk();
+	void FastDiskTrap();
 #endif
 
 	eSpeccy* speccy;
@@ -198,6 +228,11 @@ static struct eSpeccyHandler : public eHandler
 #endif//USE_UI
 	eMacro* macro;
 	eRZX* replay;
+#ifndef NO_USE_REPLAY
+#ifndef NO_USE_SAVE
+	eRZXRecorder recorder;
+#endif
+#endif
 	int video_paused;
 	int video_frame;
 	bool inside_replay_update;
@@ -232,6 +267,9 @@ void eSpeccyHandler::OnDone()
 	SAFE_DELETE(macro);
 #ifndef NO_USE_REPLAY
 	SAFE_DELETE(replay);
+#ifndef NO_USE_SAVE
+	recorder.Close();
+#endif
 #endif
 #ifndef NO_USE_DESTRUCTORS
 	SAFE_DELETE(speccy);
@@ -246,6 +284,9 @@ const char* eSpeccyHandler::OnLoop()
 	const char* error = NULL;
 	if(FullSpeed() || !video_paused)
 	{
+#ifndef NO_USE_FDD
+		FastDiskTrap();
+#endif
 		if(macro)
 		{
 			if(!macro->Update())
@@ -254,15 +295,7 @@ const char* eSpeccyHandler::OnLoop()
 #ifndef NO_USE_REPLAY
 		if(replay)
 		{
-			int icount = 0;
-			inside_replay_update = true;
-			eRZX::eError err = replay->Update(&icount);
-			inside_replay_update = false;
-			if(err == eRZX::E_OK)
-			{
-				speccy->Update(&icount);
-				err = replay->CheckSync();
-			}
+			eRZX::eError err = ReplayUpdate();
 			if(err != eRZX::E_OK)
 			{
 				Replay(NULL);
@@ -271,7 +304,15 @@ const char* eSpeccyHandler::OnLoop()
 		}
 		else
 #endif
+		{
 			speccy->Update(NULL);
+#ifndef NO_USE_REPLAY
+#ifndef NO_USE_SAVE
+			if(recorder.Recording())
+				recorder.Update();
+#endif
+#endif
+		}
 		++video_frame;
 	}
 #ifdef USE_UI
@@ -279,6 +320,33 @@ const char* eSpeccyHandler::OnLoop()
 #endif//USE_UI
 	return error;
 }
+#ifndef NO_USE_REPLAY
+eRZX::eError eSpeccyHandler::ReplayUpdate()
+{
+	int icount = 0;
+	inside_replay_update = true;
+	eRZX::eError err = replay->Update(&icount);
+	inside_replay_update = false;
+	if(err == eRZX::E_OK)
+	{
+		speccy->Update(&icount);
+		err = replay->CheckSync();
+	}
+	return err;
+}
+const char* eSpeccyHandler::ReplayVerify(dword* frames)
+{
+	*frames = 0;
+	if(!replay)
+		return RZXErrorDesc(eRZX::E_INVALID);
+	// frames back to back, no pacing by video or sound
+	eRZX::eError err;
+	while((err = ReplayUpdate()) == eRZX::E_OK)
+		++*frames;
+	Replay(NULL);
+	return err == eRZX::E_FINISHED ? NULL : RZXErrorDesc(err);
+}
+#endif
 const char* eSpeccyHandler::RZXErrorDesc(eRZX::eError err) const
 {
 	switch(err)
@@ -398,6 +466,17 @@ bool eSpeccyHandler::OnOpenFileCompressed(const char* name, const void* comresse
 
 	struct stream *underlying = open_stream(comressed_data, compressed_data_size);
 	struct stream *compressed_stream = compressed_stream_open(underlying, data_size);
+	if(!compressed_stream)
+	{
+		stream_close(underlying);
+		return false;
+	}
+#ifdef ENABLE_READAHEAD_STREAM
+	// inflate on a worker thread rather than in the middle of a frame
+	struct stream *readahead = readahead_stream_open(compressed_stream, 0);
+	if(readahead)
+		compressed_stream = readahead;
+#endif
 	return t->Open(compressed_stream);
 }
 #endif
@@ -452,6 +531,69 @@ static struct eOptionTapeFast : public xOptions::eOptionBool
 	virtual int Order() const { return 50; }
 } op_tape_fast;
 #endif
+#ifndef NO_USE_FDD
+static struct eOptionDiskFast : public xOptions::eOptionBool
+{
+	eOptionDiskFast() { Set(true); }
+	virtual const char* Name() const {
+#ifndef USE_MU
+		return "fast disk";
+#else
+		return "Fast disk";
+#endif
+	}
+	virtual int Order() const { return 52; }
+	virtual void Change(bool next = true)
+	{
+		eOptionBool::Change(next);
+		sh.FastDisk();
+	}
+} op_disk_fast;
+
+static struct eOptionDiskWriteBack : public xOptions::eOptionBool
+{
+	virtual const char* Name() const {
+#ifndef USE_MU
+		return "write back disk";
+#else
+		return "Write back disk";
+#endif
+	}
+	virtual int Order() const { return 53; }
+} op_disk_write_back;
+
+//=============================================================================
+//	eSpeccyHandler::FastDisk
+//-----------------------------------------------------------------------------
+// no delay controller and the tr-dos sector traps, while a disk is in and no .rzx is played or recorded (the traps
+// change what the cpu runs)
+void eSpeccyHandler::FastDisk()
+{
+	eWD1793* wd = speccy->Device<eWD1793>();
+	bool fast = op_disk_fast && wd->DiskPresent() && !replay;
+#if !defined(NO_USE_REPLAY) && !defined(NO_USE_SAVE)
+	fast = fast && !recorder.Recording();
+#endif
+	wd->NoDelay(fast);
+	FastDiskTrap();
+}
+//=============================================================================
+//	eSpeccyHandler::FastDiskTrap
+//-----------------------------------------------------------------------------
+// the traps put every instruction through the step handler, so they are only installed while tr-dos is paged in.
+// this runs each frame: the frame tr-dos is entered in goes without them, the controller has no delay anyway.
+// fast tape shares the step handler and keeps it while the tape runs
+void eSpeccyHandler::FastDiskTrap()
+{
+#ifndef NO_USE_FAST_TAPE
+	xZ80::eZ80* cpu = speccy->CPU();
+	if(cpu->HandlerStep() == fast_tape_emul)
+		return;
+	bool trap = speccy->Device<eWD1793>()->NoDelay() && speccy->Device<eRom>()->DosSelected();
+	cpu->HandlerStep(trap ? fast_disk_emul : NULL);
+#endif
+}
+#endif
 
 static struct eOptionAutoPlayImage : public xOptions::eOptionBool
 {
@@ -508,6 +650,9 @@ eActionResult eSpeccyHandler::OnAction(eAction action)
 #ifndef NO_USE_REPLAY
 		if(!inside_replay_update) // can be called from replay->Update()
 			SAFE_DELETE(replay);
+#ifndef NO_USE_SAVE
+		recorder.Close();
+#endif
 #endif
 		SAFE_DELETE(macro);
 #ifndef NO_USE_128K
@@ -524,9 +669,12 @@ eActionResult eSpeccyHandler::OnAction(eAction action)
 #endif
 		}
 #endif
-#ifndef USE_HACKED_DEVICE_ABSTRACTION
+#ifndef NO_USE_REPLAY
 		if(inside_replay_update)
 			speccy->CPU()->HandlerIo(this);
+#endif
+#ifndef NO_USE_FDD
+		FastDisk();
 #endif
 		return AR_OK;
 #ifndef NO_USE_TAPE
@@ -538,10 +686,17 @@ eActionResult eSpeccyHandler::OnAction(eAction action)
 			if(!tape->Started())
 			{
 #ifndef NO_USE_FAST_TAPE
-				if(op_tape_fast)
+				if(op_tape_fast
+#if !defined(NO_USE_REPLAY) && !defined(NO_USE_SAVE)
+					&& !recorder.Recording()
+#endif
+					)
 					speccy->CPU()->HandlerStep(fast_tape_emul);
 				else
 					speccy->CPU()->HandlerStep(NULL);
+#endif
+#ifndef NO_USE_FDD
+				FastDisk();
 #endif
 				tape->Start();
 			}
@@ -676,10 +831,17 @@ void SetupSoundChip()
 #ifndef NO_USE_REPLAY
 static struct eFileTypeRZX : public eFileType
 {
+#ifndef USE_STREAM
 	virtual bool Open(const void* data, size_t data_size) const
 	{
 		eRZX* rzx = new eRZX;
 		if(rzx->Open(data, data_size, &sh) == eRZX::E_OK)
+#else
+	virtual bool Open(struct stream *stream) const
+	{
+		eRZX* rzx = new eRZX;
+		if(rzx->Open(stream, &sh) == eRZX::E_OK)
+#endif
 		{
 			sh.Replay(rzx);
 			return true;
@@ -691,6 +853,9 @@ static struct eFileTypeRZX : public eFileType
 		}
 		return false;
 	}
+#ifndef NO_USE_SAVE
+	virtual bool Store(const char* name) const { return sh.Record(name); }
+#endif
 	virtual const char* Type() const { return "rzx"; }
 } ft_rzx;
 #endif
@@ -709,7 +874,8 @@ static struct eFileTypeZ80 : public eFileType
 		sh.OnAction(A_RESET);
 		// to save memory we close tape
 		sh.speccy->Device<eTape>()->CloseTape();
-		// todo hack ... because we only have one inflator, the A_RESET above can mix in the old stream, so we reset again.
+		// todo hack ... with USE_SINGLE_COMPRESSED_STREAM_INSTANCE we only have one inflator, so the A_RESET above can
+		//  mix in the old stream, so we reset again.
 		stream_reset(stream);
 		return xSnapshot::Load(sh.speccy, Type(), stream);
 	}
@@ -723,6 +889,12 @@ static struct eFileTypeSZX : public eFileTypeZ80
 	virtual const char* Type() const { return "szx"; }
 } ft_szx;
 #endif
+#ifndef NO_USE_SNAPSHOT_PACK
+static struct eFileTypeSPK : public eFileTypeZ80
+{
+	virtual const char* Type() const { return "spk"; }
+} ft_spk;
+#endif
 #ifndef NO_USE_SNA
 static struct eFileTypeSNA : public eFileTypeZ80
 {
@@ -778,6 +950,8 @@ static struct eFileTypeTRD : public eFileType
 	{
 		eWD1793* wd = sh.speccy->Device<eWD1793>();
 		bool ok = wd->Open(Type(), OpDrive(), data, data_size);
+		if(ok)
+			sh.FastDisk();
 		if(ok && op_auto_play_image)
 		{
 			sh.OnAction(A_RESET);
@@ -801,12 +975,22 @@ static struct eFileTypeTRD : public eFileType
 		}
 		return ok;
 	}
+	virtual bool Open(const char* name) const
+	{
+		if(!eFileType::Open(name))
+			return false;
+		if(op_disk_write_back)
+			sh.speccy->Device<eWD1793>()->WriteBack(Type(), OpDrive(), name);
+		return true;
+	}
 	virtual bool Store(const char* name) const
 	{
+		eWD1793* wd = sh.speccy->Device<eWD1793>();
+		if(wd->WritesBackTo(OpDrive(), name)) // only what changed since the last flush
+			return wd->Flush(OpDrive());
 		FILE* file = fopen(name, "wb");
 		if(!file)
 			return false;
-		eWD1793* wd = sh.speccy->Device<eWD1793>();
 		bool ok = wd->Store(Type(), OpDrive(), file);
 		fclose(file);
 		return ok;
@@ -16,6 +16,15 @@
 #include "hardware/structs/xip_ctrl.h"
 #endif
 #include "hardware/gpio.h"
+#ifdef ENABLE_MMAP_STREAM
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#ifdef ENABLE_READAHEAD_STREAM
+#include <pthread.h>
+#endif
 
 CU_REGISTER_DEBUG_PINS(xip_stream_dma)
 
@@ -118,25 +127,259 @@ struct stream *memory_stream_open(const uint8_t *buffer, size_t size, bool own_b
     return &ms->stream;
 }
 
+#ifdef ENABLE_MMAP_STREAM
+// a memory stream over a file mapping; only close differs
+void mmap_stream_close(struct stream *s) {
+    struct memory_stream *ms = to_ms(s);
+    if (ms->data_size) munmap((void *)ms->data, ms->data_size);
+    free(ms);
+}
+
+const struct stream_funcs mmap_stream_funcs = {
+    .reset = memory_stream_reset,
+    .skip = memory_stream_skip,
+    .peek = memory_stream_peek,
+    .read = memory_stream_read,
+    .close = mmap_stream_close,
+    .is_eos = memory_stream_is_eos,
+#ifndef NDEBUG
+    .pos = memory_stream_pos,
+#endif
+#ifndef NDEBUG
+    .type = memory
+#endif
+};
+
+struct stream *mmap_stream_open(const char *filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat st;
+    if (fstat(fd, &st) || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return NULL;
+    }
+    size_t size = (size_t)st.st_size;
+    const uint8_t *data = NULL;
+    // mmap of zero bytes fails, but an empty stream is fine
+    if (size) {
+        void *p = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            close(fd);
+            return NULL;
+        }
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = (const uint8_t *)p;
+    }
+    // the mapping outlives the descriptor
+    close(fd);
+    struct memory_stream *ms = (struct memory_stream *)calloc(1, sizeof(struct memory_stream));
+    ms->stream.funcs = &mmap_stream_funcs;
+    ms->stream.size = size;
+    ms->data = data;
+    ms->data_size = size;
+    return &ms->stream;
+}
+#endif
+
 #ifdef ENABLE_COMPRESSED_STREAM
+struct compressed_stream_state {
+    tinfl_decompressor inflator;
+    uint8_t buffer[MAX_COMPRESSED_STREAM_PEEK + TINFL_LZ_DICT_SIZE];
+};
+
 #ifdef USE_SINGLE_COMPRESSED_STREAM_INSTANCE
-static tinfl_decompressor inflator;
-static uint8_t inflator_buffer[MAX_COMPRESSED_STREAM_PEEK + TINFL_LZ_DICT_SIZE];
+static struct compressed_stream_state single_state;
+
+static struct compressed_stream_state *compressed_stream_state_alloc(int *slot) {
+    *slot = 0;
+    return &single_state;
+}
+
+static void compressed_stream_state_free(int slot) {
+}
 #else
-#error no
+// states are allocated on first use and then kept for reuse by later streams
+static struct compressed_stream_state *state_pool[MAX_COMPRESSED_STREAMS];
+static uint8_t state_in_use[MAX_COMPRESSED_STREAMS];
+
+static struct compressed_stream_state *compressed_stream_state_alloc(int *slot) {
+    for(int i = 0; i < MAX_COMPRESSED_STREAMS; i++) {
+        if (!__atomic_exchange_n(&state_in_use[i], 1, __ATOMIC_ACQUIRE)) {
+            if (!state_pool[i]) {
+                state_pool[i] = (struct compressed_stream_state *)malloc(sizeof(struct compressed_stream_state));
+                if (!state_pool[i]) {
+                    __atomic_store_n(&state_in_use[i], 0, __ATOMIC_RELEASE);
+                    return NULL;
+                }
+            }
+            *slot = i;
+            return state_pool[i];
+        }
+    }
+    return NULL;
+}
+
+static void compressed_stream_state_free(int slot) {
+    assert(state_in_use[slot]);
+    __atomic_store_n(&state_in_use[slot], 0, __ATOMIC_RELEASE);
+}
+#endif
+
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+// everything needed to resume inflation at out_pos; taken at the start of a fill, when the logical buffer holds
+// the previous TINFL_LZ_DICT_SIZE bytes of output (i.e. the dictionary)
+struct compressed_stream_checkpoint {
+    int32_t out_pos;
+    size_t in_pos;
+    tinfl_decompressor inflator;
+    uint8_t dict[TINFL_LZ_DICT_SIZE];
+};
+// the cost given in stream.h; a bigger TINFL_FAST_LOOKUP_BITS or dictionary needs it revisiting
+_Static_assert(sizeof(struct compressed_stream_checkpoint) <= 9300, "checkpoint size no longer matches stream.h");
 #endif
+
 struct compressed_stream {
     struct stream self;
     struct stream *underlying;
+    struct compressed_stream_state *state;
+    int state_slot;
     uint8_t *logical_buffer;
     int32_t buf_base_pos;
     int32_t buf_current_index; // index into logical buffer (could be negative down to -MAX_PEEK)
     int32_t buf_end_index;
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    size_t in_pos; // bytes consumed from underlying
+    struct compressed_stream_checkpoint **checkpoints; // in increasing out_pos order
+    int checkpoint_count;
+    int checkpoint_capacity;
+#endif
+    bool fast; // FAST format rather than zlib
 };
 
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+static void compressed_stream_record_checkpoint(struct compressed_stream *cs) {
+    // checkpoints are only valid after a full buffer (the dictionary), and are recorded once, in order
+    if (!cs->buf_base_pos || cs->buf_end_index != TINFL_LZ_DICT_SIZE) return;
+    int32_t last = cs->checkpoint_count ? cs->checkpoints[cs->checkpoint_count - 1]->out_pos : 0;
+    if (cs->buf_base_pos < last + COMPRESSED_STREAM_CHECKPOINT_INTERVAL) return;
+    if (cs->checkpoint_count == cs->checkpoint_capacity) {
+        int capacity = cs->checkpoint_capacity ? cs->checkpoint_capacity * 2 : 8;
+        struct compressed_stream_checkpoint **checkpoints = (struct compressed_stream_checkpoint **)realloc(
+                cs->checkpoints, capacity * sizeof(struct compressed_stream_checkpoint *));
+        if (!checkpoints) return;
+        cs->checkpoints = checkpoints;
+        cs->checkpoint_capacity = capacity;
+    }
+    struct compressed_stream_checkpoint *cp = (struct compressed_stream_checkpoint *)malloc(sizeof(struct compressed_stream_checkpoint));
+    if (!cp) return;
+    cp->out_pos = cs->buf_base_pos;
+    cp->in_pos = cs->in_pos;
+    cp->inflator = cs->state->inflator;
+    memcpy(cp->dict, cs->logical_buffer, TINFL_LZ_DICT_SIZE);
+    cs->checkpoints[cs->checkpoint_count++] = cp;
+}
+#endif
+
+// FAST format: COMPRESSED_STREAM_FAST_MAGIC followed by LZ4 style sequences; (token, literal length extension,
+// literals, 16 bit offset, match length extension). Sequences never cross a TINFL_LZ_DICT_SIZE boundary in the output,
+// and each such block ends with a literal only sequence, so a fill decodes exactly one block into the same circular
+// buffer as inflate would, with matches reaching back up to TINFL_LZ_DICT_SIZE into the previous block
+struct fast_input {
+    struct stream *underlying;
+    const uint8_t *base; // start of the current peek
+    const uint8_t *p;
+    const uint8_t *end;
+    size_t consumed;
+};
+
+static bool fast_input_refill(struct fast_input *in) {
+    if (in->p != in->base) {
+        stream_skip(in->underlying, in->p - in->base);
+        in->consumed += in->p - in->base;
+    }
+    size_t avail = 0;
+    in->base = in->p = stream_peek_avail(in->underlying, 1, &avail, NULL);
+    in->end = in->p + avail;
+    return in->p != NULL;
+}
+
+static inline uint8_t fast_input_byte(struct fast_input *in) {
+    if (in->p == in->end && !fast_input_refill(in)) {
+        assert(false); // truncated
+        return 0;
+    }
+    return *in->p++;
+}
+
+static inline size_t fast_input_length(struct fast_input *in, size_t len) {
+    if (len == 15) {
+        uint8_t b;
+        do {
+            b = fast_input_byte(in);
+            len += b;
+        } while (b == 255);
+    }
+    return len;
+}
+
+static int32_t compressed_stream_decode_fast_block(struct compressed_stream *cs) {
+    int32_t block_end = MIN(TINFL_LZ_DICT_SIZE, (int32_t)cs->self.size - cs->buf_base_pos);
+    if (block_end <= 0) return 0;
+    uint8_t *buf = cs->logical_buffer;
+    struct fast_input in = { .underlying = cs->underlying };
+    int32_t d = 0;
+    while (true) {
+        uint token = fast_input_byte(&in);
+        size_t len = fast_input_length(&in, token >> 4);
+        assert(d + len <= block_end);
+        len = MIN(len, block_end - d);
+        while (len) {
+            if (in.p == in.end && !fast_input_refill(&in)) break;
+            size_t n = MIN(len, (size_t)(in.end - in.p));
+            memcpy(buf + d, in.p, n);
+            in.p += n;
+            d += n;
+            len -= n;
+        }
+        if (d >= block_end) break;
+        uint offset = fast_input_byte(&in);
+        offset |= fast_input_byte(&in) << 8;
+        len = fast_input_length(&in, token & 15) + 4;
+        assert(offset && offset <= TINFL_LZ_DICT_SIZE && d + len <= block_end);
+        len = MIN(len, block_end - d);
+        uint32_t src = (d - offset) & (TINFL_LZ_DICT_SIZE - 1);
+        if (offset >= len && src + len <= TINFL_LZ_DICT_SIZE && (src < d || src >= d + len)) {
+            memcpy(buf + d, buf + src, len);
+        } else {
+            // overlapping, or wrapping from the end of the previous block to the start of this one
+            for(size_t i = 0; i < len; i++) {
+                buf[d + i] = buf[(src + i) & (TINFL_LZ_DICT_SIZE - 1)];
+            }
+        }
+        d += len;
+    }
+    if (in.p != in.base) {
+        stream_skip(cs->underlying, in.p - in.base);
+        in.consumed += in.p - in.base;
+    }
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    cs->in_pos += in.consumed;
+#endif
+    return d;
+}
+
 static void compressed_stream_fill(struct compressed_stream *cs) {
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    cs->buf_base_pos += cs->buf_end_index; // old buffer complete
+    compressed_stream_record_checkpoint(cs);
+#else
     cs->buf_base_pos += cs->buf_end_index; // old buffer complete
+#endif
     cs->buf_current_index = 0;
+    if (cs->fast) {
+        cs->buf_end_index = compressed_stream_decode_fast_block(cs);
+        return;
+    }
     tinfl_status status;
     size_t in_bytes, out_bytes;
     bool eos;
@@ -151,13 +394,16 @@ static void compressed_stream_fill(struct compressed_stream *cs) {
         const uint8_t *next_in = stream_peek_avail(cs->underlying, 1, &in_bytes, &eos);
         if (!in_bytes) break;
         assert(next_in);
-        status = tinfl_decompress(&inflator, (const mz_uint8 *)next_in, &in_bytes, cs->logical_buffer,
+        status = tinfl_decompress(&cs->state->inflator, (const mz_uint8 *)next_in, &in_bytes, cs->logical_buffer,
             (mz_uint8 *)cs->logical_buffer + decode_offset, &out_bytes,
             (eos ? 0 : TINFL_FLAG_HAS_MORE_INPUT) |
             TINFL_FLAG_PARSE_ZLIB_HEADER);
         // we should always be deocompressing a whole buffer full unless we are at the end
         assert(status == TINFL_STATUS_DONE || status == TINFL_STATUS_NEEDS_MORE_INPUT || (status == TINFL_STATUS_HAS_MORE_OUTPUT && out_bytes == TINFL_LZ_DICT_SIZE - decode_offset));
         stream_skip(cs->underlying, in_bytes);
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+        cs->in_pos += in_bytes;
+#endif
         decode_offset += out_bytes;
     } while (status == TINFL_STATUS_NEEDS_MORE_INPUT);
     DEBUG_PINS_SET(xip_stream_dma, 1);
@@ -224,20 +470,99 @@ const uint8_t *compressed_stream_peek(struct stream *s, size_t min_len, size_t *
 void compressed_stream_reset(struct stream *s) {
     struct compressed_stream *cs = to_cs(s);
     stream_reset(cs->underlying);
-    tinfl_init(&inflator);
+    tinfl_init(&cs->state->inflator);
     cs->buf_base_pos = 0;
     cs->buf_end_index = 0;
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    cs->in_pos = 0;
+#endif
+    // an xip stream can only peek a single byte, so the magic is read a byte at a time (rewinding if it turns out
+    // not to be there); zlib data never starts with the first byte, so normally this is a single peek
+    const char *magic = COMPRESSED_STREAM_FAST_MAGIC;
+    const uint8_t *first = stream_peek(cs->underlying, 1);
+    cs->fast = false;
+    if (first && *first == (uint8_t)magic[0]) {
+        size_t matched = 0;
+        uint8_t b;
+        while (magic[matched] && stream_read(cs->underlying, &b, 1, false) == 1 && b == (uint8_t)magic[matched]) {
+            matched++;
+        }
+        cs->fast = !magic[matched];
+        if (!cs->fast) {
+            stream_reset(cs->underlying);
+        }
+    }
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    if (cs->fast) {
+        cs->in_pos = sizeof(COMPRESSED_STREAM_FAST_MAGIC) - 1;
+    }
+#endif
     compressed_stream_fill(cs);
 }
 
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+// skip in steps of no more than the underlying stream has buffered, as e.g. an xip stream can only skip within
+// its buffer
+static bool compressed_stream_skip_underlying(struct compressed_stream *cs, size_t bytes) {
+    while (bytes) {
+        size_t avail = 0;
+        if (!stream_peek_avail(cs->underlying, 1, &avail, NULL) || !avail) return false;
+        size_t step = MIN(bytes, avail);
+        if (!stream_skip(cs->underlying, step)) return false;
+        bytes -= step;
+    }
+    return true;
+}
+
+// jump to the last checkpoint at or before target if it is past what we have already decompressed;
+// returns the number of bytes of target consumed
+static size_t compressed_stream_skip_to_checkpoint(struct compressed_stream *cs, size_t bytes) {
+    int32_t target = cs->buf_base_pos + cs->buf_current_index + (int32_t)bytes;
+    int lo = 0, hi = cs->checkpoint_count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (cs->checkpoints[mid]->out_pos <= target) lo = mid + 1;
+        else hi = mid;
+    }
+    if (!lo) return 0;
+    struct compressed_stream_checkpoint *cp = cs->checkpoints[lo - 1];
+    if (cp->out_pos <= cs->buf_base_pos + cs->buf_end_index) return 0;
+    size_t consumed = cp->out_pos - (cs->buf_base_pos + cs->buf_current_index);
+    stream_reset(cs->underlying);
+    if (!compressed_stream_skip_underlying(cs, cp->in_pos)) {
+        // can't happen, as the checkpoint was recorded from this data
+        assert(false);
+    }
+    cs->in_pos = cp->in_pos;
+    cs->state->inflator = cp->inflator;
+    memcpy(cs->logical_buffer, cp->dict, TINFL_LZ_DICT_SIZE);
+    cs->buf_base_pos = cp->out_pos;
+    cs->buf_end_index = 0;
+    compressed_stream_fill(cs);
+    return consumed;
+}
+#endif
+
 bool compressed_stream_skip(struct stream *s, size_t bytes) {
     struct compressed_stream *cs = to_cs(s);
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    if (cs->checkpoint_count) {
+        bytes -= compressed_stream_skip_to_checkpoint(cs, bytes);
+    }
+#endif
     return bytes == compressed_stream_read_internal(cs, NULL, bytes, false);
 }
 
 void compressed_stream_close(struct stream *s) {
     struct compressed_stream *cs = to_cs(s);
+#ifdef ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+    for(int i = 0; i < cs->checkpoint_count; i++) {
+        free(cs->checkpoints[i]);
+    }
+    free(cs->checkpoints);
+#endif
     stream_close(cs->underlying);
+    compressed_stream_state_free(cs->state_slot);
     free(cs);
 }
 
@@ -248,7 +573,7 @@ uint32_t compressed_stream_pos(struct stream *s) {
 
 bool compressed_stream_is_eos(struct stream *s) {
     struct compressed_stream *cs = to_cs(s);
-    return  cs->buf_end_index - cs->buf_current_index != 0;
+    return (size_t)(cs->buf_base_pos + cs->buf_current_index) >= cs->self.size;
 }
 
 const struct stream_funcs compressed_stream_funcs = {
@@ -267,11 +592,16 @@ const struct stream_funcs compressed_stream_funcs = {
 };
 
 struct stream *compressed_stream_open(struct stream *underlying, size_t uncompressed_size) {
+    int slot;
+    struct compressed_stream_state *state = compressed_stream_state_alloc(&slot);
+    if (!state) return NULL;
     struct compressed_stream *cs = (struct compressed_stream *)calloc(1, sizeof(struct compressed_stream));
     cs->self.funcs = &compressed_stream_funcs;
     cs->self.size = uncompressed_size;
     cs->underlying = underlying;
-    cs->logical_buffer = inflator_buffer + MAX_COMPRESSED_STREAM_PEEK;
+    cs->state = state;
+    cs->state_slot = slot;
+    cs->logical_buffer = state->buffer + MAX_COMPRESSED_STREAM_PEEK;
     compressed_stream_reset(&cs->self);
     return &cs->self;
 }
@@ -575,3 +905,261 @@ struct stream *xip_stream_open(const uint8_t *src, size_t size, size_t buffer_si
     xip_stream_reset(&xs->self);
     return &xs->self;
 }
+
+#ifdef ENABLE_READAHEAD_STREAM
+// the worker fills the two buffers alternately while the consumer reads the other; each buffer has
+// MAX_READAHEAD_STREAM_PEEK bytes in front of the data so a peek can straddle the switch
+enum readahead_buffer_state {
+    rab_empty,
+    rab_ready,
+    rab_consuming
+};
+
+struct readahead_buffer {
+    uint8_t *data;
+    enum readahead_buffer_state state;
+    size_t begin; // index of next unread byte
+    size_t end;
+};
+
+struct readahead_stream {
+    struct stream self;
+    struct stream *underlying;
+    size_t chunk_size;
+    struct readahead_buffer buffers[2];
+    int cur; // buffer being consumed, the worker fills cur ^ 1
+    size_t pos;
+    size_t underlying_pos; // where the worker reads from next
+    bool underlying_eos;
+    bool worker_busy;
+    bool closing;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+static inline struct readahead_stream *to_ras(struct stream *s) {
+    assert(s);
+    assert(s->funcs->type == readahead);
+    return (struct readahead_stream *)s;
+}
+
+static void *readahead_stream_worker(void *arg) {
+    struct readahead_stream *ras = (struct readahead_stream *)arg;
+    pthread_mutex_lock(&ras->lock);
+    while (!ras->closing) {
+        struct readahead_buffer *b = &ras->buffers[ras->cur ^ 1];
+        if (b->state == rab_empty && !ras->underlying_eos) {
+            ras->worker_busy = true;
+            pthread_mutex_unlock(&ras->lock);
+            // a short read isn't the end (xip reads stop at the end of a dma buffer), so fill the chunk until
+            // the underlying stream has nothing more. reads stay within its size, as memory streams assert otherwise
+            size_t n = 0;
+            bool eos = ras->underlying_pos >= ras->self.size;
+            while (n < ras->chunk_size && !eos) {
+                size_t len = MIN(ras->chunk_size - n, ras->self.size - ras->underlying_pos);
+                int32_t r = stream_read(ras->underlying, b->data + MAX_READAHEAD_STREAM_PEEK + n, len, false);
+                if (r > 0) {
+                    n += r;
+                    ras->underlying_pos += r;
+                }
+                eos = r <= 0 || ras->underlying_pos >= ras->self.size || stream_is_eos(ras->underlying);
+            }
+            pthread_mutex_lock(&ras->lock);
+            b->begin = MAX_READAHEAD_STREAM_PEEK;
+            b->end = MAX_READAHEAD_STREAM_PEEK + n;
+            b->state = rab_ready;
+            if (eos) ras->underlying_eos = true;
+            ras->worker_busy = false;
+            pthread_cond_broadcast(&ras->cond);
+        } else {
+            pthread_cond_wait(&ras->cond, &ras->lock);
+        }
+    }
+    pthread_mutex_unlock(&ras->lock);
+    return NULL;
+}
+
+// switch to the next buffer (waiting for the worker if need be), carrying over the unread bytes of the current
+// one; returns false at the end of the stream
+static bool readahead_stream_advance(struct readahead_stream *ras) {
+    struct readahead_buffer *b = &ras->buffers[ras->cur];
+    struct readahead_buffer *next = &ras->buffers[ras->cur ^ 1];
+    size_t leftover = b->end - b->begin;
+    assert(leftover <= MAX_READAHEAD_STREAM_PEEK);
+    pthread_mutex_lock(&ras->lock);
+    while (next->state != rab_ready && !(ras->underlying_eos && !ras->worker_busy)) {
+        pthread_cond_wait(&ras->cond, &ras->lock);
+    }
+    bool ok = next->state == rab_ready;
+    if (ok) {
+        memcpy(next->data + next->begin - leftover, b->data + b->begin, leftover);
+        next->begin -= leftover;
+        next->state = rab_consuming;
+        b->state = rab_empty;
+        ras->cur ^= 1;
+        pthread_cond_broadcast(&ras->cond);
+    }
+    pthread_mutex_unlock(&ras->lock);
+    return ok;
+}
+
+static int32_t readahead_stream_read_internal(struct readahead_stream *ras, uint8_t *buffer, size_t len) {
+    size_t read = 0;
+    while (read < len) {
+        struct readahead_buffer *b = &ras->buffers[ras->cur];
+        size_t avail = b->end - b->begin;
+        if (!avail) {
+            if (!readahead_stream_advance(ras)) break;
+            continue;
+        }
+        size_t to_copy = MIN(len - read, avail);
+        if (buffer) memcpy(buffer + read, b->data + b->begin, to_copy);
+        b->begin += to_copy;
+        read += to_copy;
+    }
+    ras->pos += read;
+    return read;
+}
+
+int32_t readahead_stream_read(struct stream *s, uint8_t *buffer, size_t len, bool all_data_required) {
+    int32_t read = readahead_stream_read_internal(to_ras(s), buffer, len);
+    if (all_data_required) assert(read == len);
+    return read;
+}
+
+const uint8_t *readahead_stream_peek(struct stream *s, size_t min_len, size_t *available_len, bool *available_reaches_eos) {
+    assert(min_len <= MAX_READAHEAD_STREAM_PEEK);
+    struct readahead_stream *ras = to_ras(s);
+    struct readahead_buffer *b = &ras->buffers[ras->cur];
+    // even for min_len 0, make sure there is something available if possible
+    while (b->end - b->begin < MAX(min_len, 1) && readahead_stream_advance(ras)) {
+        b = &ras->buffers[ras->cur];
+    }
+    size_t avail = b->end - b->begin;
+    if (available_len) *available_len = avail;
+    if (available_reaches_eos) {
+        pthread_mutex_lock(&ras->lock);
+        *available_reaches_eos = ras->underlying_eos && !ras->worker_busy && ras->buffers[ras->cur ^ 1].state != rab_ready;
+        pthread_mutex_unlock(&ras->lock);
+    }
+    return avail >= min_len ? b->data + b->begin : NULL;
+}
+
+// must be called with the lock held and the worker idle; discards everything buffered
+static void readahead_stream_discard(struct readahead_stream *ras) {
+    for(int i = 0; i < 2; i++) {
+        ras->buffers[i].begin = ras->buffers[i].end = MAX_READAHEAD_STREAM_PEEK;
+        ras->buffers[i].state = i == ras->cur ? rab_consuming : rab_empty;
+    }
+}
+
+void readahead_stream_reset(struct stream *s) {
+    struct readahead_stream *ras = to_ras(s);
+    pthread_mutex_lock(&ras->lock);
+    while (ras->worker_busy) pthread_cond_wait(&ras->cond, &ras->lock);
+    stream_reset(ras->underlying);
+    readahead_stream_discard(ras);
+    ras->underlying_eos = false;
+    ras->pos = ras->underlying_pos = 0;
+    pthread_cond_broadcast(&ras->cond);
+    pthread_mutex_unlock(&ras->lock);
+}
+
+bool readahead_stream_skip(struct stream *s, size_t bytes) {
+    struct readahead_stream *ras = to_ras(s);
+    struct readahead_buffer *b = &ras->buffers[ras->cur];
+    size_t avail = b->end - b->begin;
+    if (bytes <= avail) {
+        b->begin += bytes;
+        ras->pos += bytes;
+        return true;
+    }
+    // skipping past the buffered data; let the underlying stream skip (it may be able to do so cheaply)
+    pthread_mutex_lock(&ras->lock);
+    while (ras->worker_busy) pthread_cond_wait(&ras->cond, &ras->lock);
+    struct readahead_buffer *next = &ras->buffers[ras->cur ^ 1];
+    size_t buffered = avail + (next->state == rab_ready ? next->end - next->begin : 0);
+    bool rc;
+    if (bytes < buffered) {
+        pthread_mutex_unlock(&ras->lock);
+        return bytes == readahead_stream_read_internal(ras, NULL, bytes);
+    }
+    size_t remaining = bytes - buffered;
+    rc = ras->underlying_eos ? !remaining : stream_skip(ras->underlying, remaining);
+    if (!rc) ras->underlying_eos = true;
+    readahead_stream_discard(ras);
+    // we don't know how far we got on failure, but it no longer matters
+    ras->pos += bytes;
+    ras->underlying_pos = ras->pos;
+    pthread_cond_broadcast(&ras->cond);
+    pthread_mutex_unlock(&ras->lock);
+    return rc;
+}
+
+bool readahead_stream_is_eos(struct stream *s) {
+    bool eos;
+    readahead_stream_peek(s, 0, NULL, &eos);
+    struct readahead_stream *ras = to_ras(s);
+    return eos && ras->buffers[ras->cur].end == ras->buffers[ras->cur].begin;
+}
+
+void readahead_stream_close(struct stream *s) {
+    struct readahead_stream *ras = to_ras(s);
+    pthread_mutex_lock(&ras->lock);
+    ras->closing = true;
+    pthread_cond_broadcast(&ras->cond);
+    pthread_mutex_unlock(&ras->lock);
+    pthread_join(ras->thread, NULL);
+    pthread_cond_destroy(&ras->cond);
+    pthread_mutex_destroy(&ras->lock);
+    stream_close(ras->underlying);
+    free(ras->buffers[0].data);
+    free(ras->buffers[1].data);
+    free(ras);
+}
+
+uint32_t readahead_stream_pos(struct stream *s) {
+    return to_ras(s)->pos;
+}
+
+const struct stream_funcs readahead_stream_funcs = {
+    .reset = readahead_stream_reset,
+    .skip = readahead_stream_skip,
+    .peek = readahead_stream_peek,
+    .read = readahead_stream_read,
+    .close = readahead_stream_close,
+    .is_eos = readahead_stream_is_eos,
+#ifndef NDEBUG
+    .pos = readahead_stream_pos,
+#endif
+#ifndef NDEBUG
+    .type = readahead
+#endif
+};
+
+struct stream *readahead_stream_open(struct stream *underlying, size_t chunk_size) {
+    struct readahead_stream *ras = (struct readahead_stream *)calloc(1, sizeof(struct readahead_stream));
+    if (!chunk_size) chunk_size = READAHEAD_STREAM_CHUNK_SIZE;
+    ras->self.funcs = &readahead_stream_funcs;
+    ras->self.size = underlying->size;
+    ras->underlying = underlying;
+    ras->chunk_size = chunk_size;
+    ras->buffers[0].data = (uint8_t *)malloc(MAX_READAHEAD_STREAM_PEEK + chunk_size);
+    ras->buffers[1].data = (uint8_t *)malloc(MAX_READAHEAD_STREAM_PEEK + chunk_size);
+    ras->cur = 1;
+    readahead_stream_discard(ras);
+    pthread_mutex_init(&ras->lock, NULL);
+    pthread_cond_init(&ras->cond, NULL);
+    if (!ras->buffers[0].data || !ras->buffers[1].data ||
+        pthread_create(&ras->thread, NULL, readahead_stream_worker, ras)) {
+        pthread_cond_destroy(&ras->cond);
+        pthread_mutex_destroy(&ras->lock);
+        free(ras->buffers[0].data);
+        free(ras->buffers[1].data);
+        free(ras);
+        return NULL;
+    }
+    return &ras->self;
+}
+#endif
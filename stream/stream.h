@@ -14,9 +14,35 @@ extern "C" {
 #endif
 
 #ifdef ENABLE_COMPRESSED_STREAM
-// statically allocate all state (this is the only option right now!)
-#define USE_SINGLE_COMPRESSED_STREAM_INSTANCE
+// define USE_SINGLE_COMPRESSED_STREAM_INSTANCE to statically allocate the state for a single compressed stream (only
+// one may be in use at a time); otherwise the state is allocated per stream from a pool of MAX_COMPRESSED_STREAMS
+#ifndef MAX_COMPRESSED_STREAMS
+#define MAX_COMPRESSED_STREAMS 16
+#endif
 #define MAX_COMPRESSED_STREAM_PEEK 128
+// native builds record inflate checkpoints (decompressor state + dictionary) roughly every
+// COMPRESSED_STREAM_CHECKPOINT_INTERVAL bytes of output on first pass, so that a skip after a reset only
+// re-inflates from the nearest checkpoint. Each checkpoint is a tinfl_decompressor plus the TINFL_LZ_DICT_SIZE
+// dictionary: 9064 bytes on a 64 bit host, with the 4 bit fast lookup miniz_tinfl.h is configured for (checked in
+// stream.c), so this is off on device
+#if !PICO_ON_DEVICE && !defined(NO_USE_COMPRESSED_STREAM_CHECKPOINTS)
+#define ENABLE_COMPRESSED_STREAM_CHECKPOINTS
+#ifndef COMPRESSED_STREAM_CHECKPOINT_INTERVAL
+#define COMPRESSED_STREAM_CHECKPOINT_INTERVAL (256 * 1024)
+#endif
+#endif
+#endif
+
+#if !PICO_ON_DEVICE && !defined(NO_USE_MMAP_STREAM) && (defined(__unix__) || defined(__APPLE__))
+#define ENABLE_MMAP_STREAM
+#endif
+
+#if !PICO_ON_DEVICE && !defined(NO_USE_READAHEAD_STREAM) && (defined(__unix__) || defined(__APPLE__))
+#define ENABLE_READAHEAD_STREAM
+#define MAX_READAHEAD_STREAM_PEEK 128
+#ifndef READAHEAD_STREAM_CHUNK_SIZE
+#define READAHEAD_STREAM_CHUNK_SIZE (32 * 1024)
+#endif
 #endif
 
 struct stream;
@@ -41,7 +67,8 @@ typedef uint32_t (*stream_pos_func)(struct stream *stream);
 enum stream_type {
     memory,
     compressed,
-    xip
+    xip,
+    readahead
 };
 
 struct stream_funcs {
@@ -71,8 +98,25 @@ struct stream *memory_stream_open(const uint8_t *buffer, size_t size, bool free_
 
 struct stream *xip_stream_open(const uint8_t *buffer, size_t size, size_t buffer_size, uint dma_channel);
 
+#ifdef ENABLE_MMAP_STREAM
+// map the whole file read-only; the stream behaves like a memory stream (peek returns pointers into the mapping).
+// returns NULL if the file cannot be opened or mapped
+struct stream *mmap_stream_open(const char *filename);
+#endif
+
+#ifdef ENABLE_READAHEAD_STREAM
+// wraps (and takes ownership of) underlying, reading it ahead on a worker thread into a double buffer of
+// chunk_size (0 for READAHEAD_STREAM_CHUNK_SIZE) byte halves. returns NULL if the thread cannot be started
+struct stream *readahead_stream_open(struct stream *underlying, size_t chunk_size);
+#endif
+
 #ifdef ENABLE_COMPRESSED_STREAM
 
+// data starting with this is in the (LZ4 style) FAST format rather than zlib; see embed_tool
+#define COMPRESSED_STREAM_FAST_MAGIC "ZXF1"
+
+// underlying may be zlib or FAST format data (detected on reset).
+// returns NULL if there is no compressed stream state available (in which case underlying is not closed)
 struct stream *compressed_stream_open(struct stream *underlying, size_t uncompressed_size);
 
 #endif
@@ -0,0 +1,55 @@
+/*
+Portable ZX-Spectrum emulator.
+Copyright (C) 2001-2010 SMT, Dexus, Alone Coder, deathsoft, djdron, scor
+Copyright (C) 2023 Graham Sanderson
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef	__ARENA_H__
+#define	__ARENA_H__
+
+#include "../std.h"
+#include <new>
+
+#pragma once
+
+//*****************************************************************************
+//	eArena
+//-----------------------------------------------------------------------------
+// hands out consecutive pieces of a block the owner allocated, nothing is freed on its own (the block goes in one go)
+class eArena
+{
+public:
+	enum { LINE = 64 }; // cache line
+	eArena(void* _base, size_t _size) : base((byte*)_base), size(_size), used(0) {}
+
+	static constexpr size_t Align(size_t s, size_t align = LINE) { return (s + align - 1) & ~(align - 1); }
+	void* Alloc(size_t s, size_t align = LINE)
+	{
+		used = Align(used, align);
+		assert(used + s <= size);
+		void* p = base + used;
+		used += s;
+		return p;
+	}
+	size_t Used() const { return used; }
+
+protected:
+	byte*	base;
+	size_t	size;
+	size_t	used;
+};
+
+#endif//__ARENA_H__
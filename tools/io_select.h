@@ -28,9 +28,7 @@ namespace xIo
 class eFileSelect
 {
 public:
-#ifndef NO_USE_DESTRUCTORS
-	virtual ~eFileSelect() {}
-#endif
+	virtual ~eFileSelect() {} // kept with NO_USE_DESTRUCTORS too, implementations hold open directory handles
 	virtual bool Valid() const = 0;
 	virtual void Next() = 0;
 	virtual const char* Name() const = 0;
@@ -70,10 +70,16 @@ void eZ80::Reset()
 	handler.step = NULL;
 #endif
 	handler.io = NULL;
+#ifndef NO_USE_REPLAY
+	handler.record = NULL;
+#endif
 	int_flags = 0;
 	ir = 0;
 	im = 0;
 	pc = 0;
+#ifndef NO_USE_WATCH
+	watch.int_done = false;
+#endif
 }
 //=============================================================================
 //	eZ80::Read
@@ -120,7 +126,11 @@ void eZ80::StepF()
 #ifndef NO_USE_FAST_TAPE
 	SAFE_CALL(handler.step)->Z80_Step(this);
 #endif
+#ifdef USE_Z80_GEN
+	Dispatch(Fetch());
+#else
 	(this->*normal_opcodes[Fetch()])();
+#endif
 }
 //=============================================================================
 //	eZ80::Step
@@ -136,31 +146,102 @@ void eZ80::Step()
 #endif
 #endif
 	rom->Read(pc);
+#ifdef USE_Z80_GEN
+	Dispatch(Fetch());
+#else
 	(this->*normal_opcodes[Fetch()])();
+#endif
+}
+#ifndef NO_USE_WATCH
+//=============================================================================
+//	eZ80::StepW
+//-----------------------------------------------------------------------------
+bool eZ80::StepW()
+{
+	if(watch.flags & eWatch::W_PC)
+	{
+		if(watch.pc_skip)
+			watch.pc_skip = false;
+		else if(watch.pc_map[pc >> 3] & (1 << (pc & 7)))
+			watch.hit |= eWatch::W_PC;
+	}
+	if(!watch.hit)
+	{
+#ifndef NO_USE_FAST_TAPE
+		if(handler.step)
+			StepF();
+		else
+#endif
+			Step();
+		if(watch.flags & eWatch::W_MEM)
+		{
+			byte v = memory->Read(watch.mem_addr) & watch.mem_mask;
+			if((v == watch.mem_value) != watch.mem_change)
+				watch.hit |= eWatch::W_MEM;
+		}
+		if((watch.flags & eWatch::W_TSTATES) && t >= watch.t_stop)
+			watch.hit |= eWatch::W_TSTATES;
+	}
+	return !watch.hit; // W_PORT is set by IoRead()/IoWrite()
 }
+#endif
 //=============================================================================
 //	eZ80::Update
 //-----------------------------------------------------------------------------
 void eZ80::Update(int int_len, int* nmi_pending)
 {
+#ifndef NO_USE_WATCH
+	if(!watch.int_done) // not again when carrying on after a stop past it
+#endif
+	{
 //#define NO_USE_INTERRUPTS
 #ifndef NO_USE_INTERRUPTS
-	if(!iff1 && halted)
-		return;
-	// INT check separated from main Z80 loop to improve emulation speed
-	while(t < int_len)
+		if(!iff1 && halted)
+			return;
+		// INT check separated from main Z80 loop to improve emulation speed
+		while(t < int_len)
+		{
+			if(iff1 && t != eipos) // int enabled in CPU not issued after EI
+			{
+#ifndef NO_USE_REPLAY
+				if(handler.record)
+				{
+					handler.record->Z80_FrameRecord(-fetches);
+					fetches = 0;
+				}
+#endif
+				Int();
+				break;
+			}
+#ifndef NO_USE_WATCH
+			if(watch.flags)
+			{
+				if(!StepW())
+					return;
+			}
+			else
+#endif
+			Step();
+			if(halted)
+				break;
+		}
+#endif
+		eipos = -1;
+#ifndef NO_USE_WATCH
+		watch.int_done = true;
+#endif
+	}
+#ifndef NO_USE_WATCH
+	if(watch.flags)
 	{
-		if(iff1 && t != eipos) // int enabled in CPU not issued after EI
+		while(t < frame_tacts)
 		{
-			Int();
-			break;
+			if(!StepW())
+				return;
 		}
-		Step();
-		if(halted)
-			break;
 	}
+	else
 #endif
-	eipos = -1;
 #ifndef NO_USE_FAST_TAPE
 	if(handler.step)
 	{
@@ -188,6 +269,20 @@ void eZ80::Update(int int_len, int* nmi_pending)
 	}
 	t -= frame_tacts;
 	eipos -= frame_tacts;
+#ifndef NO_USE_WATCH
+	watch.t_stop -= frame_tacts;
+	watch.int_done = false;
+#endif
+#ifndef NO_USE_REPLAY
+	if(!handler.record)
+		fetches = 0; // only counted when recording
+	else if(!iff1)
+	{
+		// no interrupt coming to end the frame on, so end it here, Replay() won't issue one either
+		handler.record->Z80_FrameRecord(-fetches);
+		fetches = 0;
+	}
+#endif
 }
 #ifndef NO_USE_REPLAY
 //=============================================================================
@@ -101,6 +101,40 @@ public:
 	void HandlerIo(eHandlerIo* h) { handler.io = h; }
 	eHandlerIo* HandlerIo() const { return handler.io; }
 
+#ifndef NO_USE_REPLAY
+	// .rzx recording: every port read value, and the fetch count each time a frame ends (at an interrupt, or at the
+	// end of Update() with interrupts disabled), which is the frame Replay() plays back
+	class eHandlerRecord
+	{
+	public:
+		virtual void Z80_IoRecord(byte v) = 0;
+		virtual void Z80_FrameRecord(int fetches) = 0;
+	};
+	void HandlerRecord(eHandlerRecord* h) { handler.record = h; fetches = 0; }
+	eHandlerRecord* HandlerRecord() const { return handler.record; }
+	// ends the frame in progress now, between Update()s that is where its interrupt would come
+	void RecordFrame()
+	{
+		if(handler.record && fetches)
+		{
+			handler.record->Z80_FrameRecord(-fetches);
+			fetches = 0;
+		}
+	}
+#endif
+
+#ifdef USE_Z80_TRACE
+	// every memory write and port access as the core makes them, for checking one core against another
+	class eHandlerTrace
+	{
+	public:
+		virtual void Z80_Write(word addr, byte v, int tact) = 0;
+		virtual void Z80_Io(word port, byte v, bool out, int tact) = 0;
+	};
+	void HandlerTrace(eHandlerTrace* h) { handler.trace = h; }
+	eHandlerTrace* HandlerTrace() const { return handler.trace; }
+#endif
+
 	class eHandlerStep
 	{
 	public:
@@ -111,11 +145,38 @@ public:
 	eHandlerStep* HandlerStep() const { return handler.step; }
 #endif
 
+#ifndef NO_USE_WATCH
+	// stop conditions; while any are enabled Update() steps with StepW() and returns part way through the frame once
+	// one is hit, the next Update() carries on from there
+	struct eWatch
+	{
+		enum eFlag { W_PC = 0x01, W_MEM = 0x02, W_PORT = 0x04, W_TSTATES = 0x08 };
+		eWatch() : flags(0), hit(0), pc_map(NULL), pc_skip(false), mem_addr(0), mem_mask(0), mem_value(0)
+			, mem_change(false), port_mask(0), port_value(0), t_stop(0), int_done(false) {}
+		dword flags;		// enabled conditions
+		dword hit;			// conditions met
+		const byte* pc_map;	// bit per address, checked before the instruction there runs
+		bool pc_skip;		// don't check the first instruction, to get going again from a pc hit
+		word mem_addr;		// stop when (byte & mem_mask) == mem_value, or != it with mem_change
+		byte mem_mask;
+		byte mem_value;
+		bool mem_change;
+		word port_mask;		// stop on in/out with (port & port_mask) == port_value
+		word port_value;
+		int t_stop;			// in frame t-states, moves back a frame every frame
+		bool int_done;		// past the frame's interrupt check, so a stop doesn't get it issued again on resume
+	};
+	eWatch& Watch() { return watch; }
+#endif
+
 //protected:
 	void Int();
 	void Nmi();
 	void Step();
 	void StepF();
+#ifndef NO_USE_WATCH
+	bool StepW();
+#endif
 	byte Fetch()
 	{
 #ifndef NO_USE_REPLAY
@@ -157,6 +218,15 @@ public:
 	#include "z80_op_ed.h"
 	#include "z80_op_fd.h"
 	#include "z80_op_ddcb.h"
+#ifdef USE_Z80_GEN
+	// switch decoding z80t generates from its tables, z80_gen.h
+	void Dispatch(byte opcode);
+	void OpCB();
+	void OpDD();
+	void OpED();
+	void OpFD();
+	void OpDDCB(dword ptr);
+#endif
 
 	void InitOpNoPrefix();
 	void InitOpCB();
@@ -226,14 +296,29 @@ public:
 		eHandler() : io(NULL)
 #ifndef NO_USE_FAST_TAPE
 		,step(NULL)
+#endif
+#ifndef NO_USE_REPLAY
+		,record(NULL)
+#endif
+#ifdef USE_Z80_TRACE
+		,trace(NULL)
 #endif
 		{}
 		eHandlerIo*	io;
 #ifndef NO_USE_FAST_TAPE
 		eHandlerStep* step;
+#endif
+#ifndef NO_USE_REPLAY
+		eHandlerRecord* record;
+#endif
+#ifdef USE_Z80_TRACE
+		eHandlerTrace* trace;
 #endif
 	};
 	eHandler handler;
+#ifndef NO_USE_WATCH
+	mutable eWatch watch; // hit is set by IoRead() too
+#endif
 
 	int		t;
 	int		im;
@@ -305,6 +390,8 @@ public:
 	inline void set_caller_ix(word v) { ix = v; }
 	inline word get_caller_de() const { return de; }
 	inline void set_caller_de(word v) { de = v; }
+	inline word get_caller_hl() const { return hl; }
+	inline void set_caller_hl(word v) { hl = v; }
 	inline void delta_caller_t(int delta) { t += delta; }
 };
 
@@ -0,0 +1,1378 @@
+// ================================
+// == AUTOGENERATED: DO NOT EDIT ==
+// ================================
+
+// decoding for the host core (USE_Z80_GEN), from the tables z80khan_gen.S is made from. every case is the
+// op inlined into the switch, so operands, flag masks and t-states are constants there
+
+//=============================================================================
+//	eZ80::Dispatch
+//-----------------------------------------------------------------------------
+void eZ80::Dispatch(byte opcode)
+{
+	switch(opcode)
+	{
+	case 0x00: Op00(); break;
+	case 0x01: Op01(); break;
+	case 0x02: Op02(); break;
+	case 0x03: Op03(); break;
+	case 0x04: Op04(); break;
+	case 0x05: Op05(); break;
+	case 0x06: Op06(); break;
+	case 0x07: Op07(); break;
+	case 0x08: Op08(); break;
+	case 0x09: Op09(); break;
+	case 0x0a: Op0A(); break;
+	case 0x0b: Op0B(); break;
+	case 0x0c: Op0C(); break;
+	case 0x0d: Op0D(); break;
+	case 0x0e: Op0E(); break;
+	case 0x0f: Op0F(); break;
+	case 0x10: Op10(); break;
+	case 0x11: Op11(); break;
+	case 0x12: Op12(); break;
+	case 0x13: Op13(); break;
+	case 0x14: Op14(); break;
+	case 0x15: Op15(); break;
+	case 0x16: Op16(); break;
+	case 0x17: Op17(); break;
+	case 0x18: Op18(); break;
+	case 0x19: Op19(); break;
+	case 0x1a: Op1A(); break;
+	case 0x1b: Op1B(); break;
+	case 0x1c: Op1C(); break;
+	case 0x1d: Op1D(); break;
+	case 0x1e: Op1E(); break;
+	case 0x1f: Op1F(); break;
+	case 0x20: Op20(); break;
+	case 0x21: Op21(); break;
+	case 0x22: Op22(); break;
+	case 0x23: Op23(); break;
+	case 0x24: Op24(); break;
+	case 0x25: Op25(); break;
+	case 0x26: Op26(); break;
+	case 0x27: Op27(); break;
+	case 0x28: Op28(); break;
+	case 0x29: Op29(); break;
+	case 0x2a: Op2A(); break;
+	case 0x2b: Op2B(); break;
+	case 0x2c: Op2C(); break;
+	case 0x2d: Op2D(); break;
+	case 0x2e: Op2E(); break;
+	case 0x2f: Op2F(); break;
+	case 0x30: Op30(); break;
+	case 0x31: Op31(); break;
+	case 0x32: Op32(); break;
+	case 0x33: Op33(); break;
+	case 0x34: Op34(); break;
+	case 0x35: Op35(); break;
+	case 0x36: Op36(); break;
+	case 0x37: Op37(); break;
+	case 0x38: Op38(); break;
+	case 0x39: Op39(); break;
+	case 0x3a: Op3A(); break;
+	case 0x3b: Op3B(); break;
+	case 0x3c: Op3C(); break;
+	case 0x3d: Op3D(); break;
+	case 0x3e: Op3E(); break;
+	case 0x3f: Op3F(); break;
+	case 0x40: Op40(); break;
+	case 0x41: Op41(); break;
+	case 0x42: Op42(); break;
+	case 0x43: Op43(); break;
+	case 0x44: Op44(); break;
+	case 0x45: Op45(); break;
+	case 0x46: Op46(); break;
+	case 0x47: Op47(); break;
+	case 0x48: Op48(); break;
+	case 0x49: Op49(); break;
+	case 0x4a: Op4A(); break;
+	case 0x4b: Op4B(); break;
+	case 0x4c: Op4C(); break;
+	case 0x4d: Op4D(); break;
+	case 0x4e: Op4E(); break;
+	case 0x4f: Op4F(); break;
+	case 0x50: Op50(); break;
+	case 0x51: Op51(); break;
+	case 0x52: Op52(); break;
+	case 0x53: Op53(); break;
+	case 0x54: Op54(); break;
+	case 0x55: Op55(); break;
+	case 0x56: Op56(); break;
+	case 0x57: Op57(); break;
+	case 0x58: Op58(); break;
+	case 0x59: Op59(); break;
+	case 0x5a: Op5A(); break;
+	case 0x5b: Op5B(); break;
+	case 0x5c: Op5C(); break;
+	case 0x5d: Op5D(); break;
+	case 0x5e: Op5E(); break;
+	case 0x5f: Op5F(); break;
+	case 0x60: Op60(); break;
+	case 0x61: Op61(); break;
+	case 0x62: Op62(); break;
+	case 0x63: Op63(); break;
+	case 0x64: Op64(); break;
+	case 0x65: Op65(); break;
+	case 0x66: Op66(); break;
+	case 0x67: Op67(); break;
+	case 0x68: Op68(); break;
+	case 0x69: Op69(); break;
+	case 0x6a: Op6A(); break;
+	case 0x6b: Op6B(); break;
+	case 0x6c: Op6C(); break;
+	case 0x6d: Op6D(); break;
+	case 0x6e: Op6E(); break;
+	case 0x6f: Op6F(); break;
+	case 0x70: Op70(); break;
+	case 0x71: Op71(); break;
+	case 0x72: Op72(); break;
+	case 0x73: Op73(); break;
+	case 0x74: Op74(); break;
+	case 0x75: Op75(); break;
+	case 0x76: Op76(); break;
+	case 0x77: Op77(); break;
+	case 0x78: Op78(); break;
+	case 0x79: Op79(); break;
+	case 0x7a: Op7A(); break;
+	case 0x7b: Op7B(); break;
+	case 0x7c: Op7C(); break;
+	case 0x7d: Op7D(); break;
+	case 0x7e: Op7E(); break;
+	case 0x7f: Op7F(); break;
+	case 0x80: Op80(); break;
+	case 0x81: Op81(); break;
+	case 0x82: Op82(); break;
+	case 0x83: Op83(); break;
+	case 0x84: Op84(); break;
+	case 0x85: Op85(); break;
+	case 0x86: Op86(); break;
+	case 0x87: Op87(); break;
+	case 0x88: Op88(); break;
+	case 0x89: Op89(); break;
+	case 0x8a: Op8A(); break;
+	case 0x8b: Op8B(); break;
+	case 0x8c: Op8C(); break;
+	case 0x8d: Op8D(); break;
+	case 0x8e: Op8E(); break;
+	case 0x8f: Op8F(); break;
+	case 0x90: Op90(); break;
+	case 0x91: Op91(); break;
+	case 0x92: Op92(); break;
+	case 0x93: Op93(); break;
+	case 0x94: Op94(); break;
+	case 0x95: Op95(); break;
+	case 0x96: Op96(); break;
+	case 0x97: Op97(); break;
+	case 0x98: Op98(); break;
+	case 0x99: Op99(); break;
+	case 0x9a: Op9A(); break;
+	case 0x9b: Op9B(); break;
+	case 0x9c: Op9C(); break;
+	case 0x9d: Op9D(); break;
+	case 0x9e: Op9E(); break;
+	case 0x9f: Op9F(); break;
+	case 0xa0: OpA0(); break;
+	case 0xa1: OpA1(); break;
+	case 0xa2: OpA2(); break;
+	case 0xa3: OpA3(); break;
+	case 0xa4: OpA4(); break;
+	case 0xa5: OpA5(); break;
+	case 0xa6: OpA6(); break;
+	case 0xa7: OpA7(); break;
+	case 0xa8: OpA8(); break;
+	case 0xa9: OpA9(); break;
+	case 0xaa: OpAA(); break;
+	case 0xab: OpAB(); break;
+	case 0xac: OpAC(); break;
+	case 0xad: OpAD(); break;
+	case 0xae: OpAE(); break;
+	case 0xaf: OpAF(); break;
+	case 0xb0: OpB0(); break;
+	case 0xb1: OpB1(); break;
+	case 0xb2: OpB2(); break;
+	case 0xb3: OpB3(); break;
+	case 0xb4: OpB4(); break;
+	case 0xb5: OpB5(); break;
+	case 0xb6: OpB6(); break;
+	case 0xb7: OpB7(); break;
+	case 0xb8: OpB8(); break;
+	case 0xb9: OpB9(); break;
+	case 0xba: OpBA(); break;
+	case 0xbb: OpBB(); break;
+	case 0xbc: OpBC(); break;
+	case 0xbd: OpBD(); break;
+	case 0xbe: OpBE(); break;
+	case 0xbf: OpBF(); break;
+	case 0xc0: OpC0(); break;
+	case 0xc1: OpC1(); break;
+	case 0xc2: OpC2(); break;
+	case 0xc3: OpC3(); break;
+	case 0xc4: OpC4(); break;
+	case 0xc5: OpC5(); break;
+	case 0xc6: OpC6(); break;
+	case 0xc7: OpC7(); break;
+	case 0xc8: OpC8(); break;
+	case 0xc9: OpC9(); break;
+	case 0xca: OpCA(); break;
+	case 0xcb: OpCB(); break;
+	case 0xcc: OpCC(); break;
+	case 0xcd: OpCD(); break;
+	case 0xce: OpCE(); break;
+	case 0xcf: OpCF(); break;
+	case 0xd0: OpD0(); break;
+	case 0xd1: OpD1(); break;
+	case 0xd2: OpD2(); break;
+	case 0xd3: OpD3(); break;
+	case 0xd4: OpD4(); break;
+	case 0xd5: OpD5(); break;
+	case 0xd6: OpD6(); break;
+	case 0xd7: OpD7(); break;
+	case 0xd8: OpD8(); break;
+	case 0xd9: OpD9(); break;
+	case 0xda: OpDA(); break;
+	case 0xdb: OpDB(); break;
+	case 0xdc: OpDC(); break;
+	case 0xdd: OpDD(); break;
+	case 0xde: OpDE(); break;
+	case 0xdf: OpDF(); break;
+	case 0xe0: OpE0(); break;
+	case 0xe1: OpE1(); break;
+	case 0xe2: OpE2(); break;
+	case 0xe3: OpE3(); break;
+	case 0xe4: OpE4(); break;
+	case 0xe5: OpE5(); break;
+	case 0xe6: OpE6(); break;
+	case 0xe7: OpE7(); break;
+	case 0xe8: OpE8(); break;
+	case 0xe9: OpE9(); break;
+	case 0xea: OpEA(); break;
+	case 0xeb: OpEB(); break;
+	case 0xec: OpEC(); break;
+	case 0xed: OpED(); break;
+	case 0xee: OpEE(); break;
+	case 0xef: OpEF(); break;
+	case 0xf0: OpF0(); break;
+	case 0xf1: OpF1(); break;
+	case 0xf2: OpF2(); break;
+	case 0xf3: OpF3(); break;
+	case 0xf4: OpF4(); break;
+	case 0xf5: OpF5(); break;
+	case 0xf6: OpF6(); break;
+	case 0xf7: OpF7(); break;
+	case 0xf8: OpF8(); break;
+	case 0xf9: OpF9(); break;
+	case 0xfa: OpFA(); break;
+	case 0xfb: OpFB(); break;
+	case 0xfc: OpFC(); break;
+	case 0xfd: OpFD(); break;
+	case 0xfe: OpFE(); break;
+	case 0xff: OpFF(); break;
+	}
+}
+//=============================================================================
+//	eZ80::OpCB
+//-----------------------------------------------------------------------------
+void eZ80::OpCB()
+{
+	switch(Fetch())
+	{
+	case 0x00: Opl00(); break;
+	case 0x01: Opl01(); break;
+	case 0x02: Opl02(); break;
+	case 0x03: Opl03(); break;
+	case 0x04: Opl04(); break;
+	case 0x05: Opl05(); break;
+	case 0x06: Opl06(); break;
+	case 0x07: Opl07(); break;
+	case 0x08: Opl08(); break;
+	case 0x09: Opl09(); break;
+	case 0x0a: Opl0A(); break;
+	case 0x0b: Opl0B(); break;
+	case 0x0c: Opl0C(); break;
+	case 0x0d: Opl0D(); break;
+	case 0x0e: Opl0E(); break;
+	case 0x0f: Opl0F(); break;
+	case 0x10: Opl10(); break;
+	case 0x11: Opl11(); break;
+	case 0x12: Opl12(); break;
+	case 0x13: Opl13(); break;
+	case 0x14: Opl14(); break;
+	case 0x15: Opl15(); break;
+	case 0x16: Opl16(); break;
+	case 0x17: Opl17(); break;
+	case 0x18: Opl18(); break;
+	case 0x19: Opl19(); break;
+	case 0x1a: Opl1A(); break;
+	case 0x1b: Opl1B(); break;
+	case 0x1c: Opl1C(); break;
+	case 0x1d: Opl1D(); break;
+	case 0x1e: Opl1E(); break;
+	case 0x1f: Opl1F(); break;
+	case 0x20: Opl20(); break;
+	case 0x21: Opl21(); break;
+	case 0x22: Opl22(); break;
+	case 0x23: Opl23(); break;
+	case 0x24: Opl24(); break;
+	case 0x25: Opl25(); break;
+	case 0x26: Opl26(); break;
+	case 0x27: Opl27(); break;
+	case 0x28: Opl28(); break;
+	case 0x29: Opl29(); break;
+	case 0x2a: Opl2A(); break;
+	case 0x2b: Opl2B(); break;
+	case 0x2c: Opl2C(); break;
+	case 0x2d: Opl2D(); break;
+	case 0x2e: Opl2E(); break;
+	case 0x2f: Opl2F(); break;
+	case 0x30: Opl30(); break;
+	case 0x31: Opl31(); break;
+	case 0x32: Opl32(); break;
+	case 0x33: Opl33(); break;
+	case 0x34: Opl34(); break;
+	case 0x35: Opl35(); break;
+	case 0x36: Opl36(); break;
+	case 0x37: Opl37(); break;
+	case 0x38: Opl38(); break;
+	case 0x39: Opl39(); break;
+	case 0x3a: Opl3A(); break;
+	case 0x3b: Opl3B(); break;
+	case 0x3c: Opl3C(); break;
+	case 0x3d: Opl3D(); break;
+	case 0x3e: Opl3E(); break;
+	case 0x3f: Opl3F(); break;
+	case 0x40: Opl40(); break;
+	case 0x41: Opl41(); break;
+	case 0x42: Opl42(); break;
+	case 0x43: Opl43(); break;
+	case 0x44: Opl44(); break;
+	case 0x45: Opl45(); break;
+	case 0x46: Opl46(); break;
+	case 0x47: Opl47(); break;
+	case 0x48: Opl48(); break;
+	case 0x49: Opl49(); break;
+	case 0x4a: Opl4A(); break;
+	case 0x4b: Opl4B(); break;
+	case 0x4c: Opl4C(); break;
+	case 0x4d: Opl4D(); break;
+	case 0x4e: Opl4E(); break;
+	case 0x4f: Opl4F(); break;
+	case 0x50: Opl50(); break;
+	case 0x51: Opl51(); break;
+	case 0x52: Opl52(); break;
+	case 0x53: Opl53(); break;
+	case 0x54: Opl54(); break;
+	case 0x55: Opl55(); break;
+	case 0x56: Opl56(); break;
+	case 0x57: Opl57(); break;
+	case 0x58: Opl58(); break;
+	case 0x59: Opl59(); break;
+	case 0x5a: Opl5A(); break;
+	case 0x5b: Opl5B(); break;
+	case 0x5c: Opl5C(); break;
+	case 0x5d: Opl5D(); break;
+	case 0x5e: Opl5E(); break;
+	case 0x5f: Opl5F(); break;
+	case 0x60: Opl60(); break;
+	case 0x61: Opl61(); break;
+	case 0x62: Opl62(); break;
+	case 0x63: Opl63(); break;
+	case 0x64: Opl64(); break;
+	case 0x65: Opl65(); break;
+	case 0x66: Opl66(); break;
+	case 0x67: Opl67(); break;
+	case 0x68: Opl68(); break;
+	case 0x69: Opl69(); break;
+	case 0x6a: Opl6A(); break;
+	case 0x6b: Opl6B(); break;
+	case 0x6c: Opl6C(); break;
+	case 0x6d: Opl6D(); break;
+	case 0x6e: Opl6E(); break;
+	case 0x6f: Opl6F(); break;
+	case 0x70: Opl70(); break;
+	case 0x71: Opl71(); break;
+	case 0x72: Opl72(); break;
+	case 0x73: Opl73(); break;
+	case 0x74: Opl74(); break;
+	case 0x75: Opl75(); break;
+	case 0x76: Opl76(); break;
+	case 0x77: Opl77(); break;
+	case 0x78: Opl78(); break;
+	case 0x79: Opl79(); break;
+	case 0x7a: Opl7A(); break;
+	case 0x7b: Opl7B(); break;
+	case 0x7c: Opl7C(); break;
+	case 0x7d: Opl7D(); break;
+	case 0x7e: Opl7E(); break;
+	case 0x7f: Opl7F(); break;
+	case 0x80: Opl80(); break;
+	case 0x81: Opl81(); break;
+	case 0x82: Opl82(); break;
+	case 0x83: Opl83(); break;
+	case 0x84: Opl84(); break;
+	case 0x85: Opl85(); break;
+	case 0x86: Opl86(); break;
+	case 0x87: Opl87(); break;
+	case 0x88: Opl88(); break;
+	case 0x89: Opl89(); break;
+	case 0x8a: Opl8A(); break;
+	case 0x8b: Opl8B(); break;
+	case 0x8c: Opl8C(); break;
+	case 0x8d: Opl8D(); break;
+	case 0x8e: Opl8E(); break;
+	case 0x8f: Opl8F(); break;
+	case 0x90: Opl90(); break;
+	case 0x91: Opl91(); break;
+	case 0x92: Opl92(); break;
+	case 0x93: Opl93(); break;
+	case 0x94: Opl94(); break;
+	case 0x95: Opl95(); break;
+	case 0x96: Opl96(); break;
+	case 0x97: Opl97(); break;
+	case 0x98: Opl98(); break;
+	case 0x99: Opl99(); break;
+	case 0x9a: Opl9A(); break;
+	case 0x9b: Opl9B(); break;
+	case 0x9c: Opl9C(); break;
+	case 0x9d: Opl9D(); break;
+	case 0x9e: Opl9E(); break;
+	case 0x9f: Opl9F(); break;
+	case 0xa0: OplA0(); break;
+	case 0xa1: OplA1(); break;
+	case 0xa2: OplA2(); break;
+	case 0xa3: OplA3(); break;
+	case 0xa4: OplA4(); break;
+	case 0xa5: OplA5(); break;
+	case 0xa6: OplA6(); break;
+	case 0xa7: OplA7(); break;
+	case 0xa8: OplA8(); break;
+	case 0xa9: OplA9(); break;
+	case 0xaa: OplAA(); break;
+	case 0xab: OplAB(); break;
+	case 0xac: OplAC(); break;
+	case 0xad: OplAD(); break;
+	case 0xae: OplAE(); break;
+	case 0xaf: OplAF(); break;
+	case 0xb0: OplB0(); break;
+	case 0xb1: OplB1(); break;
+	case 0xb2: OplB2(); break;
+	case 0xb3: OplB3(); break;
+	case 0xb4: OplB4(); break;
+	case 0xb5: OplB5(); break;
+	case 0xb6: OplB6(); break;
+	case 0xb7: OplB7(); break;
+	case 0xb8: OplB8(); break;
+	case 0xb9: OplB9(); break;
+	case 0xba: OplBA(); break;
+	case 0xbb: OplBB(); break;
+	case 0xbc: OplBC(); break;
+	case 0xbd: OplBD(); break;
+	case 0xbe: OplBE(); break;
+	case 0xbf: OplBF(); break;
+	case 0xc0: OplC0(); break;
+	case 0xc1: OplC1(); break;
+	case 0xc2: OplC2(); break;
+	case 0xc3: OplC3(); break;
+	case 0xc4: OplC4(); break;
+	case 0xc5: OplC5(); break;
+	case 0xc6: OplC6(); break;
+	case 0xc7: OplC7(); break;
+	case 0xc8: OplC8(); break;
+	case 0xc9: OplC9(); break;
+	case 0xca: OplCA(); break;
+	case 0xcb: OplCB(); break;
+	case 0xcc: OplCC(); break;
+	case 0xcd: OplCD(); break;
+	case 0xce: OplCE(); break;
+	case 0xcf: OplCF(); break;
+	case 0xd0: OplD0(); break;
+	case 0xd1: OplD1(); break;
+	case 0xd2: OplD2(); break;
+	case 0xd3: OplD3(); break;
+	case 0xd4: OplD4(); break;
+	case 0xd5: OplD5(); break;
+	case 0xd6: OplD6(); break;
+	case 0xd7: OplD7(); break;
+	case 0xd8: OplD8(); break;
+	case 0xd9: OplD9(); break;
+	case 0xda: OplDA(); break;
+	case 0xdb: OplDB(); break;
+	case 0xdc: OplDC(); break;
+	case 0xdd: OplDD(); break;
+	case 0xde: OplDE(); break;
+	case 0xdf: OplDF(); break;
+	case 0xe0: OplE0(); break;
+	case 0xe1: OplE1(); break;
+	case 0xe2: OplE2(); break;
+	case 0xe3: OplE3(); break;
+	case 0xe4: OplE4(); break;
+	case 0xe5: OplE5(); break;
+	case 0xe6: OplE6(); break;
+	case 0xe7: OplE7(); break;
+	case 0xe8: OplE8(); break;
+	case 0xe9: OplE9(); break;
+	case 0xea: OplEA(); break;
+	case 0xeb: OplEB(); break;
+	case 0xec: OplEC(); break;
+	case 0xed: OplED(); break;
+	case 0xee: OplEE(); break;
+	case 0xef: OplEF(); break;
+	case 0xf0: OplF0(); break;
+	case 0xf1: OplF1(); break;
+	case 0xf2: OplF2(); break;
+	case 0xf3: OplF3(); break;
+	case 0xf4: OplF4(); break;
+	case 0xf5: OplF5(); break;
+	case 0xf6: OplF6(); break;
+	case 0xf7: OplF7(); break;
+	case 0xf8: OplF8(); break;
+	case 0xf9: OplF9(); break;
+	case 0xfa: OplFA(); break;
+	case 0xfb: OplFB(); break;
+	case 0xfc: OplFC(); break;
+	case 0xfd: OplFD(); break;
+	case 0xfe: OplFE(); break;
+	case 0xff: OplFF(); break;
+	}
+}
+//=============================================================================
+//	eZ80::OpDD
+//-----------------------------------------------------------------------------
+void eZ80::OpDD()
+{
+	switch(Fetch())
+	{
+	case 0x00: Op00(); break;
+	case 0x01: Op01(); break;
+	case 0x02: Op02(); break;
+	case 0x03: Op03(); break;
+	case 0x04: Op04(); break;
+	case 0x05: Op05(); break;
+	case 0x06: Op06(); break;
+	case 0x07: Op07(); break;
+	case 0x08: Op08(); break;
+	case 0x09: Opx09(); break;
+	case 0x0a: Op0A(); break;
+	case 0x0b: Op0B(); break;
+	case 0x0c: Op0C(); break;
+	case 0x0d: Op0D(); break;
+	case 0x0e: Op0E(); break;
+	case 0x0f: Op0F(); break;
+	case 0x10: Op10(); break;
+	case 0x11: Op11(); break;
+	case 0x12: Op12(); break;
+	case 0x13: Op13(); break;
+	case 0x14: Op14(); break;
+	case 0x15: Op15(); break;
+	case 0x16: Op16(); break;
+	case 0x17: Op17(); break;
+	case 0x18: Op18(); break;
+	case 0x19: Opx19(); break;
+	case 0x1a: Op1A(); break;
+	case 0x1b: Op1B(); break;
+	case 0x1c: Op1C(); break;
+	case 0x1d: Op1D(); break;
+	case 0x1e: Op1E(); break;
+	case 0x1f: Op1F(); break;
+	case 0x20: Op20(); break;
+	case 0x21: Opx21(); break;
+	case 0x22: Opx22(); break;
+	case 0x23: Opx23(); break;
+	case 0x24: Opx24(); break;
+	case 0x25: Opx25(); break;
+	case 0x26: Opx26(); break;
+	case 0x27: Op27(); break;
+	case 0x28: Op28(); break;
+	case 0x29: Opx29(); break;
+	case 0x2a: Opx2A(); break;
+	case 0x2b: Opx2B(); break;
+	case 0x2c: Opx2C(); break;
+	case 0x2d: Opx2D(); break;
+	case 0x2e: Opx2E(); break;
+	case 0x2f: Op2F(); break;
+	case 0x30: Op30(); break;
+	case 0x31: Op31(); break;
+	case 0x32: Op32(); break;
+	case 0x33: Op33(); break;
+	case 0x34: Opx34(); break;
+	case 0x35: Opx35(); break;
+	case 0x36: Opx36(); break;
+	case 0x37: Op37(); break;
+	case 0x38: Op38(); break;
+	case 0x39: Opx39(); break;
+	case 0x3a: Op3A(); break;
+	case 0x3b: Op3B(); break;
+	case 0x3c: Op3C(); break;
+	case 0x3d: Op3D(); break;
+	case 0x3e: Op3E(); break;
+	case 0x3f: Op3F(); break;
+	case 0x40: Op40(); break;
+	case 0x41: Op41(); break;
+	case 0x42: Op42(); break;
+	case 0x43: Op43(); break;
+	case 0x44: Opx44(); break;
+	case 0x45: Opx45(); break;
+	case 0x46: Opx46(); break;
+	case 0x47: Op47(); break;
+	case 0x48: Op48(); break;
+	case 0x49: Op49(); break;
+	case 0x4a: Op4A(); break;
+	case 0x4b: Op4B(); break;
+	case 0x4c: Opx4C(); break;
+	case 0x4d: Opx4D(); break;
+	case 0x4e: Opx4E(); break;
+	case 0x4f: Op4F(); break;
+	case 0x50: Op50(); break;
+	case 0x51: Op51(); break;
+	case 0x52: Op52(); break;
+	case 0x53: Op53(); break;
+	case 0x54: Opx54(); break;
+	case 0x55: Opx55(); break;
+	case 0x56: Opx56(); break;
+	case 0x57: Op57(); break;
+	case 0x58: Op58(); break;
+	case 0x59: Op59(); break;
+	case 0x5a: Op5A(); break;
+	case 0x5b: Op5B(); break;
+	case 0x5c: Opx5C(); break;
+	case 0x5d: Opx5D(); break;
+	case 0x5e: Opx5E(); break;
+	case 0x5f: Op5F(); break;
+	case 0x60: Opx60(); break;
+	case 0x61: Opx61(); break;
+	case 0x62: Opx62(); break;
+	case 0x63: Opx63(); break;
+	case 0x64: Op64(); break;
+	case 0x65: Opx65(); break;
+	case 0x66: Opx66(); break;
+	case 0x67: Opx67(); break;
+	case 0x68: Opx68(); break;
+	case 0x69: Opx69(); break;
+	case 0x6a: Opx6A(); break;
+	case 0x6b: Opx6B(); break;
+	case 0x6c: Opx6C(); break;
+	case 0x6d: Op6D(); break;
+	case 0x6e: Opx6E(); break;
+	case 0x6f: Opx6F(); break;
+	case 0x70: Opx70(); break;
+	case 0x71: Opx71(); break;
+	case 0x72: Opx72(); break;
+	case 0x73: Opx73(); break;
+	case 0x74: Opx74(); break;
+	case 0x75: Opx75(); break;
+	case 0x76: Op76(); break;
+	case 0x77: Opx77(); break;
+	case 0x78: Op78(); break;
+	case 0x79: Op79(); break;
+	case 0x7a: Op7A(); break;
+	case 0x7b: Op7B(); break;
+	case 0x7c: Opx7C(); break;
+	case 0x7d: Opx7D(); break;
+	case 0x7e: Opx7E(); break;
+	case 0x7f: Op7F(); break;
+	case 0x80: Op80(); break;
+	case 0x81: Op81(); break;
+	case 0x82: Op82(); break;
+	case 0x83: Op83(); break;
+	case 0x84: Opx84(); break;
+	case 0x85: Opx85(); break;
+	case 0x86: Opx86(); break;
+	case 0x87: Op87(); break;
+	case 0x88: Op88(); break;
+	case 0x89: Op89(); break;
+	case 0x8a: Op8A(); break;
+	case 0x8b: Op8B(); break;
+	case 0x8c: Opx8C(); break;
+	case 0x8d: Opx8D(); break;
+	case 0x8e: Opx8E(); break;
+	case 0x8f: Op8F(); break;
+	case 0x90: Op90(); break;
+	case 0x91: Op91(); break;
+	case 0x92: Op92(); break;
+	case 0x93: Op93(); break;
+	case 0x94: Opx94(); break;
+	case 0x95: Opx95(); break;
+	case 0x96: Opx96(); break;
+	case 0x97: Op97(); break;
+	case 0x98: Op98(); break;
+	case 0x99: Op99(); break;
+	case 0x9a: Op9A(); break;
+	case 0x9b: Op9B(); break;
+	case 0x9c: Opx9C(); break;
+	case 0x9d: Opx9D(); break;
+	case 0x9e: Opx9E(); break;
+	case 0x9f: Op9F(); break;
+	case 0xa0: OpA0(); break;
+	case 0xa1: OpA1(); break;
+	case 0xa2: OpA2(); break;
+	case 0xa3: OpA3(); break;
+	case 0xa4: OpxA4(); break;
+	case 0xa5: OpxA5(); break;
+	case 0xa6: OpxA6(); break;
+	case 0xa7: OpA7(); break;
+	case 0xa8: OpA8(); break;
+	case 0xa9: OpA9(); break;
+	case 0xaa: OpAA(); break;
+	case 0xab: OpAB(); break;
+	case 0xac: OpxAC(); break;
+	case 0xad: OpxAD(); break;
+	case 0xae: OpxAE(); break;
+	case 0xaf: OpAF(); break;
+	case 0xb0: OpB0(); break;
+	case 0xb1: OpB1(); break;
+	case 0xb2: OpB2(); break;
+	case 0xb3: OpB3(); break;
+	case 0xb4: OpxB4(); break;
+	case 0xb5: OpxB5(); break;
+	case 0xb6: OpxB6(); break;
+	case 0xb7: OpB7(); break;
+	case 0xb8: OpB8(); break;
+	case 0xb9: OpB9(); break;
+	case 0xba: OpBA(); break;
+	case 0xbb: OpBB(); break;
+	case 0xbc: OpxBC(); break;
+	case 0xbd: OpxBD(); break;
+	case 0xbe: OpxBE(); break;
+	case 0xbf: OpBF(); break;
+	case 0xc0: OpC0(); break;
+	case 0xc1: OpC1(); break;
+	case 0xc2: OpC2(); break;
+	case 0xc3: OpC3(); break;
+	case 0xc4: OpC4(); break;
+	case 0xc5: OpC5(); break;
+	case 0xc6: OpC6(); break;
+	case 0xc7: OpC7(); break;
+	case 0xc8: OpC8(); break;
+	case 0xc9: OpC9(); break;
+	case 0xca: OpCA(); break;
+	case 0xcb: OpDDCB(ix + (signed char)ReadInc(pc)); break;
+	case 0xcc: OpCC(); break;
+	case 0xcd: OpCD(); break;
+	case 0xce: OpCE(); break;
+	case 0xcf: OpCF(); break;
+	case 0xd0: OpD0(); break;
+	case 0xd1: OpD1(); break;
+	case 0xd2: OpD2(); break;
+	case 0xd3: OpD3(); break;
+	case 0xd4: OpD4(); break;
+	case 0xd5: OpD5(); break;
+	case 0xd6: OpD6(); break;
+	case 0xd7: OpD7(); break;
+	case 0xd8: OpD8(); break;
+	case 0xd9: OpD9(); break;
+	case 0xda: OpDA(); break;
+	case 0xdb: OpDB(); break;
+	case 0xdc: OpDC(); break;
+	case 0xdd: OpDD(); break;
+	case 0xde: OpDE(); break;
+	case 0xdf: OpDF(); break;
+	case 0xe0: OpE0(); break;
+	case 0xe1: OpxE1(); break;
+	case 0xe2: OpE2(); break;
+	case 0xe3: OpxE3(); break;
+	case 0xe4: OpE4(); break;
+	case 0xe5: OpxE5(); break;
+	case 0xe6: OpE6(); break;
+	case 0xe7: OpE7(); break;
+	case 0xe8: OpE8(); break;
+	case 0xe9: OpxE9(); break;
+	case 0xea: OpEA(); break;
+	case 0xeb: OpEB(); break;
+	case 0xec: OpEC(); break;
+	case 0xed: OpED(); break;
+	case 0xee: OpEE(); break;
+	case 0xef: OpEF(); break;
+	case 0xf0: OpF0(); break;
+	case 0xf1: OpF1(); break;
+	case 0xf2: OpF2(); break;
+	case 0xf3: OpF3(); break;
+	case 0xf4: OpF4(); break;
+	case 0xf5: OpF5(); break;
+	case 0xf6: OpF6(); break;
+	case 0xf7: OpF7(); break;
+	case 0xf8: OpF8(); break;
+	case 0xf9: OpxF9(); break;
+	case 0xfa: OpFA(); break;
+	case 0xfb: OpFB(); break;
+	case 0xfc: OpFC(); break;
+	case 0xfd: OpFD(); break;
+	case 0xfe: OpFE(); break;
+	case 0xff: OpFF(); break;
+	}
+}
+//=============================================================================
+//	eZ80::OpFD
+//-----------------------------------------------------------------------------
+void eZ80::OpFD()
+{
+	switch(Fetch())
+	{
+	case 0x00: Op00(); break;
+	case 0x01: Op01(); break;
+	case 0x02: Op02(); break;
+	case 0x03: Op03(); break;
+	case 0x04: Op04(); break;
+	case 0x05: Op05(); break;
+	case 0x06: Op06(); break;
+	case 0x07: Op07(); break;
+	case 0x08: Op08(); break;
+	case 0x09: Opy09(); break;
+	case 0x0a: Op0A(); break;
+	case 0x0b: Op0B(); break;
+	case 0x0c: Op0C(); break;
+	case 0x0d: Op0D(); break;
+	case 0x0e: Op0E(); break;
+	case 0x0f: Op0F(); break;
+	case 0x10: Op10(); break;
+	case 0x11: Op11(); break;
+	case 0x12: Op12(); break;
+	case 0x13: Op13(); break;
+	case 0x14: Op14(); break;
+	case 0x15: Op15(); break;
+	case 0x16: Op16(); break;
+	case 0x17: Op17(); break;
+	case 0x18: Op18(); break;
+	case 0x19: Opy19(); break;
+	case 0x1a: Op1A(); break;
+	case 0x1b: Op1B(); break;
+	case 0x1c: Op1C(); break;
+	case 0x1d: Op1D(); break;
+	case 0x1e: Op1E(); break;
+	case 0x1f: Op1F(); break;
+	case 0x20: Op20(); break;
+	case 0x21: Opy21(); break;
+	case 0x22: Opy22(); break;
+	case 0x23: Opy23(); break;
+	case 0x24: Opy24(); break;
+	case 0x25: Opy25(); break;
+	case 0x26: Opy26(); break;
+	case 0x27: Op27(); break;
+	case 0x28: Op28(); break;
+	case 0x29: Opy29(); break;
+	case 0x2a: Opy2A(); break;
+	case 0x2b: Opy2B(); break;
+	case 0x2c: Opy2C(); break;
+	case 0x2d: Opy2D(); break;
+	case 0x2e: Opy2E(); break;
+	case 0x2f: Op2F(); break;
+	case 0x30: Op30(); break;
+	case 0x31: Op31(); break;
+	case 0x32: Op32(); break;
+	case 0x33: Op33(); break;
+	case 0x34: Opy34(); break;
+	case 0x35: Opy35(); break;
+	case 0x36: Opy36(); break;
+	case 0x37: Op37(); break;
+	case 0x38: Op38(); break;
+	case 0x39: Opy39(); break;
+	case 0x3a: Op3A(); break;
+	case 0x3b: Op3B(); break;
+	case 0x3c: Op3C(); break;
+	case 0x3d: Op3D(); break;
+	case 0x3e: Op3E(); break;
+	case 0x3f: Op3F(); break;
+	case 0x40: Op40(); break;
+	case 0x41: Op41(); break;
+	case 0x42: Op42(); break;
+	case 0x43: Op43(); break;
+	case 0x44: Opy44(); break;
+	case 0x45: Opy45(); break;
+	case 0x46: Opy46(); break;
+	case 0x47: Op47(); break;
+	case 0x48: Op48(); break;
+	case 0x49: Op49(); break;
+	case 0x4a: Op4A(); break;
+	case 0x4b: Op4B(); break;
+	case 0x4c: Opy4C(); break;
+	case 0x4d: Opy4D(); break;
+	case 0x4e: Opy4E(); break;
+	case 0x4f: Op4F(); break;
+	case 0x50: Op50(); break;
+	case 0x51: Op51(); break;
+	case 0x52: Op52(); break;
+	case 0x53: Op53(); break;
+	case 0x54: Opy54(); break;
+	case 0x55: Opy55(); break;
+	case 0x56: Opy56(); break;
+	case 0x57: Op57(); break;
+	case 0x58: Op58(); break;
+	case 0x59: Op59(); break;
+	case 0x5a: Op5A(); break;
+	case 0x5b: Op5B(); break;
+	case 0x5c: Opy5C(); break;
+	case 0x5d: Opy5D(); break;
+	case 0x5e: Opy5E(); break;
+	case 0x5f: Op5F(); break;
+	case 0x60: Opy60(); break;
+	case 0x61: Opy61(); break;
+	case 0x62: Opy62(); break;
+	case 0x63: Opy63(); break;
+	case 0x64: Op64(); break;
+	case 0x65: Opy65(); break;
+	case 0x66: Opy66(); break;
+	case 0x67: Opy67(); break;
+	case 0x68: Opy68(); break;
+	case 0x69: Opy69(); break;
+	case 0x6a: Opy6A(); break;
+	case 0x6b: Opy6B(); break;
+	case 0x6c: Opy6C(); break;
+	case 0x6d: Op6D(); break;
+	case 0x6e: Opy6E(); break;
+	case 0x6f: Opy6F(); break;
+	case 0x70: Opy70(); break;
+	case 0x71: Opy71(); break;
+	case 0x72: Opy72(); break;
+	case 0x73: Opy73(); break;
+	case 0x74: Opy74(); break;
+	case 0x75: Opy75(); break;
+	case 0x76: Op76(); break;
+	case 0x77: Opy77(); break;
+	case 0x78: Op78(); break;
+	case 0x79: Op79(); break;
+	case 0x7a: Op7A(); break;
+	case 0x7b: Op7B(); break;
+	case 0x7c: Opy7C(); break;
+	case 0x7d: Opy7D(); break;
+	case 0x7e: Opy7E(); break;
+	case 0x7f: Op7F(); break;
+	case 0x80: Op80(); break;
+	case 0x81: Op81(); break;
+	case 0x82: Op82(); break;
+	case 0x83: Op83(); break;
+	case 0x84: Opy84(); break;
+	case 0x85: Opy85(); break;
+	case 0x86: Opy86(); break;
+	case 0x87: Op87(); break;
+	case 0x88: Op88(); break;
+	case 0x89: Op89(); break;
+	case 0x8a: Op8A(); break;
+	case 0x8b: Op8B(); break;
+	case 0x8c: Opy8C(); break;
+	case 0x8d: Opy8D(); break;
+	case 0x8e: Opy8E(); break;
+	case 0x8f: Op8F(); break;
+	case 0x90: Op90(); break;
+	case 0x91: Op91(); break;
+	case 0x92: Op92(); break;
+	case 0x93: Op93(); break;
+	case 0x94: Opy94(); break;
+	case 0x95: Opy95(); break;
+	case 0x96: Opy96(); break;
+	case 0x97: Op97(); break;
+	case 0x98: Op98(); break;
+	case 0x99: Op99(); break;
+	case 0x9a: Op9A(); break;
+	case 0x9b: Op9B(); break;
+	case 0x9c: Opy9C(); break;
+	case 0x9d: Opy9D(); break;
+	case 0x9e: Opy9E(); break;
+	case 0x9f: Op9F(); break;
+	case 0xa0: OpA0(); break;
+	case 0xa1: OpA1(); break;
+	case 0xa2: OpA2(); break;
+	case 0xa3: OpA3(); break;
+	case 0xa4: OpyA4(); break;
+	case 0xa5: OpyA5(); break;
+	case 0xa6: OpyA6(); break;
+	case 0xa7: OpA7(); break;
+	case 0xa8: OpA8(); break;
+	case 0xa9: OpA9(); break;
+	case 0xaa: OpAA(); break;
+	case 0xab: OpAB(); break;
+	case 0xac: OpyAC(); break;
+	case 0xad: OpyAD(); break;
+	case 0xae: OpyAE(); break;
+	case 0xaf: OpAF(); break;
+	case 0xb0: OpB0(); break;
+	case 0xb1: OpB1(); break;
+	case 0xb2: OpB2(); break;
+	case 0xb3: OpB3(); break;
+	case 0xb4: OpyB4(); break;
+	case 0xb5: OpyB5(); break;
+	case 0xb6: OpyB6(); break;
+	case 0xb7: OpB7(); break;
+	case 0xb8: OpB8(); break;
+	case 0xb9: OpB9(); break;
+	case 0xba: OpBA(); break;
+	case 0xbb: OpBB(); break;
+	case 0xbc: OpyBC(); break;
+	case 0xbd: OpyBD(); break;
+	case 0xbe: OpyBE(); break;
+	case 0xbf: OpBF(); break;
+	case 0xc0: OpC0(); break;
+	case 0xc1: OpC1(); break;
+	case 0xc2: OpC2(); break;
+	case 0xc3: OpC3(); break;
+	case 0xc4: OpC4(); break;
+	case 0xc5: OpC5(); break;
+	case 0xc6: OpC6(); break;
+	case 0xc7: OpC7(); break;
+	case 0xc8: OpC8(); break;
+	case 0xc9: OpC9(); break;
+	case 0xca: OpCA(); break;
+	case 0xcb: OpDDCB(iy + (signed char)ReadInc(pc)); break;
+	case 0xcc: OpCC(); break;
+	case 0xcd: OpCD(); break;
+	case 0xce: OpCE(); break;
+	case 0xcf: OpCF(); break;
+	case 0xd0: OpD0(); break;
+	case 0xd1: OpD1(); break;
+	case 0xd2: OpD2(); break;
+	case 0xd3: OpD3(); break;
+	case 0xd4: OpD4(); break;
+	case 0xd5: OpD5(); break;
+	case 0xd6: OpD6(); break;
+	case 0xd7: OpD7(); break;
+	case 0xd8: OpD8(); break;
+	case 0xd9: OpD9(); break;
+	case 0xda: OpDA(); break;
+	case 0xdb: OpDB(); break;
+	case 0xdc: OpDC(); break;
+	case 0xdd: OpDD(); break;
+	case 0xde: OpDE(); break;
+	case 0xdf: OpDF(); break;
+	case 0xe0: OpE0(); break;
+	case 0xe1: OpyE1(); break;
+	case 0xe2: OpE2(); break;
+	case 0xe3: OpyE3(); break;
+	case 0xe4: OpE4(); break;
+	case 0xe5: OpyE5(); break;
+	case 0xe6: OpE6(); break;
+	case 0xe7: OpE7(); break;
+	case 0xe8: OpE8(); break;
+	case 0xe9: OpyE9(); break;
+	case 0xea: OpEA(); break;
+	case 0xeb: OpEB(); break;
+	case 0xec: OpEC(); break;
+	case 0xed: OpED(); break;
+	case 0xee: OpEE(); break;
+	case 0xef: OpEF(); break;
+	case 0xf0: OpF0(); break;
+	case 0xf1: OpF1(); break;
+	case 0xf2: OpF2(); break;
+	case 0xf3: OpF3(); break;
+	case 0xf4: OpF4(); break;
+	case 0xf5: OpF5(); break;
+	case 0xf6: OpF6(); break;
+	case 0xf7: OpF7(); break;
+	case 0xf8: OpF8(); break;
+	case 0xf9: OpyF9(); break;
+	case 0xfa: OpFA(); break;
+	case 0xfb: OpFB(); break;
+	case 0xfc: OpFC(); break;
+	case 0xfd: OpFD(); break;
+	case 0xfe: OpFE(); break;
+	case 0xff: OpFF(); break;
+	}
+}
+//=============================================================================
+//	eZ80::OpED
+//-----------------------------------------------------------------------------
+void eZ80::OpED()
+{
+	switch(Fetch())
+	{
+	case 0x40: Ope40(); break;
+	case 0x41: Ope41(); break;
+	case 0x42: Ope42(); break;
+	case 0x43: Ope43(); break;
+	case 0x44: Ope44(); break;
+	case 0x45: Ope45(); break;
+	case 0x46: Ope46(); break;
+	case 0x47: Ope47(); break;
+	case 0x48: Ope48(); break;
+	case 0x49: Ope49(); break;
+	case 0x4a: Ope4A(); break;
+	case 0x4b: Ope4B(); break;
+	case 0x4c: Ope4C(); break;
+	case 0x4d: Ope4D(); break;
+	case 0x4e: Ope4E(); break;
+	case 0x4f: Ope4F(); break;
+	case 0x50: Ope50(); break;
+	case 0x51: Ope51(); break;
+	case 0x52: Ope52(); break;
+	case 0x53: Ope53(); break;
+	case 0x54: Ope54(); break;
+	case 0x55: Ope55(); break;
+	case 0x56: Ope56(); break;
+	case 0x57: Ope57(); break;
+	case 0x58: Ope58(); break;
+	case 0x59: Ope59(); break;
+	case 0x5a: Ope5A(); break;
+	case 0x5b: Ope5B(); break;
+	case 0x5c: Ope5C(); break;
+	case 0x5d: Ope5D(); break;
+	case 0x5e: Ope5E(); break;
+	case 0x5f: Ope5F(); break;
+	case 0x60: Ope60(); break;
+	case 0x61: Ope61(); break;
+	case 0x62: Ope62(); break;
+	case 0x63: Ope63(); break;
+	case 0x64: Ope64(); break;
+	case 0x65: Ope65(); break;
+	case 0x66: Ope66(); break;
+	case 0x67: Ope67(); break;
+	case 0x68: Ope68(); break;
+	case 0x69: Ope69(); break;
+	case 0x6a: Ope6A(); break;
+	case 0x6b: Ope6B(); break;
+	case 0x6c: Ope6C(); break;
+	case 0x6d: Ope6D(); break;
+	case 0x6e: Ope6E(); break;
+	case 0x6f: Ope6F(); break;
+	case 0x70: Ope70(); break;
+	case 0x71: Ope71(); break;
+	case 0x72: Ope72(); break;
+	case 0x73: Ope73(); break;
+	case 0x74: Ope74(); break;
+	case 0x75: Ope75(); break;
+	case 0x76: Ope76(); break;
+	case 0x77: Ope77(); break;
+	case 0x78: Ope78(); break;
+	case 0x79: Ope79(); break;
+	case 0x7a: Ope7A(); break;
+	case 0x7b: Ope7B(); break;
+	case 0x7c: Ope7C(); break;
+	case 0x7d: Ope7D(); break;
+	case 0x7e: Ope7E(); break;
+	case 0x7f: Ope7F(); break;
+	case 0xa0: OpeA0(); break;
+	case 0xa1: OpeA1(); break;
+	case 0xa2: OpeA2(); break;
+	case 0xa3: OpeA3(); break;
+	case 0xa8: OpeA8(); break;
+	case 0xa9: OpeA9(); break;
+	case 0xaa: OpeAA(); break;
+	case 0xab: OpeAB(); break;
+	case 0xb0: OpeB0(); break;
+	case 0xb1: OpeB1(); break;
+	case 0xb2: OpeB2(); break;
+	case 0xb3: OpeB3(); break;
+	case 0xb8: OpeB8(); break;
+	case 0xb9: OpeB9(); break;
+	case 0xba: OpeBA(); break;
+	case 0xbb: OpeBB(); break;
+	default: Op00(); break;
+	}
+}
+//=============================================================================
+//	eZ80::OpDDCB
+//-----------------------------------------------------------------------------
+void eZ80::OpDDCB(dword ptr)
+{
+	memptr = ptr;
+	// DDCBnnXX,FDCBnnXX increment R by 2, not 3!
+	byte opcode = ReadInc(pc);
+	t += 4;
+	switch(opcode)
+	{
+	case 0x00: b = Oplx00(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x01: c = Oplx00(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x02: d = Oplx00(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x03: e = Oplx00(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x04: h = Oplx00(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x05: l = Oplx00(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x06: Write(ptr, Oplx00(Read(ptr))); t += 11; break;
+	case 0x07: a = Oplx00(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x08: b = Oplx08(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x09: c = Oplx08(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x0a: d = Oplx08(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x0b: e = Oplx08(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x0c: h = Oplx08(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x0d: l = Oplx08(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x0e: Write(ptr, Oplx08(Read(ptr))); t += 11; break;
+	case 0x0f: a = Oplx08(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x10: b = Oplx10(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x11: c = Oplx10(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x12: d = Oplx10(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x13: e = Oplx10(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x14: h = Oplx10(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x15: l = Oplx10(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x16: Write(ptr, Oplx10(Read(ptr))); t += 11; break;
+	case 0x17: a = Oplx10(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x18: b = Oplx18(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x19: c = Oplx18(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x1a: d = Oplx18(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x1b: e = Oplx18(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x1c: h = Oplx18(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x1d: l = Oplx18(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x1e: Write(ptr, Oplx18(Read(ptr))); t += 11; break;
+	case 0x1f: a = Oplx18(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x20: b = Oplx20(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x21: c = Oplx20(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x22: d = Oplx20(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x23: e = Oplx20(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x24: h = Oplx20(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x25: l = Oplx20(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x26: Write(ptr, Oplx20(Read(ptr))); t += 11; break;
+	case 0x27: a = Oplx20(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x28: b = Oplx28(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x29: c = Oplx28(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x2a: d = Oplx28(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x2b: e = Oplx28(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x2c: h = Oplx28(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x2d: l = Oplx28(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x2e: Write(ptr, Oplx28(Read(ptr))); t += 11; break;
+	case 0x2f: a = Oplx28(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x30: b = Oplx30(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x31: c = Oplx30(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x32: d = Oplx30(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x33: e = Oplx30(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x34: h = Oplx30(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x35: l = Oplx30(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x36: Write(ptr, Oplx30(Read(ptr))); t += 11; break;
+	case 0x37: a = Oplx30(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x38: b = Oplx38(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x39: c = Oplx38(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x3a: d = Oplx38(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x3b: e = Oplx38(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x3c: h = Oplx38(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x3d: l = Oplx38(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x3e: Write(ptr, Oplx38(Read(ptr))); t += 11; break;
+	case 0x3f: a = Oplx38(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x40: case 0x41: case 0x42: case 0x43: case 0x44: case 0x45: case 0x46: case 0x47:
+		Oplx40(Read(ptr)); t += 8; break;
+	case 0x48: case 0x49: case 0x4a: case 0x4b: case 0x4c: case 0x4d: case 0x4e: case 0x4f:
+		Oplx48(Read(ptr)); t += 8; break;
+	case 0x50: case 0x51: case 0x52: case 0x53: case 0x54: case 0x55: case 0x56: case 0x57:
+		Oplx50(Read(ptr)); t += 8; break;
+	case 0x58: case 0x59: case 0x5a: case 0x5b: case 0x5c: case 0x5d: case 0x5e: case 0x5f:
+		Oplx58(Read(ptr)); t += 8; break;
+	case 0x60: case 0x61: case 0x62: case 0x63: case 0x64: case 0x65: case 0x66: case 0x67:
+		Oplx60(Read(ptr)); t += 8; break;
+	case 0x68: case 0x69: case 0x6a: case 0x6b: case 0x6c: case 0x6d: case 0x6e: case 0x6f:
+		Oplx68(Read(ptr)); t += 8; break;
+	case 0x70: case 0x71: case 0x72: case 0x73: case 0x74: case 0x75: case 0x76: case 0x77:
+		Oplx70(Read(ptr)); t += 8; break;
+	case 0x78: case 0x79: case 0x7a: case 0x7b: case 0x7c: case 0x7d: case 0x7e: case 0x7f:
+		Oplx78(Read(ptr)); t += 8; break;
+	case 0x80: b = Oplx80(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x81: c = Oplx80(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x82: d = Oplx80(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x83: e = Oplx80(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x84: h = Oplx80(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x85: l = Oplx80(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x86: Write(ptr, Oplx80(Read(ptr))); t += 11; break;
+	case 0x87: a = Oplx80(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x88: b = Oplx88(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x89: c = Oplx88(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x8a: d = Oplx88(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x8b: e = Oplx88(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x8c: h = Oplx88(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x8d: l = Oplx88(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x8e: Write(ptr, Oplx88(Read(ptr))); t += 11; break;
+	case 0x8f: a = Oplx88(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x90: b = Oplx90(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x91: c = Oplx90(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x92: d = Oplx90(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x93: e = Oplx90(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x94: h = Oplx90(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x95: l = Oplx90(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x96: Write(ptr, Oplx90(Read(ptr))); t += 11; break;
+	case 0x97: a = Oplx90(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0x98: b = Oplx98(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0x99: c = Oplx98(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0x9a: d = Oplx98(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0x9b: e = Oplx98(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0x9c: h = Oplx98(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0x9d: l = Oplx98(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0x9e: Write(ptr, Oplx98(Read(ptr))); t += 11; break;
+	case 0x9f: a = Oplx98(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xa0: b = OplxA0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xa1: c = OplxA0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xa2: d = OplxA0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xa3: e = OplxA0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xa4: h = OplxA0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xa5: l = OplxA0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xa6: Write(ptr, OplxA0(Read(ptr))); t += 11; break;
+	case 0xa7: a = OplxA0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xa8: b = OplxA8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xa9: c = OplxA8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xaa: d = OplxA8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xab: e = OplxA8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xac: h = OplxA8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xad: l = OplxA8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xae: Write(ptr, OplxA8(Read(ptr))); t += 11; break;
+	case 0xaf: a = OplxA8(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xb0: b = OplxB0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xb1: c = OplxB0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xb2: d = OplxB0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xb3: e = OplxB0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xb4: h = OplxB0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xb5: l = OplxB0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xb6: Write(ptr, OplxB0(Read(ptr))); t += 11; break;
+	case 0xb7: a = OplxB0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xb8: b = OplxB8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xb9: c = OplxB8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xba: d = OplxB8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xbb: e = OplxB8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xbc: h = OplxB8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xbd: l = OplxB8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xbe: Write(ptr, OplxB8(Read(ptr))); t += 11; break;
+	case 0xbf: a = OplxB8(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xc0: b = OplxC0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xc1: c = OplxC0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xc2: d = OplxC0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xc3: e = OplxC0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xc4: h = OplxC0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xc5: l = OplxC0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xc6: Write(ptr, OplxC0(Read(ptr))); t += 11; break;
+	case 0xc7: a = OplxC0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xc8: b = OplxC8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xc9: c = OplxC8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xca: d = OplxC8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xcb: e = OplxC8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xcc: h = OplxC8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xcd: l = OplxC8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xce: Write(ptr, OplxC8(Read(ptr))); t += 11; break;
+	case 0xcf: a = OplxC8(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xd0: b = OplxD0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xd1: c = OplxD0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xd2: d = OplxD0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xd3: e = OplxD0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xd4: h = OplxD0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xd5: l = OplxD0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xd6: Write(ptr, OplxD0(Read(ptr))); t += 11; break;
+	case 0xd7: a = OplxD0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xd8: b = OplxD8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xd9: c = OplxD8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xda: d = OplxD8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xdb: e = OplxD8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xdc: h = OplxD8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xdd: l = OplxD8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xde: Write(ptr, OplxD8(Read(ptr))); t += 11; break;
+	case 0xdf: a = OplxD8(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xe0: b = OplxE0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xe1: c = OplxE0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xe2: d = OplxE0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xe3: e = OplxE0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xe4: h = OplxE0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xe5: l = OplxE0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xe6: Write(ptr, OplxE0(Read(ptr))); t += 11; break;
+	case 0xe7: a = OplxE0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xe8: b = OplxE8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xe9: c = OplxE8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xea: d = OplxE8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xeb: e = OplxE8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xec: h = OplxE8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xed: l = OplxE8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xee: Write(ptr, OplxE8(Read(ptr))); t += 11; break;
+	case 0xef: a = OplxE8(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xf0: b = OplxF0(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xf1: c = OplxF0(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xf2: d = OplxF0(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xf3: e = OplxF0(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xf4: h = OplxF0(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xf5: l = OplxF0(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xf6: Write(ptr, OplxF0(Read(ptr))); t += 11; break;
+	case 0xf7: a = OplxF0(Read(ptr)); Write(ptr, a); t += 11; break;
+	case 0xf8: b = OplxF8(Read(ptr)); Write(ptr, b); t += 11; break;
+	case 0xf9: c = OplxF8(Read(ptr)); Write(ptr, c); t += 11; break;
+	case 0xfa: d = OplxF8(Read(ptr)); Write(ptr, d); t += 11; break;
+	case 0xfb: e = OplxF8(Read(ptr)); Write(ptr, e); t += 11; break;
+	case 0xfc: h = OplxF8(Read(ptr)); Write(ptr, h); t += 11; break;
+	case 0xfd: l = OplxF8(Read(ptr)); Write(ptr, l); t += 11; break;
+	case 0xfe: Write(ptr, OplxF8(Read(ptr))); t += 11; break;
+	case 0xff: a = OplxF8(Read(ptr)); Write(ptr, a); t += 11; break;
+	}
+}
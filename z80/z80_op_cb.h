@@ -841,7 +841,7 @@ void OplFF() { // set 7,a
 	set(a, 7);
 }
 
-#ifndef USE_Z80T
+#if !defined(USE_Z80T) && !defined(USE_Z80_GEN)
 inline void OpCB()
 {
 	byte opcode = Fetch();
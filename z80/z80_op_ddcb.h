@@ -130,7 +130,7 @@ temp8 OplxF8(temp8 v) { // set 7,(ix+nn)
 	return setbyte(v, 7);
 }
 
-#ifndef USE_Z80T
+#if !defined(USE_Z80T) && !defined(USE_Z80_GEN)
 inline void DDFD(byte opcode)
 {
 	byte op1; // last DD/FD prefix
@@ -169,7 +169,7 @@ inline void DDFD(byte opcode)
 	op1 == 0xDD ? (this->*ix_opcodes[opcode])() : (this->*iy_opcodes[opcode])();
 }
 #endif
-#ifndef USE_Z80T
+#if !defined(USE_Z80T) && !defined(USE_Z80_GEN)
 inline void OpDD()
 {
 	DDFD(0xDD);
@@ -460,7 +460,7 @@ void OpeBB() { // otdr
     });
 }
 
-#ifndef USE_Z80T
+#if !defined(USE_Z80T) && !defined(USE_Z80_GEN)
 void OpED()
 {
 	byte opcode = Fetch();
@@ -511,7 +511,10 @@ void Op76() { // halt
 		fetches = 0;
 	}
 	else
+	{
 		r_low += st;
+		fetches -= st; // halt fetches count when recording
+	}
 #else
 #ifndef NO_UPDATE_RLOW_IN_FETCH
 	r_low += st;
@@ -32,6 +32,14 @@ namespace xZ80
 //-----------------------------------------------------------------------------
 void eZ80::IoWrite(word port, byte v)
 {
+#ifndef NO_USE_WATCH
+	if((watch.flags & eWatch::W_PORT) && (port & watch.port_mask) == watch.port_value)
+		watch.hit |= eWatch::W_PORT;
+#endif
+#ifdef USE_Z80_TRACE
+	if(handler.trace)
+		handler.trace->Z80_Io(port, v, true, t);
+#endif
 	devices->IoWrite(port, v, t);
 }
 //=============================================================================
@@ -39,13 +47,38 @@ void eZ80::IoWrite(word port, byte v)
 //-----------------------------------------------------------------------------
 byte eZ80::IoRead(word port) const
 {
-	return handler.io ? handler.io->Z80_IoRead(port, t) : devices->IoRead(port, t);
+#ifndef NO_USE_WATCH
+	if((watch.flags & eWatch::W_PORT) && (port & watch.port_mask) == watch.port_value)
+		watch.hit |= eWatch::W_PORT;
+#endif
+#ifndef NO_USE_REPLAY
+	byte v;
+	if(handler.io)
+		v = handler.io->Z80_IoRead(port, t);
+	else
+	{
+		v = devices->IoRead(port, t);
+		if(handler.record)
+			handler.record->Z80_IoRecord(v);
+	}
+#else
+	byte v = handler.io ? handler.io->Z80_IoRead(port, t) : devices->IoRead(port, t);
+#endif
+#ifdef USE_Z80_TRACE
+	if(handler.trace)
+		handler.trace->Z80_Io(port, v, false, t);
+#endif
+	return v;
 }
 //=============================================================================
 //	eZ80::Write
 //-----------------------------------------------------------------------------
 void eZ80::Write(word addr, byte v)
 {
+#ifdef USE_Z80_TRACE
+	if(handler.trace)
+		handler.trace->Z80_Write(addr, v, t);
+#endif
 	ula->Write(t);
 	memory->Write(addr, v);
 }
@@ -356,4 +389,8 @@ void eZ80::InitOpDDCB()
 	memcpy(logic_ix_opcodes, opcodes, sizeof(opcodes));
 }
 
+#ifdef USE_Z80_GEN
+#include "z80_gen.h"
+#endif
+
 }//namespace xZ80